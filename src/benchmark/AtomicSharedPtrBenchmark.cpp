@@ -0,0 +1,244 @@
+// Read latency of atk::AtomicSharedPtr::load() while another thread keeps storing new values,
+// against the previous spinlock implementation. Also checks that readers never see a destroyed
+// value and that no value is ever destroyed on a reader thread.
+// Usage: <exe> [seconds per case] [reader threads]
+
+#include <atkaudio/AtomicSharedPtr.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+// The implementation this header replaced, kept here as the baseline
+template <typename T>
+class SpinlockSharedPtr
+{
+public:
+    explicit SpinlockSharedPtr(std::shared_ptr<T> p)
+        : ptr(std::move(p))
+    {
+    }
+
+    std::shared_ptr<T> load() const
+    {
+        lock();
+        auto result = ptr;
+        unlock();
+        return result;
+    }
+
+    void store(std::shared_ptr<T> desired)
+    {
+        lock();
+        auto old = std::move(ptr);
+        ptr = std::move(desired);
+        unlock();
+
+        if (old)
+            retained.push_back(std::move(old));
+
+        auto it = retained.begin();
+        while (it != retained.end())
+            if (it->use_count() == 1)
+                it = retained.erase(it);
+            else
+                ++it;
+    }
+
+private:
+    void lock() const
+    {
+        bool expected = false;
+        while (!spinlock.compare_exchange_weak(expected, true, std::memory_order_acquire))
+        {
+            expected = false;
+            while (spinlock.load(std::memory_order_relaxed))
+                ;
+        }
+    }
+
+    void unlock() const
+    {
+        spinlock.store(false, std::memory_order_release);
+    }
+
+    std::shared_ptr<T> ptr;
+    mutable std::atomic<bool> spinlock{false};
+    std::vector<std::shared_ptr<T>> retained;
+};
+
+constexpr uint32_t kAlive = 0xA11CE5u;
+constexpr size_t kMaxSamplesPerReader = 1u << 22;
+
+std::atomic<int> g_readerThreadDeletes{0};
+thread_local bool t_isReader = false;
+
+// Big enough that allocating and freeing it is not free
+struct Payload
+{
+    explicit Payload(uint64_t s)
+        : serial(s)
+        , data(2048, static_cast<float>(s))
+    {
+    }
+
+    ~Payload()
+    {
+        if (t_isReader)
+            g_readerThreadDeletes.fetch_add(1, std::memory_order_relaxed);
+        alive = 0;
+    }
+
+    uint32_t alive = kAlive;
+    uint64_t serial;
+    std::vector<float> data;
+};
+
+struct Result
+{
+    std::vector<uint32_t> latencies; // ns, all readers
+    uint64_t reads = 0;
+    uint64_t writes = 0;
+    int corrupt = 0;
+    int readerDeletes = 0;
+};
+
+template <typename Ptr>
+Result run(double seconds, int numReaders)
+{
+    Ptr shared(std::make_shared<Payload>(0));
+    std::atomic<bool> stop{false};
+    std::atomic<int> corrupt{0};
+    std::atomic<uint64_t> reads{0};
+    g_readerThreadDeletes.store(0);
+
+    std::vector<std::vector<uint32_t>> samples(static_cast<size_t>(numReaders));
+    std::vector<std::thread> readers;
+    for (int r = 0; r < numReaders; ++r)
+    {
+        readers.emplace_back(
+            [&, r]
+            {
+                t_isReader = true;
+                auto& mine = samples[static_cast<size_t>(r)];
+                mine.reserve(kMaxSamplesPerReader);
+                uint64_t count = 0;
+                while (!stop.load(std::memory_order_relaxed))
+                {
+                    const auto start = std::chrono::steady_clock::now();
+                    auto value = shared.load();
+                    const auto end = std::chrono::steady_clock::now();
+
+                    if (value == nullptr
+                        || value->alive != kAlive
+                        || value->data[0] != static_cast<float>(value->serial))
+                        corrupt.fetch_add(1, std::memory_order_relaxed);
+                    if (mine.size() < kMaxSamplesPerReader)
+                        mine.push_back(
+                            static_cast<uint32_t>(
+                                std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()
+                            )
+                        );
+                    ++count;
+                }
+                reads.fetch_add(count);
+            }
+        );
+    }
+
+    uint64_t writes = 0;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(seconds);
+    while (std::chrono::steady_clock::now() < deadline)
+        shared.store(std::make_shared<Payload>(++writes));
+
+    stop.store(true);
+    for (auto& reader : readers)
+        reader.join();
+
+    Result result;
+    for (auto& s : samples)
+        result.latencies.insert(result.latencies.end(), s.begin(), s.end());
+    std::sort(result.latencies.begin(), result.latencies.end());
+    result.reads = reads.load();
+    result.writes = writes;
+    result.corrupt = corrupt.load();
+    result.readerDeletes = g_readerThreadDeletes.load();
+    return result;
+}
+
+uint32_t percentile(const std::vector<uint32_t>& sorted, double p)
+{
+    if (sorted.empty())
+        return 0;
+    const auto index = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1));
+    return sorted[index];
+}
+
+void print(const char* name, const Result& r, double seconds)
+{
+    std::printf(
+        "%-10s %10.2f %10.2f %8u %8u %8u %8u %10u %10d %8d\n",
+        name,
+        static_cast<double>(r.reads) / seconds / 1.0e6,
+        static_cast<double>(r.writes) / seconds / 1.0e3,
+        percentile(r.latencies, 0.5),
+        percentile(r.latencies, 0.99),
+        percentile(r.latencies, 0.999),
+        percentile(r.latencies, 0.9999),
+        r.latencies.empty() ? 0u : r.latencies.back(),
+        r.readerDeletes,
+        r.corrupt
+    );
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const double seconds = argc > 1 ? std::max(0.1, std::atof(argv[1])) : 2.0;
+    const int numReaders = argc > 2 ? std::clamp(std::atoi(argv[2]), 1, 64) : 2;
+
+    std::printf(
+        "%d reader threads, 1 writer storing continuously, %.1f s per case, %u hardware threads\n",
+        numReaders,
+        seconds,
+        std::thread::hardware_concurrency()
+    );
+    std::printf(
+        "%-10s %10s %10s %8s %8s %8s %8s %10s %10s %8s\n",
+        "impl",
+        "Mreads/s",
+        "kwrites/s",
+        "p50 ns",
+        "p99 ns",
+        "p99.9 ns",
+        "p99.99",
+        "max ns",
+        "rt deletes",
+        "corrupt"
+    );
+
+    const auto spinlock = run<SpinlockSharedPtr<Payload>>(seconds, numReaders);
+    print("spinlock", spinlock, seconds);
+    const auto epoch = run<atk::AtomicSharedPtr<Payload>>(seconds, numReaders);
+    print("epoch", epoch, seconds);
+
+    std::printf("\nLatency is one load() including the steady_clock read; tails on an oversubscribed machine\n"
+                "are dominated by preemption.\n");
+
+    if (epoch.readerDeletes > 0 || epoch.corrupt > 0)
+    {
+        std::fprintf(stderr, "FAIL: values destroyed on a reader thread or read after destruction\n");
+        return 1;
+    }
+    return 0;
+}
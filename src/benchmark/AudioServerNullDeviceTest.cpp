@@ -0,0 +1,180 @@
+// atk::AudioServer end to end on a Null device, with no OBS and no sound card. An AudioClient plays
+// a 440 Hz sine to output 1 of a looped-back Null device and reads its input 1 every OBS tick, so
+// the sine goes through the client's output tap, the device's mix and converter, the device
+// callback, the loopback, the device's shared input and the client's input tap. The device runs at
+// another rate than the client, with its clock drifting, and in real time on its own thread.
+// Checks that once settled the client hears its own sine at the level it played it and without
+// gaps (a couple of scheduler hiccups on a loaded machine are let through), and that the device was
+// saved to the virtual device settings.
+// Usage: <exe> [seconds]. Exits non-zero on failure.
+
+#include <atkaudio/atkaudio.h>
+#include <atkaudio/Logging.h>
+#include <atkaudio/ModuleInfrastructure/AudioServer/AudioServer.h>
+#include <atkaudio/ModuleInfrastructure/AudioServer/VirtualAudioDevices.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <numbers>
+#include <thread>
+#include <vector>
+
+// The plugin keeps its settings under the OBS config dir and logs through OBS; here the settings go
+// to a directory of the test's own and the log to the console
+juce::File atk::getSettingsFile(const juce::String& name)
+{
+    return juce::File::getSpecialLocation(juce::File::tempDirectory)
+        .getChildFile("atkaudio_null_device_test")
+        .getChildFile(name + ".settings");
+}
+
+void atk::logging::log(Level level, const char* scope, const juce::String& message)
+{
+    if (level != Level::debug)
+        std::printf("[%s] %s\n", scope, message.toRawUTF8());
+}
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+constexpr const char* kDeviceName = "Test Null Device";
+constexpr double kClientRate = 48000.0;
+constexpr int kClientBlock = 480;
+constexpr double kAmplitude = 0.1;
+// Sample to sample change of the sine is ~0.006; a gap or a repeated block jumps much further
+constexpr double kMaxStep = 0.02;
+constexpr int kMaxGaps = 2;
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const double seconds = argc > 1 ? std::max(2.0, std::atof(argv[1])) : 5.0;
+
+    // This thread is the message thread: AudioServer's timer and the device managers want one
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    atk::getSettingsFile("").getParentDirectory().deleteRecursively();
+
+    atk::VirtualDeviceConfig config;
+    config.sampleRate = 44100.0;
+    config.blockSize = 512;
+    config.numInputChannels = 2;
+    config.numOutputChannels = 2;
+    config.driftPpm = 80.0;
+    config.loopback = true;
+    atk::VirtualAudioDevices::getInstance()->setDevice(atk::VirtualAudioDevices::NULL_TYPE_NAME, kDeviceName, config);
+
+    auto* server = atk::AudioServer::getInstance();
+    server->initialize();
+
+    int numTicks = 0;
+    int numGaps = 0;
+    double sumSquares = 0.0;
+    int64_t numMeasured = 0;
+    bool deviceOpened = false;
+    {
+        atk::AudioClient client;
+        atk::AudioClientState state;
+        state.inputSubscriptions.push_back({kDeviceName, atk::VirtualAudioDevices::NULL_TYPE_NAME, 0, true});
+        state.outputSubscriptions.push_back({kDeviceName, atk::VirtualAudioDevices::NULL_TYPE_NAME, 0, false});
+        client.setSubscriptions(state);
+        deviceOpened = server->getOpenDeviceNames().contains(kDeviceName);
+
+        std::vector<float> played(kClientBlock);
+        std::vector<float> heard(kClientBlock);
+        const float* playedPointer = played.data();
+        float* heardPointer = heard.data();
+
+        const auto toDuration = [](double s)
+        { return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(s)); };
+        const auto period = toDuration(kClientBlock / kClientRate);
+        const auto start = Clock::now();
+        const auto settled = start + toDuration(seconds * 0.5);
+        const auto end = start + toDuration(seconds);
+        auto next = start;
+        double phase = 0.0;
+        float previous = 0.0f;
+        bool havePrevious = false;
+
+        while (next < end)
+        {
+            std::this_thread::sleep_until(next);
+            next += period;
+
+            for (auto& sample : played)
+            {
+                sample = static_cast<float>(kAmplitude * std::sin(phase));
+                phase += 2.0 * std::numbers::pi * 440.0 / kClientRate;
+            }
+            client.pushSubscribedOutputs(&playedPointer, 1, kClientBlock, kClientRate);
+            std::fill(heard.begin(), heard.end(), 0.0f);
+            client.pullSubscribedInputs(&heardPointer, 1, kClientBlock, kClientRate);
+
+            // Skip the settling time
+            if (Clock::now() < settled)
+                continue;
+
+            ++numTicks;
+            bool gap = false;
+            double blockSquares = 0.0;
+            for (float sample : heard)
+            {
+                if (havePrevious && std::abs(sample - previous) > kMaxStep)
+                    gap = true;
+                blockSquares += static_cast<double>(sample) * sample;
+                previous = sample;
+                havePrevious = true;
+            }
+            // Silence moves smoothly from sample to sample too
+            if (std::sqrt(blockSquares / kClientBlock) < 0.5 * kAmplitude / std::numbers::sqrt2)
+                gap = true;
+            if (gap)
+                ++numGaps;
+
+            sumSquares += blockSquares;
+            numMeasured += kClientBlock;
+        }
+    }
+
+    server->shutdown();
+
+    const auto settings = juce::XmlDocument::parse(atk::getSettingsFile("atkAudio Virtual Devices"));
+    bool saved = false;
+    if (settings != nullptr)
+        for (auto* element : settings->getChildWithTagNameIterator("DEVICE"))
+            saved = saved || element->getStringAttribute("name") == kDeviceName;
+
+    const double rms = numMeasured > 0 ? std::sqrt(sumSquares / static_cast<double>(numMeasured)) : 0.0;
+    const double ratio = rms / (kAmplitude / std::numbers::sqrt2);
+    std::printf(
+        "Null device at %.0f Hz / %d (%+.0f ppm), client at %.0f Hz / %d, %.0f s\n",
+        config.sampleRate,
+        config.blockSize,
+        config.driftPpm,
+        kClientRate,
+        kClientBlock,
+        seconds
+    );
+    std::printf(
+        "device opened: %s, saved: %s, %d ticks checked: %d with a gap, level ratio %.4f\n",
+        deviceOpened ? "yes" : "no",
+        saved ? "yes" : "no",
+        numTicks,
+        numGaps,
+        ratio
+    );
+
+    const bool passed =
+        deviceOpened && saved && numTicks > 0 && numGaps <= kMaxGaps && std::abs(ratio - 1.0) <= 0.05;
+    if (!passed)
+    {
+        std::fprintf(stderr, "FAIL: the client did not hear its own output back through the Null device\n");
+        return 1;
+    }
+    return 0;
+}
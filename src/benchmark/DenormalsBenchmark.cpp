@@ -0,0 +1,146 @@
+// Cost of denormals with and without atk::ScopedFlushDenormals. A bank of biquad low-pass filters
+// starts from a small state that decays into the denormal range, and denormal input keeps it
+// there, as a filter's tail does after its input goes quiet; the same bank on silence is the
+// baseline. Checks that:
+//   - the guard turns flush-to-zero on for the calling thread and restores the previous state,
+//   - with the guard, the denormal run is at most maxRatio times slower than silence.
+// The unguarded run is only reported: how much denormals cost depends on the CPU.
+// Usage: <exe> [maxRatio] [repetitions]. Exits non-zero on failure.
+
+#include <atkaudio/Denormals.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+
+constexpr int kChannels = 8;
+constexpr int kBlockSize = 512;
+constexpr int kBlocks = 400;
+
+struct Biquad
+{
+    // Low-pass at about 1 kHz, 48 kHz
+    float b0 = 0.0039160f, b1 = 0.0078320f, b2 = 0.0039160f;
+    float a1 = -1.8153396f, a2 = 0.8310036f;
+    float z1 = 0.0f, z2 = 0.0f;
+
+    void process(float* samples, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float in = samples[i];
+            const float out = b0 * in + z1;
+            z1 = b1 * in - a1 * out + z2;
+            z2 = b2 * in - a2 * out;
+            samples[i] = out;
+        }
+    }
+};
+
+volatile float g_sink = 0.0f;
+
+// Seconds for kBlocks blocks through kChannels filters; the block is refilled with input each time
+double runFilters(float input, float initialState)
+{
+    std::vector<Biquad> filters(kChannels);
+    for (auto& filter : filters)
+        filter.z1 = filter.z2 = initialState;
+
+    std::vector<float> block(static_cast<size_t>(kBlockSize));
+    float sum = 0.0f;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int b = 0; b < kBlocks; ++b)
+    {
+        for (auto& filter : filters)
+        {
+            std::fill(block.begin(), block.end(), input);
+            filter.process(block.data(), kBlockSize);
+            sum += block.back();
+        }
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    g_sink = sum;
+    return std::chrono::duration<double>(end - start).count();
+}
+
+// Fastest of several runs; the least disturbed by the rest of the machine
+template <typename Run>
+double bestOf(int repetitions, Run run)
+{
+    double best = 1.0e9;
+    for (int i = 0; i < repetitions; ++i)
+        best = std::min(best, run());
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const double maxRatio = argc > 1 ? std::atof(argv[1]) : 2.0;
+    const int repetitions = argc > 2 ? std::max(1, std::atoi(argv[2])) : 5;
+
+    // Well inside the denormal range (below ~1.18e-38); the state starts just above it
+    const float denormal = 1.0e-40f;
+    const float tail = 1.0e-30f;
+
+    atk::denormals::setFlushToZeroEnabled(true);
+
+    const bool activeBefore = atk::denormals::isFlushToZeroActiveOnThisThread();
+    bool activeInside = false;
+    {
+        atk::ScopedFlushDenormals noDenormals;
+        activeInside = atk::denormals::isFlushToZeroActiveOnThisThread();
+    }
+    const bool activeAfter = atk::denormals::isFlushToZeroActiveOnThisThread();
+
+    if (!activeInside)
+    {
+        std::printf("flush-to-zero is not supported on this platform; nothing to measure\n");
+        return 0;
+    }
+
+    int failures = 0;
+    if (activeAfter != activeBefore)
+    {
+        std::printf("FAILED: the guard did not restore the thread's floating point state\n");
+        ++failures;
+    }
+
+    const double silence = bestOf(repetitions, [] { return runFilters(0.0f, 0.0f); });
+    const double unguarded = bestOf(repetitions, [&] { return runFilters(denormal, tail); });
+    const double guarded = bestOf(
+        repetitions,
+        [&]
+        {
+            atk::ScopedFlushDenormals noDenormals;
+            return runFilters(denormal, tail);
+        }
+    );
+
+    const double guardedRatio = guarded / silence;
+    const bool passed = guardedRatio <= maxRatio;
+    if (!passed)
+        ++failures;
+
+    std::printf("%-12s %10s %8s\n", "case", "ms", "ratio");
+    std::printf("%-12s %10.3f %8.2f\n", "silence", silence * 1000.0, 1.0);
+    std::printf("%-12s %10.3f %8.2f\n", "unguarded", unguarded * 1000.0, unguarded / silence);
+    std::printf(
+        "%-12s %10.3f %8.2f  %s (max %.2f)\n",
+        "guarded",
+        guarded * 1000.0,
+        guardedRatio,
+        passed ? "OK" : "FAILED",
+        maxRatio
+    );
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,584 @@
+// Device output callback time against the number of AudioServer clients, for the previous layout
+// (one SyncBuffer per client, each resampled and summed in the device callback) and for
+// atk::SharedDeviceOutput (clients mixed at their own rate, one resample per device).
+// Clients and device run in simulated time on one thread, with the device clock drifting; only the
+// wall time of each call is measured. Client-side time per OBS tick is reported as well, since
+// mixing moves the summing there.
+// The inputs mode checks atk::SharedDeviceInput instead: its readers run on their own threads and
+// read each OBS tick at the same moment, racing for the converter, and every one of them must get
+// the same block each tick, with no gaps once the converter has settled, also while another
+// client subscribes to a second channel and leaves it again.
+// The outputs mode checks that a client keeps playing without a gap while another starts playing
+// to a higher device channel and stops again, and that channels past the span stay untouched.
+// Usage: <exe> [simulated seconds per case] [max clients]
+//        <exe> inputs [simulated seconds] [readers]
+//        <exe> outputs [simulated seconds]
+// Exits non-zero on failure.
+
+#include <atkaudio/ModuleInfrastructure/AudioServer/SharedDeviceStreams.h>
+
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <numbers>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+using WallClock = std::chrono::steady_clock;
+
+constexpr double kClientRate = 48000.0;
+constexpr int kClientBlock = 480;
+constexpr double kDeviceRate = 44100.0;
+constexpr int kDeviceBlock = 512;
+constexpr double kDeviceDriftPpm = 80.0;
+constexpr int kDeviceChannels = 8;
+constexpr int kClientChannels = 2; // every client plays to device channels 0 and 1
+
+double g_now = 0.0;
+
+double simulatedClock(void*)
+{
+    return g_now;
+}
+
+// The converter reads the clock while it holds the converter lock. Stalling it there on the reader
+// threads stands in for a long conversion, or a reader preempted mid-conversion, so that the other
+// readers find the converter busy even on a single core.
+thread_local bool t_stallClock = false;
+
+double stallingClock(void*)
+{
+    if (t_stallClock)
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    return g_now;
+}
+
+double microsecondsBetween(WallClock::time_point start, WallClock::time_point end)
+{
+    return std::chrono::duration<double, std::micro>(end - start).count();
+}
+
+struct Timings
+{
+    std::vector<double> callback; // us per device callback
+    double clientPerTick = 0.0;   // us per OBS tick, all clients
+    double outputRms = 0.0;
+};
+
+double percentile(std::vector<double> values, double p)
+{
+    if (values.empty())
+        return 0.0;
+    std::sort(values.begin(), values.end());
+    return values[static_cast<size_t>(p * static_cast<double>(values.size() - 1))];
+}
+
+double mean(const std::vector<double>& values)
+{
+    double sum = 0.0;
+    for (double v : values)
+        sum += v;
+    return values.empty() ? 0.0 : sum / static_cast<double>(values.size());
+}
+
+// Previous layout: each client owns a SyncBuffer the device callback reads and sums
+struct PerClientBuffers
+{
+    explicit PerClientBuffers(int numClients)
+        : deviceTemp(kDeviceChannels, std::vector<float>(kDeviceBlock))
+        , devicePointers(kDeviceChannels)
+    {
+        for (int i = 0; i < numClients; ++i)
+        {
+            buffers.push_back(std::make_unique<SyncBuffer>());
+            buffers.back()->setClock(&simulatedClock, nullptr);
+        }
+        for (int ch = 0; ch < kDeviceChannels; ++ch)
+            devicePointers[static_cast<size_t>(ch)] = deviceTemp[static_cast<size_t>(ch)].data();
+    }
+
+    void clientWrite(int client, const float* const* src)
+    {
+        buffers[static_cast<size_t>(client)]->write(src, kClientChannels, kClientBlock, kClientRate);
+    }
+
+    void deviceCallback(float* const* out, double deviceRate)
+    {
+        for (auto& buffer : buffers)
+            if (buffer->read(devicePointers.data(), kClientChannels, kDeviceBlock, deviceRate, false))
+                for (int ch = 0; ch < kClientChannels; ++ch)
+                    for (int i = 0; i < kDeviceBlock; ++i)
+                        out[ch][i] += devicePointers[static_cast<size_t>(ch)][i];
+    }
+
+    std::vector<std::unique_ptr<SyncBuffer>> buffers;
+    std::vector<std::vector<float>> deviceTemp;
+    std::vector<float*> devicePointers;
+};
+
+// New layout: clients add into one mix, the device callback reads one converter
+struct SharedMix
+{
+    explicit SharedMix(int numClients)
+        : output(std::make_shared<atk::SharedDeviceOutput>(kDeviceChannels))
+    {
+        output->setClock(&simulatedClock, nullptr);
+        output->setNumChannels(kClientChannels);
+        for (int i = 0; i < numClients; ++i)
+        {
+            taps.push_back(std::make_unique<atk::DeviceOutputTap>());
+            taps.back()->bind(output);
+        }
+    }
+
+    void clientWrite(int client, const float* const* src)
+    {
+        taps[static_cast<size_t>(client)]->write(src, kClientChannels, kClientBlock, kClientRate);
+    }
+
+    void deviceCallback(float* const* out, double deviceRate)
+    {
+        output->readToDevice(out, kDeviceChannels, kDeviceBlock, deviceRate);
+    }
+
+    std::shared_ptr<atk::SharedDeviceOutput> output;
+    std::vector<std::unique_ptr<atk::DeviceOutputTap>> taps;
+};
+
+template <typename Layout>
+Timings run(int numClients, double seconds)
+{
+    g_now = 0.0;
+    Layout layout(numClients);
+
+    std::vector<std::vector<float>> clientAudio(kClientChannels, std::vector<float>(kClientBlock));
+    std::vector<const float*> clientPointers(kClientChannels);
+    std::vector<std::vector<float>> deviceOut(kDeviceChannels, std::vector<float>(kDeviceBlock));
+    std::vector<float*> devicePointers(kDeviceChannels);
+    for (int ch = 0; ch < kClientChannels; ++ch)
+        clientPointers[static_cast<size_t>(ch)] = clientAudio[static_cast<size_t>(ch)].data();
+    for (int ch = 0; ch < kDeviceChannels; ++ch)
+        devicePointers[static_cast<size_t>(ch)] = deviceOut[static_cast<size_t>(ch)].data();
+
+    const double clientPeriod = kClientBlock / kClientRate;
+    const double deviceRate = kDeviceRate * (1.0 + kDeviceDriftPpm * 1.0e-6);
+    const double devicePeriod = kDeviceBlock / deviceRate;
+    // The device starts a little after the clients so the first reads find audio
+    double nextClient = 0.0;
+    double nextDevice = 0.05;
+    double phase = 0.0;
+
+    Timings timings;
+    double clientTime = 0.0;
+    int numTicks = 0;
+    double sumSquares = 0.0;
+    int64_t numMeasured = 0;
+
+    while (nextClient < seconds || nextDevice < seconds)
+    {
+        if (nextClient <= nextDevice)
+        {
+            g_now = nextClient;
+            for (int i = 0; i < kClientBlock; ++i)
+            {
+                const auto sample = static_cast<float>(0.1 * std::sin(phase));
+                phase += 2.0 * std::numbers::pi * 440.0 / kClientRate;
+                for (auto& channel : clientAudio)
+                    channel[static_cast<size_t>(i)] = sample;
+            }
+
+            const auto start = WallClock::now();
+            for (int client = 0; client < numClients; ++client)
+                layout.clientWrite(client, clientPointers.data());
+            clientTime += microsecondsBetween(start, WallClock::now());
+            ++numTicks;
+            nextClient += clientPeriod;
+        }
+        else
+        {
+            g_now = nextDevice;
+            for (auto& channel : deviceOut)
+                std::fill(channel.begin(), channel.end(), 0.0f);
+
+            const auto start = WallClock::now();
+            layout.deviceCallback(devicePointers.data(), deviceRate);
+            timings.callback.push_back(microsecondsBetween(start, WallClock::now()));
+
+            // Skip the settling time
+            if (nextDevice > seconds * 0.5)
+            {
+                for (float sample : deviceOut[0])
+                    sumSquares += static_cast<double>(sample) * sample;
+                numMeasured += kDeviceBlock;
+            }
+            nextDevice += devicePeriod;
+        }
+    }
+
+    timings.clientPerTick = numTicks > 0 ? clientTime / numTicks : 0.0;
+    timings.outputRms = numMeasured > 0 ? std::sqrt(sumSquares / static_cast<double>(numMeasured)) : 0.0;
+    return timings;
+}
+
+// The device plays a 440 Hz sine on channel 0; the readers of one SharedDeviceInput each read it
+// on a thread of their own, all released at once every OBS tick, while the device keeps its own
+// drifting clock on the main thread
+bool checkInputReaders(int numReaders, double seconds)
+{
+    g_now = 0.0;
+    auto input = std::make_shared<atk::SharedDeviceInput>(kDeviceChannels);
+    input->setClock(&stallingClock, nullptr);
+    input->setChannels({0});
+
+    std::vector<std::unique_ptr<atk::DeviceInputTap>> taps;
+    for (int i = 0; i < numReaders; ++i)
+    {
+        taps.push_back(std::make_unique<atk::DeviceInputTap>());
+        taps.back()->bind(input, {0});
+    }
+
+    std::vector<std::vector<float>> blocks(static_cast<size_t>(numReaders), std::vector<float>(kClientBlock));
+    std::barrier tickStart(numReaders + 1);
+    std::barrier tickEnd(numReaders + 1);
+    std::atomic<bool> running{true};
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < numReaders; ++r)
+    {
+        readers.emplace_back(
+            [&, r]
+            {
+                t_stallClock = true;
+                float* dest = blocks[static_cast<size_t>(r)].data();
+                for (;;)
+                {
+                    tickStart.arrive_and_wait();
+                    if (!running.load())
+                        return;
+                    taps[static_cast<size_t>(r)]->read(&dest, 1, kClientBlock, kClientRate);
+                    tickEnd.arrive_and_wait();
+                }
+            }
+        );
+    }
+
+    std::vector<std::vector<float>> deviceIn(kDeviceChannels, std::vector<float>(kDeviceBlock));
+    std::vector<const float*> devicePointers(kDeviceChannels);
+    for (int ch = 0; ch < kDeviceChannels; ++ch)
+        devicePointers[static_cast<size_t>(ch)] = deviceIn[static_cast<size_t>(ch)].data();
+
+    const double clientPeriod = kClientBlock / kClientRate;
+    const double devicePeriod = kDeviceBlock / (kDeviceRate * (1.0 + kDeviceDriftPpm * 1.0e-6));
+    // Sample to sample change of the sine is ~0.006; a gap or a repeated block jumps much further
+    const double amplitude = 0.1;
+    const double maxStep = 0.02;
+    double nextClient = 0.05;
+    double nextDevice = 0.0;
+    double phase = 0.0;
+
+    int numTicks = 0;
+    int numMismatched = 0;
+    int numGaps = 0;
+    std::vector<float> previous(static_cast<size_t>(numReaders), 0.0f);
+    bool havePrevious = false;
+
+    while (nextClient < seconds)
+    {
+        if (nextDevice <= nextClient)
+        {
+            g_now = nextDevice;
+            for (int i = 0; i < kDeviceBlock; ++i)
+            {
+                deviceIn[0][static_cast<size_t>(i)] = static_cast<float>(amplitude * std::sin(phase));
+                phase += 2.0 * std::numbers::pi * 440.0 / kDeviceRate;
+            }
+            input->writeFromDevice(devicePointers.data(), kDeviceChannels, kDeviceBlock, kDeviceRate);
+            nextDevice += devicePeriod;
+            continue;
+        }
+
+        // Another client comes and goes on channel 1; the readers of channel 0 must not hear it
+        if (nextClient >= seconds * 0.7 && nextClient < seconds * 0.7 + clientPeriod)
+            input->setChannels({0, 1});
+        else if (nextClient >= seconds * 0.85 && nextClient < seconds * 0.85 + clientPeriod)
+            input->setChannels({0});
+
+        g_now = nextClient;
+        tickStart.arrive_and_wait();
+        tickEnd.arrive_and_wait();
+        nextClient += clientPeriod;
+
+        // Skip the settling time
+        if (g_now < seconds * 0.5)
+            continue;
+
+        ++numTicks;
+        const auto& first = blocks[0];
+        for (size_t r = 1; r < blocks.size(); ++r)
+            if (std::memcmp(blocks[r].data(), first.data(), first.size() * sizeof(float)) != 0)
+            {
+                ++numMismatched;
+                break;
+            }
+
+        bool gap = false;
+        for (size_t r = 0; r < blocks.size(); ++r)
+        {
+            float last = previous[r];
+            for (size_t i = 0; i < blocks[r].size(); ++i)
+            {
+                if ((havePrevious || i > 0) && std::abs(blocks[r][i] - last) > maxStep)
+                    gap = true;
+                last = blocks[r][i];
+            }
+            previous[r] = last;
+        }
+        havePrevious = true;
+        if (gap)
+            ++numGaps;
+    }
+
+    running.store(false);
+    tickStart.arrive_and_wait();
+    for (auto& reader : readers)
+        reader.join();
+
+    std::printf(
+        "%d readers, %d ticks checked: %d with readers disagreeing, %d with a gap\n",
+        numReaders,
+        numTicks,
+        numMismatched,
+        numGaps
+    );
+    return numTicks > 0 && numMismatched == 0 && numGaps == 0;
+}
+
+// One client plays a 440 Hz sine to device channel 0. Part way through, a second client starts
+// playing to channel 3, which widens the span, and later leaves again.
+bool checkOutputSpan(double seconds)
+{
+    constexpr int kSecondChannel = 3;
+    constexpr float kUntouched = 0.5f; // what the device buffer holds past the span
+
+    g_now = 0.0;
+    auto output = std::make_shared<atk::SharedDeviceOutput>(kDeviceChannels);
+    output->setClock(&simulatedClock, nullptr);
+    output->setNumChannels(1);
+
+    atk::DeviceOutputTap first;
+    atk::DeviceOutputTap second;
+    first.bind(output);
+
+    std::vector<std::vector<float>> clientAudio(kSecondChannel + 1, std::vector<float>(kClientBlock));
+    std::vector<const float*> firstPointers{clientAudio[0].data()};
+    std::vector<const float*> secondPointers(kSecondChannel + 1, nullptr);
+    secondPointers[kSecondChannel] = clientAudio[kSecondChannel].data();
+
+    std::vector<std::vector<float>> deviceOut(kDeviceChannels, std::vector<float>(kDeviceBlock));
+    std::vector<float*> devicePointers(kDeviceChannels);
+    for (int ch = 0; ch < kDeviceChannels; ++ch)
+        devicePointers[static_cast<size_t>(ch)] = deviceOut[static_cast<size_t>(ch)].data();
+
+    const double clientPeriod = kClientBlock / kClientRate;
+    const double deviceRate = kDeviceRate * (1.0 + kDeviceDriftPpm * 1.0e-6);
+    const double devicePeriod = kDeviceBlock / deviceRate;
+    // Sample to sample change of the sine is ~0.006; a gap or a restart jumps much further
+    const double amplitude = 0.1;
+    const double maxStep = 0.02;
+    double nextClient = 0.0;
+    double nextDevice = 0.05;
+    double phase = 0.0;
+    bool secondPlaying = false;
+
+    int numBlocks = 0;
+    int numGaps = 0;
+    int numTouched = 0;
+    float previous = 0.0f;
+    bool havePrevious = false;
+
+    while (nextDevice < seconds)
+    {
+        if (nextClient <= nextDevice)
+        {
+            g_now = nextClient;
+            const bool playSecond = nextClient >= seconds * 0.7 && nextClient < seconds * 0.85;
+            if (playSecond != secondPlaying)
+            {
+                // As AudioServer does when a client's output mapping changes
+                output->setNumChannels(playSecond ? kSecondChannel + 1 : 1);
+                second.bind(playSecond ? output : nullptr);
+                secondPlaying = playSecond;
+            }
+
+            for (int i = 0; i < kClientBlock; ++i)
+            {
+                const auto sample = static_cast<float>(amplitude * std::sin(phase));
+                phase += 2.0 * std::numbers::pi * 440.0 / kClientRate;
+                clientAudio[0][static_cast<size_t>(i)] = sample;
+                clientAudio[kSecondChannel][static_cast<size_t>(i)] = sample;
+            }
+
+            first.write(firstPointers.data(), 1, kClientBlock, kClientRate);
+            if (secondPlaying)
+                second.write(secondPointers.data(), kSecondChannel + 1, kClientBlock, kClientRate);
+            nextClient += clientPeriod;
+            continue;
+        }
+
+        g_now = nextDevice;
+        for (auto& channel : deviceOut)
+            std::fill(channel.begin(), channel.end(), 0.0f);
+        const int span = secondPlaying ? kSecondChannel + 1 : 1;
+        for (auto channel = deviceOut.begin() + span; channel != deviceOut.end(); ++channel)
+            std::fill(channel->begin(), channel->end(), kUntouched);
+
+        output->readToDevice(devicePointers.data(), kDeviceChannels, kDeviceBlock, deviceRate);
+        nextDevice += devicePeriod;
+
+        // Skip the settling time
+        if (g_now < seconds * 0.5)
+            continue;
+
+        ++numBlocks;
+        const bool touched = std::any_of(
+            deviceOut.begin() + span,
+            deviceOut.end(),
+            [&](const std::vector<float>& channel)
+            { return std::any_of(channel.begin(), channel.end(), [&](float sample) { return sample != kUntouched; }); }
+        );
+        if (touched)
+            ++numTouched;
+
+        bool gap = false;
+        double sumSquares = 0.0;
+        for (float sample : deviceOut[0])
+        {
+            if (havePrevious && std::abs(sample - previous) > maxStep)
+                gap = true;
+            sumSquares += static_cast<double>(sample) * sample;
+            previous = sample;
+            havePrevious = true;
+        }
+        // Silence moves smoothly from sample to sample too
+        if (std::sqrt(sumSquares / kDeviceBlock) < 0.5 * amplitude)
+            gap = true;
+        if (gap)
+            ++numGaps;
+    }
+
+    first.bind(nullptr);
+    second.bind(nullptr);
+
+    std::printf(
+        "%d device blocks checked: %d with a gap on channel 0, %d touching channels past the span\n",
+        numBlocks,
+        numGaps,
+        numTouched
+    );
+    return numBlocks > 0 && numGaps == 0 && numTouched == 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc > 1 && std::strcmp(argv[1], "outputs") == 0)
+    {
+        const double seconds = argc > 2 ? std::max(1.0, std::atof(argv[2])) : 20.0;
+        if (!checkOutputSpan(seconds))
+        {
+            std::fprintf(stderr, "FAIL: a change of output span interrupted the device output\n");
+            return 1;
+        }
+        return 0;
+    }
+
+    if (argc > 1 && std::strcmp(argv[1], "inputs") == 0)
+    {
+        const double seconds = argc > 2 ? std::max(1.0, std::atof(argv[2])) : 20.0;
+        const int numReaders = argc > 3 ? std::clamp(std::atoi(argv[3]), 2, 64) : 4;
+        if (!checkInputReaders(numReaders, seconds))
+        {
+            std::fprintf(stderr, "FAIL: concurrent readers of a shared input did not get the same gap-free audio\n");
+            return 1;
+        }
+        return 0;
+    }
+
+    const double seconds = argc > 1 ? std::max(1.0, std::atof(argv[1])) : 20.0;
+    const int maxClients = argc > 2 ? std::clamp(std::atoi(argv[2]), 1, 256) : 32;
+
+    std::printf(
+        "1 to %d clients at %.0f Hz / %d, device at %.0f Hz / %d (%+.0f ppm), %.0f s simulated per case\n",
+        maxClients,
+        kClientRate,
+        kClientBlock,
+        kDeviceRate,
+        kDeviceBlock,
+        kDeviceDriftPpm,
+        seconds
+    );
+    std::printf(
+        "%8s | %-31s | %-31s | %s\n",
+        "",
+        "device callback us (per-client)",
+        "device callback us (shared mix)",
+        "client us per tick (per-client / shared)"
+    );
+    std::printf(
+        "%8s | %9s %9s %9s | %9s %9s %9s | %9s %9s | %s\n",
+        "clients",
+        "mean",
+        "p99",
+        "max",
+        "mean",
+        "p99",
+        "max",
+        "",
+        "",
+        "rms ratio"
+    );
+
+    bool ok = true;
+    for (int numClients = 1; numClients <= maxClients; numClients *= 2)
+    {
+        const auto perClient = run<PerClientBuffers>(numClients, seconds);
+        const auto shared = run<SharedMix>(numClients, seconds);
+        const double ratio = perClient.outputRms > 0.0 ? shared.outputRms / perClient.outputRms : 0.0;
+
+        std::printf(
+            "%8d | %9.2f %9.2f %9.2f | %9.2f %9.2f %9.2f | %9.2f %9.2f | %.4f\n",
+            numClients,
+            mean(perClient.callback),
+            percentile(perClient.callback, 0.99),
+            percentile(perClient.callback, 1.0),
+            mean(shared.callback),
+            percentile(shared.callback, 0.99),
+            percentile(shared.callback, 1.0),
+            perClient.clientPerTick,
+            shared.clientPerTick,
+            ratio
+        );
+
+        // Both layouts play every client once; the mix must not lose or double any of them
+        if (std::abs(ratio - 1.0) > 0.01)
+            ok = false;
+    }
+
+    std::printf("\nrms ratio is shared-mix over per-client output level and should be 1.\n");
+    if (!ok)
+    {
+        std::fprintf(stderr, "FAIL: shared mix level differs from the per-client sum\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,154 @@
+// SPSC stress test for FifoBuffer2: one writer and one reader thread, random block sizes, a small
+// FIFO so it constantly runs full and empty. Every sample must arrive exactly once and in order.
+// Usage: <exe> [seconds] [channels]. Exits non-zero on the first discontinuity.
+
+#include <atkaudio/FifoBuffer2.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+// Exact in float; channels are offset so a channel mix-up is detected too
+float sampleValue(uint64_t index, int channel)
+{
+    return static_cast<float>((index + static_cast<uint64_t>(channel) * 1000003u) & 0x7FFFFFu);
+}
+
+constexpr int kMaxBlock = 700;
+constexpr int kFifoSize = 2048;
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const double seconds = argc > 1 ? std::max(0.1, std::atof(argv[1])) : 2.0;
+    const int numChannels = argc > 2 ? std::clamp(std::atoi(argv[2]), 1, 64) : 8;
+
+    FifoBuffer2 fifo;
+    fifo.setSize(numChannels, kFifoSize);
+
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> totalWritten{0};
+
+    std::thread writer(
+        [&]
+        {
+            std::mt19937 rng(1);
+            std::uniform_int_distribution<int> blockDist(1, kMaxBlock);
+            std::vector<std::vector<float>> block(numChannels, std::vector<float>(kMaxBlock));
+            std::vector<const float*> ptrs(numChannels);
+            uint64_t next = 0;
+
+            while (!stop.load(std::memory_order_relaxed))
+            {
+                const int n = blockDist(rng);
+                for (int ch = 0; ch < numChannels; ++ch)
+                    for (int i = 0; i < n; ++i)
+                        block[ch][i] = sampleValue(next + i, ch);
+
+                // A full FIFO is back-pressure, not loss: keep offering the rest of the block
+                int done = 0;
+                while (done < n && !stop.load(std::memory_order_relaxed))
+                {
+                    for (int ch = 0; ch < numChannels; ++ch)
+                        ptrs[ch] = block[ch].data() + done;
+                    const int written = fifo.write(ptrs.data(), numChannels, n - done);
+                    done += written;
+                    if (written == 0)
+                        std::this_thread::yield();
+                }
+
+                next += done;
+                totalWritten.store(next, std::memory_order_relaxed);
+            }
+        }
+    );
+
+    std::mt19937 rng(2);
+    std::uniform_int_distribution<int> blockDist(1, kMaxBlock);
+    std::uniform_int_distribution<int> modeDist(0, 2);
+    std::vector<std::vector<float>> block(numChannels, std::vector<float>(kMaxBlock));
+    std::vector<float*> ptrs(numChannels);
+    for (int ch = 0; ch < numChannels; ++ch)
+        ptrs[ch] = block[ch].data();
+
+    uint64_t expected = 0;
+    uint64_t failures = 0;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(seconds);
+
+    while (failures == 0 && std::chrono::steady_clock::now() < deadline)
+    {
+        const int n = blockDist(rng);
+        const int mode = modeDist(rng);
+
+        // Mode 0: plain read. Mode 1: accumulate onto a constant. Mode 2: peek, then advance.
+        const float base = mode == 1 ? 1.0f : 0.0f;
+        for (int ch = 0; ch < numChannels; ++ch)
+            std::fill(block[ch].begin(), block[ch].begin() + n, base);
+
+        const int got = fifo.read(ptrs.data(), numChannels, n, mode != 2, mode == 1);
+        if (mode == 2)
+            fifo.advanceRead(got);
+
+        for (int ch = 0; ch < numChannels && failures == 0; ++ch)
+        {
+            for (int i = 0; i < got; ++i)
+            {
+                const float want = sampleValue(expected + i, ch) + base;
+                if (block[ch][i] != want)
+                {
+                    std::fprintf(
+                        stderr,
+                        "FAIL: channel %d sample %llu: got %.1f, expected %.1f\n",
+                        ch,
+                        static_cast<unsigned long long>(expected + i),
+                        block[ch][i],
+                        want
+                    );
+                    ++failures;
+                    break;
+                }
+            }
+        }
+
+        expected += got;
+        if (got == 0)
+            std::this_thread::yield();
+    }
+
+    stop.store(true, std::memory_order_relaxed);
+    writer.join();
+
+    // Whatever the writer committed but we didn't read yet must still be queued
+    const uint64_t queued = static_cast<uint64_t>(fifo.getFifo().getNumReady());
+    if (failures == 0 && expected + queued != totalWritten.load())
+    {
+        std::fprintf(
+            stderr,
+            "FAIL: written %llu, read %llu + queued %llu\n",
+            static_cast<unsigned long long>(totalWritten.load()),
+            static_cast<unsigned long long>(expected),
+            static_cast<unsigned long long>(queued)
+        );
+        ++failures;
+    }
+
+    std::printf(
+        "FifoBuffer2 SPSC stress: %d channels, %.1f s, %llu samples per channel, %.1f Msamples/s, %s\n",
+        numChannels,
+        seconds,
+        static_cast<unsigned long long>(expected),
+        static_cast<double>(expected) / seconds * 1.0e-6,
+        failures == 0 ? "OK" : "FAILED"
+    );
+
+    return failures == 0 ? 0 : 1;
+}
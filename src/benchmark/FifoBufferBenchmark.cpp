@@ -0,0 +1,200 @@
+// Throughput of atk::FifoBuffer against the previous per-channel vector implementation.
+// Usage: <exe> [blockSize] [seconds per case]
+
+#include <atkaudio/FifoBuffer.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+
+// The FifoBuffer implementation before contiguous storage: one vector per channel, modulo
+// indexing and a guard sample. Kept verbatim (minus memory locking) as the baseline.
+class LegacyFifoBuffer
+{
+public:
+    void reset()
+    {
+        readPos.store(0, std::memory_order_release);
+        writePos.store(0, std::memory_order_release);
+        for (auto& channel : buffer)
+            std::fill(channel.begin(), channel.end(), 0.0f);
+    }
+
+    void read(float* dest, int channel, int numSamples, bool advance = true)
+    {
+        if (channel >= numChannels || numSamples <= 0)
+            return;
+
+        const int readPosition = readPos.load(std::memory_order_acquire);
+        const int available = getNumReady();
+        const int toRead = std::min(numSamples, available);
+
+        if (toRead <= 0)
+            return;
+
+        const int start1 = readPosition;
+        const int size1 = std::min(toRead, totalSize - start1);
+        const int size2 = toRead - size1;
+
+        const float* src = buffer[channel].data();
+        if (size1 > 0)
+            std::copy(src + start1, src + start1 + size1, dest);
+
+        if (size2 > 0)
+            std::copy(src, src + size2, dest + size1);
+
+        if (advance)
+            readPos.store((readPosition + toRead) % totalSize, std::memory_order_release);
+    }
+
+    void write(const float* data, int channel, int numSamples, bool advance = true)
+    {
+        if (channel >= numChannels || numSamples <= 0)
+            return;
+
+        const int writePosition = writePos.load(std::memory_order_acquire);
+        const int freeSpace = getFreeSpace();
+        const int toWrite = std::min(numSamples, freeSpace);
+
+        if (toWrite <= 0)
+            return;
+
+        const int start1 = writePosition;
+        const int size1 = std::min(toWrite, totalSize - start1);
+        const int size2 = toWrite - size1;
+
+        float* dst = buffer[channel].data();
+        if (size1 > 0)
+            std::copy(data, data + size1, dst + start1);
+
+        if (size2 > 0)
+            std::copy(data + size1, data + size1 + size2, dst);
+
+        if (advance)
+            writePos.store((writePosition + toWrite) % totalSize, std::memory_order_release);
+    }
+
+    void advanceRead(int numSamples)
+    {
+        const int readPosition = readPos.load(std::memory_order_acquire);
+        readPos.store((readPosition + numSamples) % totalSize, std::memory_order_release);
+    }
+
+    int getNumReady() const
+    {
+        const int writePosition = writePos.load(std::memory_order_acquire);
+        const int readPosition = readPos.load(std::memory_order_acquire);
+        if (writePosition >= readPosition)
+            return writePosition - readPosition;
+        else
+            return totalSize - readPosition + writePosition;
+    }
+
+    int getFreeSpace() const
+    {
+        return totalSize - getNumReady() - 1;
+    }
+
+    void setSize(int newNumChannels, int numSamples)
+    {
+        numChannels = newNumChannels;
+        totalSize = numSamples;
+        buffer.resize(numChannels);
+        for (auto& channel : buffer)
+            channel.resize(totalSize, 0.0f);
+        reset();
+    }
+
+private:
+    int numChannels = 0;
+    int totalSize = 0;
+    std::atomic<int> readPos{0};
+    std::atomic<int> writePos{0};
+    std::vector<std::vector<float>> buffer;
+};
+
+// Keeps the copies observable so they can't be optimised away
+volatile float sink = 0.0f;
+
+// Pushes and pops one block per channel per iteration. Reads trail writes by a block and a half
+// so both copies regularly straddle the wrap point, as they do in SyncBuffer.
+// Returns samples per second per channel, counting write + read once.
+template <typename Fifo>
+double run(int numChannels, int blockSize, int fifoSize, double seconds)
+{
+    Fifo fifo;
+    fifo.setSize(numChannels, fifoSize);
+
+    std::vector<std::vector<float>> in(numChannels, std::vector<float>(blockSize));
+    std::vector<std::vector<float>> out(numChannels, std::vector<float>(blockSize));
+    for (int ch = 0; ch < numChannels; ++ch)
+        for (int i = 0; i < blockSize; ++i)
+            in[ch][i] = static_cast<float>(ch * blockSize + i) * 1.0e-6f;
+
+    const int preroll = blockSize + blockSize / 2;
+    std::vector<float> silence(preroll);
+    for (int ch = 0; ch < numChannels; ++ch)
+        fifo.write(silence.data(), ch, preroll, ch == numChannels - 1);
+
+    using Clock = std::chrono::steady_clock;
+    const auto deadline = Clock::now() + std::chrono::duration<double>(seconds);
+    const auto start = Clock::now();
+
+    float checksum = 0.0f;
+    long long iterations = 0;
+    while (Clock::now() < deadline)
+    {
+        for (int batch = 0; batch < 64; ++batch)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+                fifo.write(in[ch].data(), ch, blockSize, ch == numChannels - 1);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                fifo.read(out[ch].data(), ch, blockSize, false);
+            fifo.advanceRead(blockSize);
+
+            checksum += out[numChannels - 1][blockSize - 1];
+        }
+        iterations += 64;
+    }
+
+    const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    sink = checksum;
+    return static_cast<double>(iterations) * blockSize / elapsed;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const int blockSize = argc > 1 ? std::max(1, std::atoi(argv[1])) : 512;
+    const double seconds = argc > 2 ? std::max(0.05, std::atof(argv[2])) : 1.0;
+
+    // SyncBuffer's fixed size; the legacy buffer gets its guard sample on top as FifoBuffer2 used to add
+    const int fifoSize = 65536;
+
+    std::printf("FifoBuffer throughput, block %d, %.2f s per case (Msamples/s per channel)\n", blockSize, seconds);
+    std::printf("%8s %12s %12s %8s\n", "channels", "legacy", "contiguous", "speedup");
+
+    for (const int numChannels : {2, 8, 32})
+    {
+        const auto legacy = run<LegacyFifoBuffer>(numChannels, blockSize, fifoSize + 1, seconds);
+        const auto current = run<atk::FifoBuffer>(numChannels, blockSize, fifoSize, seconds);
+
+        std::printf(
+            "%8d %12.1f %12.1f %7.2fx\n",
+            numChannels,
+            legacy * 1.0e-6,
+            current * 1.0e-6,
+            current / legacy
+        );
+    }
+
+    return 0;
+}
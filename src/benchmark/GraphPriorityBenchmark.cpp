@@ -0,0 +1,172 @@
+// Latency of a Critical graph in atk::RealtimeThreadPool, alone and while Background graphs keep
+// the pool busy. The Critical graph is a row of independent tasks submitted once per period from
+// its own thread; the Background load is a wider row of longer tasks submitted back to back from
+// another. Reported against the time the Critical graph takes on one thread, which is what it
+// took under load before workers switched to it between tasks.
+// Checks that, under load, the median Critical run is at most maxRatio times that serial time.
+// Needs at least four hardware threads, one for each caller and two workers, to say anything;
+// exits 0 with a message otherwise.
+// Usage: <exe> [seconds per case] [maxRatio] [workers]. Exits non-zero on failure.
+
+#include <atkaudio/AudioProcessorGraphMT/RealtimeThreadPool.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// The plugin logs through OBS; the pool's start and stop lines go to the console here
+void atk::logging::log(Level, const char* scope, const juce::String& message)
+{
+    std::printf("[%s] %s\n", scope, message.toRawUTF8());
+}
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+constexpr auto kCriticalTask = std::chrono::microseconds(100);
+constexpr auto kBackgroundTask = std::chrono::microseconds(300);
+constexpr auto kCriticalPeriod = std::chrono::milliseconds(5);
+constexpr int kCriticalTasksPerWorker = 4;
+
+// Busy work standing in for a plugin's process call
+struct Work
+{
+    Clock::duration duration;
+};
+
+void spinFor(void* userData)
+{
+    const auto end = Clock::now() + static_cast<Work*>(userData)->duration;
+    while (Clock::now() < end)
+    {
+    }
+}
+
+void addRow(atk::DependencyTaskGraph& graph, Work& work, int numTasks)
+{
+    for (int i = 0; i < numTasks; ++i)
+        graph.addTask(&work, &spinFor);
+}
+
+double percentile(std::vector<double> values, double p)
+{
+    if (values.empty())
+        return 0.0;
+    std::sort(values.begin(), values.end());
+    return values[static_cast<size_t>(p * static_cast<double>(values.size() - 1))];
+}
+
+// Microseconds per Critical run
+std::vector<double> runCritical(int numWorkers, double seconds, bool withLoad)
+{
+    auto& pool = *atk::RealtimeThreadPool::getInstance();
+
+    Work backgroundWork{kBackgroundTask};
+    atk::DependencyTaskGraph background;
+    background.setPriority(atk::TaskGraphPriority::Background);
+    addRow(background, backgroundWork, 2 * numWorkers);
+
+    Work criticalWork{kCriticalTask};
+    atk::DependencyTaskGraph critical;
+    critical.setPriority(atk::TaskGraphPriority::Critical);
+    addRow(critical, criticalWork, kCriticalTasksPerWorker * numWorkers);
+
+    std::atomic<bool> running{true};
+    std::thread load;
+    if (withLoad)
+        load = std::thread(
+            [&]
+            {
+                while (running.load(std::memory_order_relaxed))
+                    pool.executeDependencyGraph(&background);
+            }
+        );
+
+    std::vector<double> latencies;
+    const auto end = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+    auto next = Clock::now() + kCriticalPeriod;
+    while (next < end)
+    {
+        std::this_thread::sleep_until(next);
+        const auto start = Clock::now();
+        pool.executeDependencyGraph(&critical);
+        latencies.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+        next += kCriticalPeriod;
+    }
+
+    running.store(false);
+    if (load.joinable())
+        load.join();
+    return latencies;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const double seconds = argc > 1 ? std::max(0.2, std::atof(argv[1])) : 2.0;
+    const double maxRatio = argc > 2 ? std::atof(argv[2]) : 0.75;
+    const int hardwareThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    // Leaves a thread each for the Critical and the Background callers
+    const int numWorkers =
+        argc > 3 ? std::clamp(std::atoi(argv[3]), 1, atk::RealtimeThreadPool::kMaxWorkers)
+                 : std::clamp(hardwareThreads - 2, 1, 8);
+
+    if (hardwareThreads < 4)
+    {
+        std::printf("%d hardware threads; the Critical graph can't run alongside the load\n", hardwareThreads);
+        return 0;
+    }
+
+    auto& pool = *atk::RealtimeThreadPool::getInstance();
+    pool.initialize(numWorkers);
+
+    const int numCriticalTasks = kCriticalTasksPerWorker * numWorkers;
+    const double serial = numCriticalTasks * std::chrono::duration<double, std::micro>(kCriticalTask).count();
+    const auto alone = runCritical(numWorkers, seconds, false);
+    const auto loaded = runCritical(numWorkers, seconds, true);
+
+    atk::RealtimeThreadPool::getInstance()->shutdown();
+    atk::RealtimeThreadPool::deleteInstance();
+
+    std::printf(
+        "Critical graph: %d x %lld us tasks every %lld ms, %d workers; serial time %.0f us\n",
+        numCriticalTasks,
+        static_cast<long long>(kCriticalTask.count()),
+        static_cast<long long>(kCriticalPeriod.count()),
+        numWorkers,
+        serial
+    );
+    std::printf(
+        "Background load: %d x %lld us tasks, back to back\n",
+        2 * numWorkers,
+        static_cast<long long>(kBackgroundTask.count())
+    );
+    std::printf("%-16s %8s %8s %8s %8s\n", "case", "runs", "p50 us", "p99 us", "max us");
+    for (const auto& [name, latencies] : {std::pair{"alone", &alone}, std::pair{"background load", &loaded}})
+        std::printf(
+            "%-16s %8zu %8.0f %8.0f %8.0f\n",
+            name,
+            latencies->size(),
+            percentile(*latencies, 0.5),
+            percentile(*latencies, 0.99),
+            percentile(*latencies, 1.0)
+        );
+
+    const double ratio = percentile(loaded, 0.5) / serial;
+    const bool passed = ratio <= maxRatio;
+    std::printf(
+        "\nloaded p50 over serial time: %.2f  %s (max %.2f)\n",
+        ratio,
+        passed ? "OK" : "FAILED",
+        maxRatio
+    );
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,194 @@
+// Cost per channel of the frame-at-a-time multichannel resampling kernels against the previous
+// one-interpolator-per-channel path, for each SyncBuffer quality, on a 44.1 -> 48 kHz bridge.
+// Also checks that both paths produce the same samples.
+// Usage: <exe> [seconds of audio per case]
+
+#include "ScalarInterpolators.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+namespace
+{
+
+struct Quality
+{
+    atk::InterpolationType type;
+    const char* name;
+};
+
+constexpr Quality kQualities[] = {
+    {atk::InterpolationType::Linear,     "linear"     },
+    {atk::InterpolationType::Lagrange,   "lagrange"   },
+    {atk::InterpolationType::SincMedium, "sinc-medium"},
+    {atk::InterpolationType::SincHigh,   "sinc-high"  },
+};
+
+constexpr double kInRate = 44100.0;
+constexpr double kOutRate = 48000.0;
+constexpr int kBlockSize = 480;
+constexpr int kRepeats = 3;
+
+std::shared_ptr<const atk::SincFilterBank> createBank(atk::InterpolationType type, double ratio)
+{
+    return atk::isSincInterpolation(type) ? atk::SincFilterBank::create(type, ratio) : nullptr;
+}
+
+std::unique_ptr<atk::Interpolator> createInterpolator(
+    atk::InterpolationType type,
+    const std::shared_ptr<const atk::SincFilterBank>& bank
+)
+{
+    if (type == atk::InterpolationType::Linear)
+        return std::make_unique<atk::LinearInterpolator>();
+    if (bank != nullptr)
+        return std::make_unique<atk::SincInterpolator>(bank);
+    return std::make_unique<atk::LagrangeInterpolator>();
+}
+
+using Channels = std::vector<std::vector<float>>;
+
+Channels makeInput(int numChannels, size_t numSamples)
+{
+    Channels in(numChannels, std::vector<float>(numSamples));
+    for (int ch = 0; ch < numChannels; ++ch)
+        for (size_t i = 0; i < numSamples; ++i)
+            in[ch][i] = static_cast<float>(0.5 * std::sin(2.0 * 3.14159265358979323846 * (200.0 + 97.0 * ch) * i / kInRate));
+    return in;
+}
+
+// Both paths are driven block by block the way SyncBuffer::read drives them
+struct Result
+{
+    Channels out;
+    double seconds;
+};
+
+Result runPerChannel(atk::InterpolationType type, const Channels& in, double ratio)
+{
+    const int numChannels = static_cast<int>(in.size());
+    const auto bank = createBank(type, ratio);
+    std::vector<std::unique_ptr<atk::Interpolator>> interpolators;
+    for (int ch = 0; ch < numChannels; ++ch)
+        interpolators.push_back(createInterpolator(type, bank));
+
+    const size_t numBlocks = static_cast<size_t>(in[0].size() / ratio) / kBlockSize - 4;
+    Channels out(numChannels, std::vector<float>(numBlocks * kBlockSize));
+
+    const auto start = std::chrono::steady_clock::now();
+    size_t inPos = 0;
+    for (size_t outPos = 0; outPos < out[0].size(); outPos += kBlockSize)
+    {
+        int consumed = 0;
+        for (int ch = 0; ch < numChannels; ++ch)
+            consumed = interpolators[ch]->process(
+                ratio,
+                in[ch].data() + inPos,
+                out[ch].data() + outPos,
+                kBlockSize,
+                static_cast<int>(in[ch].size() - inPos),
+                0
+            );
+        inPos += consumed;
+    }
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return {std::move(out), elapsed};
+}
+
+Result runMultichannel(atk::InterpolationType type, const Channels& in, double ratio)
+{
+    const int numChannels = static_cast<int>(in.size());
+    auto interpolator = atk::createMultichannelInterpolator(type, numChannels, createBank(type, ratio));
+
+    const size_t numBlocks = static_cast<size_t>(in[0].size() / ratio) / kBlockSize - 4;
+    Channels out(numChannels, std::vector<float>(numBlocks * kBlockSize));
+    std::vector<const float*> inPtrs(numChannels);
+    std::vector<float*> outPtrs(numChannels);
+
+    const auto start = std::chrono::steady_clock::now();
+    size_t inPos = 0;
+    for (size_t outPos = 0; outPos < out[0].size(); outPos += kBlockSize)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            inPtrs[ch] = in[ch].data() + inPos;
+            outPtrs[ch] = out[ch].data() + outPos;
+        }
+        int produced = 0;
+        inPos += interpolator->process(
+            ratio,
+            inPtrs.data(),
+            static_cast<int>(in[0].size() - inPos),
+            outPtrs.data(),
+            kBlockSize,
+            produced
+        );
+    }
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return {std::move(out), elapsed};
+}
+
+float maxDifference(const Channels& a, const Channels& b)
+{
+    float diff = 0.0f;
+    for (size_t ch = 0; ch < a.size(); ++ch)
+        for (size_t i = 0; i < a[ch].size(); ++i)
+            diff = std::max(diff, std::abs(a[ch][i] - b[ch][i]));
+    return diff;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const double seconds = argc > 1 ? std::max(0.1, std::atof(argv[1])) : 1.0;
+    const double ratio = kInRate / kOutRate;
+
+    std::printf("%.1f kHz -> %.1f kHz, block %d, %.2f s of audio per case\n", kInRate / 1000.0, kOutRate / 1000.0, kBlockSize, seconds);
+    std::printf("%-12s %8s %16s %16s %8s %10s\n", "quality", "channels", "per-channel ns", "multichannel ns", "speedup", "max diff");
+
+    int failures = 0;
+    for (const auto& quality : kQualities)
+    {
+        for (const int numChannels : {2, 8, 32})
+        {
+            const auto in = makeInput(numChannels, static_cast<size_t>(kInRate * seconds));
+            auto old = runPerChannel(quality.type, in, ratio);
+            auto mc = runMultichannel(quality.type, in, ratio);
+
+            // Best of several runs; the first one also warms the caches
+            for (int repeat = 1; repeat < kRepeats; ++repeat)
+            {
+                old.seconds = std::min(old.seconds, runPerChannel(quality.type, in, ratio).seconds);
+                mc.seconds = std::min(mc.seconds, runMultichannel(quality.type, in, ratio).seconds);
+            }
+
+            const double samples = static_cast<double>(old.out[0].size()) * numChannels;
+            const double oldNs = old.seconds * 1.0e9 / samples;
+            const double mcNs = mc.seconds * 1.0e9 / samples;
+            const float diff = maxDifference(old.out, mc.out);
+            if (diff > 1.0e-5f)
+                ++failures;
+
+            std::printf(
+                "%-12s %8d %16.2f %16.2f %7.2fx %10.2g\n",
+                quality.name,
+                numChannels,
+                oldNs,
+                mcNs,
+                oldNs / mcNs,
+                static_cast<double>(diff)
+            );
+        }
+    }
+
+    std::printf("\nCost is ns per output sample per channel (lower is better).\n");
+    if (failures > 0)
+        std::fprintf(stderr, "FAIL: %d cases differ from the per-channel interpolators\n", failures);
+    return failures == 0 ? 0 : 1;
+}
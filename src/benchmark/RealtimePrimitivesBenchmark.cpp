@@ -0,0 +1,594 @@
+// Microbenchmark suite for the realtime primitives: thread handoff through AdaptiveSpinLock and
+// spinAtomicWait, LockFreeReadyQueue, FifoBuffer, FifoBuffer2, SyncBuffer and AtomicSharedPtr,
+// at audio block sizes and thread counts. Each case reports throughput and per-operation latency
+// percentiles; latencies are single steady_clock-timed calls, whose own overhead is the first row.
+// Usage: <exe> [case filter] [seconds per case] [max threads]
+
+#include <atkaudio/AtomicSharedPtr.h>
+#include <atkaudio/AudioProcessorGraphMT/AdaptiveSpinLock.h>
+#include <atkaudio/AudioProcessorGraphMT/DependencyTaskGraph.h>
+#include <atkaudio/AudioProcessorGraphMT/SpinWait.h>
+#include <atkaudio/FifoBuffer.h>
+#include <atkaudio/FifoBuffer2.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t kMaxLatencySamples = 1u << 21;
+constexpr int kFifoChannels = 2;
+constexpr int kFifoSize = 8192;
+constexpr int kBlockSizes[] = {64, 480, 1024};
+
+int64_t nanosecondsBetween(Clock::time_point start, Clock::time_point end)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+// Per-thread sample store; merged and sorted once the case is over
+class LatencyRecorder
+{
+public:
+    LatencyRecorder()
+    {
+        samples.reserve(kMaxLatencySamples);
+    }
+
+    void add(int64_t ns)
+    {
+        if (samples.size() < kMaxLatencySamples)
+            samples.push_back(static_cast<uint32_t>(std::clamp<int64_t>(ns, 0, std::numeric_limits<uint32_t>::max())));
+    }
+
+    void merge(const LatencyRecorder& other)
+    {
+        samples.insert(samples.end(), other.samples.begin(), other.samples.end());
+    }
+
+    void sort()
+    {
+        std::sort(samples.begin(), samples.end());
+    }
+
+    // Call sort() first
+    uint32_t percentile(double p) const
+    {
+        if (samples.empty())
+            return 0;
+        return samples[static_cast<size_t>(p * static_cast<double>(samples.size() - 1))];
+    }
+
+private:
+    std::vector<uint32_t> samples;
+};
+
+struct Options
+{
+    std::string filter;
+    double seconds = 1.0;
+    int maxThreads = 4;
+};
+
+void printHeader()
+{
+    std::printf(
+        "%-22s %-26s %14s %-10s %8s %8s %8s %9s %10s\n",
+        "case",
+        "parameters",
+        "throughput",
+        "unit",
+        "p50 ns",
+        "p90 ns",
+        "p99 ns",
+        "p99.9 ns",
+        "max ns"
+    );
+}
+
+void printRow(
+    const char* name,
+    const std::string& parameters,
+    double throughput,
+    const char* unit,
+    LatencyRecorder& latency
+)
+{
+    latency.sort();
+    std::printf(
+        "%-22s %-26s %14.2f %-10s %8u %8u %8u %9u %10u\n",
+        name,
+        parameters.c_str(),
+        throughput,
+        unit,
+        latency.percentile(0.5),
+        latency.percentile(0.9),
+        latency.percentile(0.99),
+        latency.percentile(0.999),
+        latency.percentile(1.0)
+    );
+}
+
+bool selected(const Options& options, const char* name)
+{
+    return options.filter.empty() || std::string(name).find(options.filter) != std::string::npos;
+}
+
+//==============================================================================
+void benchClockOverhead(const Options& options)
+{
+    LatencyRecorder latency;
+    const auto deadline = Clock::now() + std::chrono::duration<double>(options.seconds * 0.25);
+    uint64_t count = 0;
+    while (Clock::now() < deadline)
+    {
+        const auto start = Clock::now();
+        const auto end = Clock::now();
+        latency.add(nanosecondsBetween(start, end));
+        ++count;
+    }
+    printRow("steady_clock", "empty timed region", count / (options.seconds * 0.25) / 1.0e6, "Mops/s", latency);
+}
+
+//==============================================================================
+// Ping-pong between two threads: the initiator publishes an odd sequence number, the responder
+// answers with the next even one. Latency is the initiator's round trip.
+enum class WaitKind
+{
+    AdaptiveSpinLock,
+    SpinAtomicWait
+};
+
+void waitWhileEqual(WaitKind kind, atk::AdaptiveSpinLock& spinLock, std::atomic<uint32_t>& flag, uint32_t value)
+{
+    if (kind == WaitKind::AdaptiveSpinLock)
+        spinLock.waitWhile(flag, value);
+    else
+        atk::spinAtomicWait(flag, value);
+}
+
+void benchHandoff(const Options& options, WaitKind kind)
+{
+    constexpr uint32_t kStop = std::numeric_limits<uint32_t>::max();
+    std::atomic<uint32_t> flag{0};
+    atk::AdaptiveSpinLock initiatorLock;
+    atk::AdaptiveSpinLock responderLock;
+
+    std::thread responder(
+        [&]
+        {
+            uint32_t seen = 0;
+            while (true)
+            {
+                waitWhileEqual(kind, responderLock, flag, seen);
+                const uint32_t value = flag.load(std::memory_order_acquire);
+                if (value == kStop)
+                    return;
+                seen = value + 1;
+                flag.store(seen, std::memory_order_release);
+                atk::spinAtomicNotifyOne(flag);
+            }
+        }
+    );
+
+    LatencyRecorder latency;
+    uint64_t roundTrips = 0;
+    uint32_t sequence = 0;
+    const auto begin = Clock::now();
+    const auto deadline = begin + std::chrono::duration<double>(options.seconds);
+    while (Clock::now() < deadline)
+    {
+        const auto start = Clock::now();
+        ++sequence;
+        flag.store(sequence, std::memory_order_release);
+        atk::spinAtomicNotifyOne(flag);
+        waitWhileEqual(kind, initiatorLock, flag, sequence);
+        ++sequence;
+        latency.add(nanosecondsBetween(start, Clock::now()));
+        ++roundTrips;
+    }
+    const double elapsed = std::chrono::duration<double>(Clock::now() - begin).count();
+
+    flag.store(kStop, std::memory_order_release);
+    atk::spinAtomicNotifyOne(flag);
+    responder.join();
+
+    printRow(
+        kind == WaitKind::AdaptiveSpinLock ? "AdaptiveSpinLock" : "spinAtomicWait",
+        "2-thread round trip",
+        roundTrips / elapsed / 1.0e3,
+        "k trips/s",
+        latency
+    );
+}
+
+//==============================================================================
+// Producers push task indices, consumers pop them, the way the task graph schedules work
+void benchReadyQueue(const Options& options, int numProducers, int numConsumers)
+{
+    auto queue = std::make_unique<atk::LockFreeReadyQueue<size_t, 1024>>();
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> popped{0};
+    std::vector<LatencyRecorder> pushLatency(static_cast<size_t>(numProducers));
+    std::vector<LatencyRecorder> popLatency(static_cast<size_t>(numConsumers));
+    std::vector<std::thread> threads;
+
+    for (int p = 0; p < numProducers; ++p)
+        threads.emplace_back(
+            [&, p]
+            {
+                auto& latency = pushLatency[static_cast<size_t>(p)];
+                size_t value = 0;
+                while (!stop.load(std::memory_order_relaxed))
+                {
+                    const auto start = Clock::now();
+                    const bool pushed = queue->tryPush(value);
+                    const auto end = Clock::now();
+                    if (pushed)
+                    {
+                        latency.add(nanosecondsBetween(start, end));
+                        ++value;
+                    }
+                    else
+                    {
+                        atk::cpuPause();
+                    }
+                }
+            }
+        );
+
+    for (int c = 0; c < numConsumers; ++c)
+        threads.emplace_back(
+            [&, c]
+            {
+                auto& latency = popLatency[static_cast<size_t>(c)];
+                uint64_t count = 0;
+                size_t value = 0;
+                while (!stop.load(std::memory_order_relaxed))
+                {
+                    const auto start = Clock::now();
+                    const bool gotOne = queue->tryPop(value);
+                    const auto end = Clock::now();
+                    if (gotOne)
+                    {
+                        latency.add(nanosecondsBetween(start, end));
+                        ++count;
+                    }
+                    else
+                    {
+                        atk::cpuPause();
+                    }
+                }
+                popped.fetch_add(count);
+            }
+        );
+
+    const auto begin = Clock::now();
+    std::this_thread::sleep_for(std::chrono::duration<double>(options.seconds));
+    stop.store(true);
+    for (auto& thread : threads)
+        thread.join();
+    const double elapsed = std::chrono::duration<double>(Clock::now() - begin).count();
+
+    LatencyRecorder push;
+    LatencyRecorder pop;
+    for (const auto& latency : pushLatency)
+        push.merge(latency);
+    for (const auto& latency : popLatency)
+        pop.merge(latency);
+
+    const std::string parameters =
+        std::to_string(numProducers) + " producers, " + std::to_string(numConsumers) + " consumers";
+    const double throughput = popped.load() / elapsed / 1.0e6;
+    printRow("ReadyQueue tryPush", parameters, throughput, "Mitems/s", push);
+    printRow("ReadyQueue tryPop", parameters, throughput, "Mitems/s", pop);
+}
+
+//==============================================================================
+// One writer and one reader thread moving blocks through the FIFO as fast as it allows
+template <typename Fifo, typename WriteBlock, typename ReadBlock>
+void benchFifo(const Options& options, const char* name, int blockSize, WriteBlock writeBlock, ReadBlock readBlock)
+{
+    Fifo fifo;
+    fifo.setSize(kFifoChannels, kFifoSize);
+
+    std::atomic<bool> stop{false};
+    LatencyRecorder writeLatency;
+    LatencyRecorder readLatency;
+    uint64_t samplesRead = 0;
+
+    std::thread writer(
+        [&]
+        {
+            std::vector<std::vector<float>> block(
+                kFifoChannels,
+                std::vector<float>(static_cast<size_t>(blockSize), 0.25f)
+            );
+            std::vector<const float*> ptrs;
+            for (auto& channel : block)
+                ptrs.push_back(channel.data());
+
+            while (!stop.load(std::memory_order_relaxed))
+            {
+                const auto start = Clock::now();
+                const bool wrote = writeBlock(fifo, ptrs.data(), blockSize);
+                const auto end = Clock::now();
+                if (wrote)
+                    writeLatency.add(nanosecondsBetween(start, end));
+                else
+                    atk::cpuPause();
+            }
+        }
+    );
+
+    std::vector<std::vector<float>> block(kFifoChannels, std::vector<float>(static_cast<size_t>(blockSize)));
+    std::vector<float*> ptrs;
+    for (auto& channel : block)
+        ptrs.push_back(channel.data());
+
+    const auto begin = Clock::now();
+    const auto deadline = begin + std::chrono::duration<double>(options.seconds);
+    while (Clock::now() < deadline)
+    {
+        const auto start = Clock::now();
+        const bool read = readBlock(fifo, ptrs.data(), blockSize);
+        const auto end = Clock::now();
+        if (read)
+        {
+            readLatency.add(nanosecondsBetween(start, end));
+            samplesRead += static_cast<uint64_t>(blockSize);
+        }
+        else
+        {
+            atk::cpuPause();
+        }
+    }
+    const double elapsed = std::chrono::duration<double>(Clock::now() - begin).count();
+    stop.store(true);
+    writer.join();
+
+    const std::string parameters = std::to_string(kFifoChannels) + "ch, block " + std::to_string(blockSize);
+    const double throughput = samplesRead / elapsed / 1.0e6;
+    printRow((std::string(name) + " write").c_str(), parameters, throughput, "Msamples/s", writeLatency);
+    printRow((std::string(name) + " read").c_str(), parameters, throughput, "Msamples/s", readLatency);
+}
+
+void benchFifoBuffer(const Options& options, int blockSize)
+{
+    benchFifo<atk::FifoBuffer>(
+        options,
+        "FifoBuffer",
+        blockSize,
+        [](atk::FifoBuffer& fifo, const float* const* src, int numSamples)
+        {
+            if (fifo.getFreeSpace() < numSamples)
+                return false;
+            for (int ch = 0; ch < kFifoChannels; ++ch)
+                fifo.write(src[ch], ch, numSamples, ch == kFifoChannels - 1);
+            return true;
+        },
+        [](atk::FifoBuffer& fifo, float* const* dest, int numSamples)
+        {
+            if (fifo.getNumReady() < numSamples)
+                return false;
+            for (int ch = 0; ch < kFifoChannels; ++ch)
+                fifo.read(dest[ch], ch, numSamples, ch == kFifoChannels - 1);
+            return true;
+        }
+    );
+}
+
+void benchFifoBuffer2(const Options& options, int blockSize)
+{
+    benchFifo<FifoBuffer2>(
+        options,
+        "FifoBuffer2",
+        blockSize,
+        [](FifoBuffer2& fifo, const float* const* src, int numSamples)
+        {
+            if (fifo.getFifo().getFreeSpace() < numSamples)
+                return false;
+            return fifo.write(src, kFifoChannels, numSamples) == numSamples;
+        },
+        [](FifoBuffer2& fifo, float* const* dest, int numSamples)
+        {
+            if (fifo.getFifo().getNumReady() < numSamples)
+                return false;
+            return fifo.read(dest, kFifoChannels, numSamples) == numSamples;
+        }
+    );
+}
+
+//==============================================================================
+// Device callbacks interleaved on one thread in timestamp order, so the cost is the read path's
+// resampling and bookkeeping rather than scheduling. 44.1 kHz / 441 in, 48 kHz / 480 out.
+void benchSyncBuffer(const Options& options, atk::InterpolationType type, const char* quality, int numChannels)
+{
+    constexpr double kWriterRate = 44100.0;
+    constexpr double kReaderRate = 48000.0;
+    constexpr int kWriterBlock = 441;
+    constexpr int kReaderBlock = 480;
+
+    SyncBuffer buffer;
+    buffer.setInterpolationType(type);
+
+    std::vector<std::vector<float>> in(numChannels, std::vector<float>(kWriterBlock));
+    std::vector<std::vector<float>> out(numChannels, std::vector<float>(kReaderBlock));
+    std::vector<const float*> inPtrs;
+    std::vector<float*> outPtrs;
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        for (int i = 0; i < kWriterBlock; ++i)
+            in[ch][i] = static_cast<float>(std::sin(0.05 * i + ch));
+        inPtrs.push_back(in[ch].data());
+        outPtrs.push_back(out[ch].data());
+    }
+
+    LatencyRecorder writeLatency;
+    LatencyRecorder readLatency;
+    uint64_t samplesRead = 0;
+    double writerTime = 0.0;
+    double readerTime = 0.0;
+    double busySeconds = 0.0;
+
+    // Both blocks last 10 ms, so the writer goes first each round
+    while (busySeconds < options.seconds)
+    {
+        if (writerTime <= readerTime)
+        {
+            const auto start = Clock::now();
+            buffer.write(inPtrs.data(), numChannels, kWriterBlock, kWriterRate);
+            const auto ns = nanosecondsBetween(start, Clock::now());
+            writeLatency.add(ns);
+            busySeconds += ns * 1.0e-9;
+            writerTime += kWriterBlock / kWriterRate;
+        }
+        else
+        {
+            const auto start = Clock::now();
+            if (buffer.read(outPtrs.data(), numChannels, kReaderBlock, kReaderRate))
+                samplesRead += kReaderBlock;
+            const auto ns = nanosecondsBetween(start, Clock::now());
+            readLatency.add(ns);
+            busySeconds += ns * 1.0e-9;
+            readerTime += kReaderBlock / kReaderRate;
+        }
+    }
+
+    const std::string parameters = std::to_string(numChannels) + "ch 44.1k>48k " + quality;
+    const double throughput = samplesRead / busySeconds / 1.0e6;
+    printRow("SyncBuffer write", parameters, throughput, "Msamples/s", writeLatency);
+    printRow("SyncBuffer read", parameters, throughput, "Msamples/s", readLatency);
+}
+
+//==============================================================================
+// Audio-thread style readers loading a snapshot while a writer replaces it every 100 us
+struct Snapshot
+{
+    std::vector<int> routes = std::vector<int>(256, 1);
+};
+
+void benchAtomicSharedPtr(const Options& options, int numReaders)
+{
+    atk::AtomicSharedPtr<Snapshot> shared(std::make_shared<Snapshot>());
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> loads{0};
+    std::vector<LatencyRecorder> latencies(static_cast<size_t>(numReaders));
+    std::vector<std::thread> readers;
+
+    for (int r = 0; r < numReaders; ++r)
+        readers.emplace_back(
+            [&, r]
+            {
+                auto& latency = latencies[static_cast<size_t>(r)];
+                uint64_t count = 0;
+                while (!stop.load(std::memory_order_relaxed))
+                {
+                    const auto start = Clock::now();
+                    auto snapshot = shared.load();
+                    const auto end = Clock::now();
+                    latency.add(nanosecondsBetween(start, end));
+                    count += snapshot->routes.size() > 0 ? 1 : 0;
+                }
+                loads.fetch_add(count);
+            }
+        );
+
+    const auto begin = Clock::now();
+    const auto deadline = begin + std::chrono::duration<double>(options.seconds);
+    while (Clock::now() < deadline)
+    {
+        shared.store(std::make_shared<Snapshot>());
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    stop.store(true);
+    for (auto& reader : readers)
+        reader.join();
+    const double elapsed = std::chrono::duration<double>(Clock::now() - begin).count();
+
+    LatencyRecorder latency;
+    for (const auto& recorder : latencies)
+        latency.merge(recorder);
+    printRow(
+        "AtomicSharedPtr load",
+        std::to_string(numReaders) + " readers, store/100us",
+        loads.load() / elapsed / 1.0e6,
+        "Mloads/s",
+        latency
+    );
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (argc > 1 && std::string(argv[1]) != "all")
+        options.filter = argv[1];
+    if (argc > 2)
+        options.seconds = std::max(0.05, std::atof(argv[2]));
+    const int hardwareThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    options.maxThreads = argc > 3 ? std::clamp(std::atoi(argv[3]), 2, 64) : std::clamp(hardwareThreads, 2, 8);
+
+    std::printf(
+        "%.2f s per case, up to %d threads, %d hardware threads\n",
+        options.seconds,
+        options.maxThreads,
+        hardwareThreads
+    );
+    printHeader();
+
+    if (selected(options, "steady_clock"))
+        benchClockOverhead(options);
+
+    if (selected(options, "AdaptiveSpinLock"))
+        benchHandoff(options, WaitKind::AdaptiveSpinLock);
+    if (selected(options, "spinAtomicWait"))
+        benchHandoff(options, WaitKind::SpinAtomicWait);
+
+    if (selected(options, "ReadyQueue"))
+    {
+        benchReadyQueue(options, 1, 1);
+        if (options.maxThreads >= 4)
+            benchReadyQueue(options, options.maxThreads / 2, options.maxThreads / 2);
+    }
+
+    for (const int blockSize : kBlockSizes)
+    {
+        if (selected(options, "FifoBuffer"))
+            benchFifoBuffer(options, blockSize);
+        if (selected(options, "FifoBuffer2"))
+            benchFifoBuffer2(options, blockSize);
+    }
+
+    if (selected(options, "SyncBuffer"))
+    {
+        for (const int numChannels : {2, 8})
+        {
+            benchSyncBuffer(options, atk::InterpolationType::Lagrange, "lagrange", numChannels);
+            benchSyncBuffer(options, atk::InterpolationType::SincMedium, "sinc-medium", numChannels);
+        }
+    }
+
+    if (selected(options, "AtomicSharedPtr"))
+    {
+        benchAtomicSharedPtr(options, 1);
+        if (options.maxThreads > 2)
+            benchAtomicSharedPtr(options, options.maxThreads - 1);
+    }
+
+    return 0;
+}
@@ -0,0 +1,186 @@
+// THD+N and CPU cost of each SyncBuffer interpolation quality on the 44.1 <-> 48 kHz device bridges.
+// Usage: <exe> [seconds of audio per CPU measurement]
+
+#include "ScalarInterpolators.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+namespace
+{
+
+struct Quality
+{
+    atk::InterpolationType type;
+    const char* name;
+};
+
+constexpr Quality kQualities[] = {
+    {atk::InterpolationType::Linear,     "linear"     },
+    {atk::InterpolationType::Lagrange,   "lagrange"   },
+    {atk::InterpolationType::SincMedium, "sinc-medium"},
+    {atk::InterpolationType::SincHigh,   "sinc-high"  },
+};
+
+std::unique_ptr<atk::Interpolator> createInterpolator(atk::InterpolationType type, double ratio)
+{
+    switch (type)
+    {
+    case atk::InterpolationType::Linear:
+        return std::make_unique<atk::LinearInterpolator>();
+    case atk::InterpolationType::Lagrange:
+        return std::make_unique<atk::LagrangeInterpolator>();
+    case atk::InterpolationType::SincMedium:
+    case atk::InterpolationType::SincHigh:
+        break;
+    }
+    return std::make_unique<atk::SincInterpolator>(atk::SincFilterBank::create(type, ratio));
+}
+
+// Resamples in device-sized blocks the way SyncBuffer::read drives the interpolators
+std::vector<float> resample(atk::Interpolator& interp, const std::vector<float>& in, double ratio, int blockSize)
+{
+    const size_t numBlocks = static_cast<size_t>(in.size() / ratio) / blockSize - 4;
+    std::vector<float> out(numBlocks * blockSize);
+    size_t inPos = 0;
+    for (size_t outPos = 0; outPos < out.size(); outPos += blockSize)
+        inPos += interp.process(
+            ratio,
+            in.data() + inPos,
+            out.data() + outPos,
+            blockSize,
+            static_cast<int>(in.size() - inPos),
+            0
+        );
+    return out;
+}
+
+// Least-squares fit of a sinusoid at the known frequency (plus DC); everything else is THD+N
+double measureThdPlusNoiseDb(const std::vector<float>& y, double omega, size_t skip)
+{
+    double scc = 0, sss = 0, scs = 0, sc = 0, ss = 0, sy = 0, syc = 0, sys = 0;
+    const size_t n = y.size() - skip;
+    for (size_t i = skip; i < y.size(); ++i)
+    {
+        const double c = std::cos(omega * i), s = std::sin(omega * i);
+        scc += c * c;
+        sss += s * s;
+        scs += c * s;
+        sc += c;
+        ss += s;
+        sy += y[i];
+        syc += y[i] * c;
+        sys += y[i] * s;
+    }
+
+    // Solve the 3x3 normal equations [scc scs sc; scs sss ss; sc ss n] [a b d] = [syc sys sy]
+    const double m[3][4] = {
+        {scc, scs, sc,                  syc},
+        {scs, sss, ss,                  sys},
+        {sc,  ss,  static_cast<double>(n), sy },
+    };
+    double a[3][4];
+    std::copy(&m[0][0], &m[0][0] + 12, &a[0][0]);
+    for (int col = 0; col < 3; ++col)
+        for (int row = col + 1; row < 3; ++row)
+        {
+            const double f = a[row][col] / a[col][col];
+            for (int k = col; k < 4; ++k)
+                a[row][k] -= f * a[col][k];
+        }
+    double x[3];
+    for (int row = 2; row >= 0; --row)
+    {
+        double v = a[row][3];
+        for (int k = row + 1; k < 3; ++k)
+            v -= a[row][k] * x[k];
+        x[row] = v / a[row][row];
+    }
+
+    double signal = 0.0, residual = 0.0;
+    for (size_t i = skip; i < y.size(); ++i)
+    {
+        const double fit = x[0] * std::cos(omega * i) + x[1] * std::sin(omega * i) + x[2];
+        signal += (fit - x[2]) * (fit - x[2]);
+        residual += (y[i] - fit) * (y[i] - fit);
+    }
+    return 10.0 * std::log10(residual / signal);
+}
+
+std::vector<float> sine(double frequency, double sampleRate, size_t numSamples)
+{
+    std::vector<float> v(numSamples);
+    for (size_t i = 0; i < numSamples; ++i)
+        v[i] = static_cast<float>(0.5 * std::sin(2.0 * 3.14159265358979323846 * frequency * i / sampleRate));
+    return v;
+}
+
+volatile float sink = 0.0f;
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const double cpuSeconds = argc > 1 ? std::max(0.1, std::atof(argv[1])) : 2.0;
+    constexpr int blockSize = 480;
+
+    struct Bridge
+    {
+        double inRate;
+        double outRate;
+    };
+
+    const Bridge bridges[] = {
+        {44100.0, 48000.0},
+        {48000.0, 44100.0},
+    };
+    const double tones[] = {1000.0, 10000.0, 18000.0};
+
+    for (const auto& bridge : bridges)
+    {
+        const double ratio = bridge.inRate / bridge.outRate;
+        std::printf("\n%.1f kHz -> %.1f kHz\n", bridge.inRate / 1000.0, bridge.outRate / 1000.0);
+        std::printf("%-12s %10s %10s %10s %12s %12s\n", "quality", "1k THD+N", "10k THD+N", "18k THD+N", "ns/sample", "% RT/channel");
+
+        for (const auto& quality : kQualities)
+        {
+            double thd[3];
+            for (int t = 0; t < 3; ++t)
+            {
+                auto interp = createInterpolator(quality.type, ratio);
+                const auto in = sine(tones[t], bridge.inRate, static_cast<size_t>(bridge.inRate));
+                const auto out = resample(*interp, in, ratio, blockSize);
+                thd[t] = measureThdPlusNoiseDb(out, 2.0 * 3.14159265358979323846 * tones[t] / bridge.outRate, 4096);
+            }
+
+            // CPU: one channel, cpuSeconds of audio, steady state
+            auto interp = createInterpolator(quality.type, ratio);
+            const auto in = sine(1000.0, bridge.inRate, static_cast<size_t>(bridge.inRate * cpuSeconds));
+            const auto start = std::chrono::steady_clock::now();
+            const auto out = resample(*interp, in, ratio, blockSize);
+            const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            sink = out[out.size() / 2];
+
+            const double nsPerSample = elapsed * 1.0e9 / static_cast<double>(out.size());
+            const double realtimePercent = 100.0 * elapsed / (static_cast<double>(out.size()) / bridge.outRate);
+
+            std::printf(
+                "%-12s %9.1f %10.1f %10.1f %12.2f %12.3f\n",
+                quality.name,
+                thd[0],
+                thd[1],
+                thd[2],
+                nsPerSample,
+                realtimePercent
+            );
+        }
+    }
+
+    std::printf("\nTHD+N in dB relative to the fitted tone (lower is better); CPU is for one channel.\n");
+    return 0;
+}
@@ -0,0 +1,417 @@
+// The scalar, one-channel-at-a-time interpolators SyncBuffer used before the multichannel kernels
+// in FifoBuffer2.h. Kept for the benchmarks only, as the baseline the kernels are measured and
+// checked against; they produce the same samples (see MultichannelResamplerBenchmark).
+
+#pragma once
+
+#include <atkaudio/FifoBuffer2.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace atk
+{
+
+class Interpolator
+{
+public:
+    virtual ~Interpolator() = default;
+    virtual void reset() noexcept = 0;
+    virtual int process(
+        double speedRatio,
+        const float* inputSamples,
+        float* outputSamples,
+        int numOutputSamples,
+        int numInputSamples,
+        int wrapAround
+    ) noexcept = 0;
+    virtual int processAdding(
+        double speedRatio,
+        const float* inputSamples,
+        float* outputSamples,
+        int numOutputSamples,
+        int numInputSamples,
+        int wrapAround,
+        float gain
+    ) noexcept = 0;
+};
+
+class LinearInterpolator : public Interpolator
+{
+public:
+    LinearInterpolator() noexcept
+    {
+        reset();
+    }
+
+    void reset() noexcept override
+    {
+        lastInputSamples[0] = 0.0f;
+        lastInputSamples[1] = 0.0f;
+        subSamplePos = 0.0;
+    }
+
+    int process(
+        double speedRatio,
+        const float* inputSamples,
+        float* outputSamples,
+        int numOutputSamples,
+        int numInputSamples,
+        int wrapAround
+    ) noexcept override
+    {
+        (void)wrapAround; // Unused - reserved for future use
+        if (speedRatio <= 0.0)
+            return 0;
+
+        int pos = 0;
+        auto* out = outputSamples;
+
+        while (numOutputSamples > 0)
+        {
+            while (subSamplePos >= 1.0)
+            {
+                if (pos >= numInputSamples)
+                    return pos;
+
+                pushInterpolationSample(inputSamples[pos++]);
+                subSamplePos -= 1.0;
+            }
+
+            *out++ = interpolate();
+            subSamplePos += speedRatio;
+            --numOutputSamples;
+        }
+
+        return pos;
+    }
+
+    int processAdding(
+        double speedRatio,
+        const float* inputSamples,
+        float* outputSamples,
+        int numOutputSamples,
+        int numInputSamples,
+        int wrapAround,
+        float gain
+    ) noexcept override
+    {
+        (void)wrapAround; // Unused - reserved for future use
+        if (speedRatio <= 0.0)
+            return 0;
+
+        int pos = 0;
+        auto* out = outputSamples;
+
+        while (numOutputSamples > 0)
+        {
+            while (subSamplePos >= 1.0)
+            {
+                if (pos >= numInputSamples)
+                    return pos;
+
+                pushInterpolationSample(inputSamples[pos++]);
+                subSamplePos -= 1.0;
+            }
+
+            *out++ += gain * interpolate();
+            subSamplePos += speedRatio;
+            --numOutputSamples;
+        }
+
+        return pos;
+    }
+
+private:
+    void pushInterpolationSample(float newValue) noexcept
+    {
+        lastInputSamples[0] = lastInputSamples[1];
+        lastInputSamples[1] = newValue;
+    }
+
+    float interpolate() const noexcept
+    {
+        auto alpha = static_cast<float>(subSamplePos);
+        return lastInputSamples[0] + alpha * (lastInputSamples[1] - lastInputSamples[0]);
+    }
+
+    float lastInputSamples[2];
+    double subSamplePos;
+};
+
+class LagrangeInterpolator : public Interpolator
+{
+public:
+    LagrangeInterpolator() noexcept
+    {
+        reset();
+    }
+
+    void reset() noexcept override
+    {
+        subSamplePos = 1.0;
+        indexBuffer = 0;
+        for (int i = 0; i < 5; ++i)
+            lastInputSamples[i] = 0.0f;
+    }
+
+    int process(
+        double speedRatio,
+        const float* inputSamples,
+        float* outputSamples,
+        int numOutputSamples,
+        int numInputSamples,
+        int wrapAround
+    ) noexcept override
+    {
+        (void)wrapAround; // Unused - reserved for future use
+        if (speedRatio <= 0.0)
+            return 0;
+
+        int pos = 0;
+        auto* out = outputSamples;
+
+        while (numOutputSamples > 0)
+        {
+            while (subSamplePos >= 1.0)
+            {
+                if (pos >= numInputSamples)
+                    return pos;
+
+                pushInterpolationSample(inputSamples[pos++]);
+                subSamplePos -= 1.0;
+            }
+
+            *out++ = interpolate();
+            subSamplePos += speedRatio;
+            --numOutputSamples;
+        }
+
+        return pos;
+    }
+
+    int processAdding(
+        double speedRatio,
+        const float* inputSamples,
+        float* outputSamples,
+        int numOutputSamples,
+        int numInputSamples,
+        int wrapAround,
+        float gain
+    ) noexcept override
+    {
+        (void)wrapAround; // Unused - reserved for future use
+        if (speedRatio <= 0.0)
+            return 0;
+
+        int pos = 0;
+        auto* out = outputSamples;
+
+        while (numOutputSamples > 0)
+        {
+            while (subSamplePos >= 1.0)
+            {
+                if (pos >= numInputSamples)
+                    return pos;
+
+                pushInterpolationSample(inputSamples[pos++]);
+                subSamplePos -= 1.0;
+            }
+
+            *out++ += gain * interpolate();
+            subSamplePos += speedRatio;
+            --numOutputSamples;
+        }
+
+        return pos;
+    }
+
+private:
+    void pushInterpolationSample(float newValue) noexcept
+    {
+        lastInputSamples[indexBuffer] = newValue;
+        if (++indexBuffer == 5)
+            indexBuffer = 0;
+    }
+
+    template <int k>
+    static float calcCoefficient(float input, float offset) noexcept
+    {
+        if constexpr (k != 0)
+            input *= (-2.0f - offset) * (1.0f / (0 - k));
+        if constexpr (k != 1)
+            input *= (-1.0f - offset) * (1.0f / (1 - k));
+        if constexpr (k != 2)
+            input *= (0.0f - offset) * (1.0f / (2 - k));
+        if constexpr (k != 3)
+            input *= (1.0f - offset) * (1.0f / (3 - k));
+        if constexpr (k != 4)
+            input *= (2.0f - offset) * (1.0f / (4 - k));
+        return input;
+    }
+
+    float interpolate() const noexcept
+    {
+        auto offset = static_cast<float>(subSamplePos);
+        auto index = indexBuffer;
+
+        float result = 0.0f;
+        result += calcCoefficient<0>(lastInputSamples[index], offset);
+        if (++index == 5)
+            index = 0;
+        result += calcCoefficient<1>(lastInputSamples[index], offset);
+        if (++index == 5)
+            index = 0;
+        result += calcCoefficient<2>(lastInputSamples[index], offset);
+        if (++index == 5)
+            index = 0;
+        result += calcCoefficient<3>(lastInputSamples[index], offset);
+        if (++index == 5)
+            index = 0;
+        result += calcCoefficient<4>(lastInputSamples[index], offset);
+
+        return result;
+    }
+
+    float lastInputSamples[5];
+    double subSamplePos;
+    int indexBuffer{0};
+};
+
+//==============================================================================
+// Polyphase windowed-sinc resampler. Outputs are positioned like LagrangeInterpolator's:
+// subSamplePos is the offset between the two centre taps, so the latency is taps / 2 samples.
+class SincInterpolator : public Interpolator
+{
+public:
+    explicit SincInterpolator(std::shared_ptr<const SincFilterBank> filterBank)
+        : bank(std::move(filterBank))
+        , numTaps(bank->getNumTaps())
+        , history(static_cast<size_t>(2 * numTaps))
+    {
+        reset();
+    }
+
+    void reset() noexcept override
+    {
+        std::fill(history.begin(), history.end(), 0.0f);
+        writeIndex = 0;
+        subSamplePos = 1.0;
+    }
+
+    int process(
+        double speedRatio,
+        const float* inputSamples,
+        float* outputSamples,
+        int numOutputSamples,
+        int numInputSamples,
+        int wrapAround
+    ) noexcept override
+    {
+        (void)wrapAround; // Unused - reserved for future use
+        if (speedRatio <= 0.0)
+            return 0;
+
+        int pos = 0;
+        auto* out = outputSamples;
+
+        while (numOutputSamples > 0)
+        {
+            while (subSamplePos >= 1.0)
+            {
+                if (pos >= numInputSamples)
+                    return pos;
+
+                pushInterpolationSample(inputSamples[pos++]);
+                subSamplePos -= 1.0;
+            }
+
+            *out++ = interpolate();
+            subSamplePos += speedRatio;
+            --numOutputSamples;
+        }
+
+        return pos;
+    }
+
+    int processAdding(
+        double speedRatio,
+        const float* inputSamples,
+        float* outputSamples,
+        int numOutputSamples,
+        int numInputSamples,
+        int wrapAround,
+        float gain
+    ) noexcept override
+    {
+        (void)wrapAround; // Unused - reserved for future use
+        if (speedRatio <= 0.0)
+            return 0;
+
+        int pos = 0;
+        auto* out = outputSamples;
+
+        while (numOutputSamples > 0)
+        {
+            while (subSamplePos >= 1.0)
+            {
+                if (pos >= numInputSamples)
+                    return pos;
+
+                pushInterpolationSample(inputSamples[pos++]);
+                subSamplePos -= 1.0;
+            }
+
+            *out++ += gain * interpolate();
+            subSamplePos += speedRatio;
+            --numOutputSamples;
+        }
+
+        return pos;
+    }
+
+private:
+    // Each sample is stored twice so the newest numTaps samples are always contiguous
+    void pushInterpolationSample(float newValue) noexcept
+    {
+        history[static_cast<size_t>(writeIndex)] = newValue;
+        history[static_cast<size_t>(writeIndex + numTaps)] = newValue;
+        if (++writeIndex == numTaps)
+            writeIndex = 0;
+    }
+
+    static float dot(const float* a, const float* b, int n) noexcept
+    {
+        float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+        for (int i = 0; i < n; i += 4)
+        {
+            s0 += a[i] * b[i];
+            s1 += a[i + 1] * b[i + 1];
+            s2 += a[i + 2] * b[i + 2];
+            s3 += a[i + 3] * b[i + 3];
+        }
+        return (s0 + s1) + (s2 + s3);
+    }
+
+    float interpolate() const noexcept
+    {
+        const float* window = history.data() + writeIndex; // oldest first
+
+        const double phasePos = subSamplePos * bank->getNumPhases();
+        const int phase = std::min(static_cast<int>(phasePos), bank->getNumPhases() - 1);
+        const auto alpha = static_cast<float>(phasePos - phase);
+
+        const float a = dot(window, bank->getPhase(phase), numTaps);
+        const float b = dot(window, bank->getPhase(phase + 1), numTaps);
+        return a + alpha * (b - a);
+    }
+
+    std::shared_ptr<const SincFilterBank> bank;
+    int numTaps;
+    std::vector<float> history;
+    int writeIndex{0};
+    double subSamplePos{1.0};
+};
+
+} // namespace atk
@@ -0,0 +1,395 @@
+// Deterministic clock drift and jitter simulator for SyncBuffer. A writer and a reader device run
+// on simulated clocks with their own ppm offset, block size and callback jitter; the writer can
+// also stall (dropouts). Time is virtual, so minutes of audio run in well under a second and every
+// run is bit-identical. Each scenario asserts:
+//   - the worst-case level SyncBuffer steers on gets inside the compensation band (plus one writer
+//     block, the level's granularity) within maxConvergenceSeconds, and any later excursion, such
+//     as a slow writer losing a block at a phase crossing, recovers within the same time,
+//   - no read after warm-up underflows, and the output has no discontinuities,
+//   - the drift estimate ends near the true clock offset.
+// The shared-source scenario routes the writer through a BroadcastFifo, as AudioServer does for
+// device inputs, and reads one of its channels.
+// Usage: <exe> [scenario|all] [trace.csv]. Exits non-zero if any scenario fails.
+
+#include <atkaudio/FifoBuffer2.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+constexpr double kTwoPi = 6.283185307179586476925286766559;
+
+enum class Jitter
+{
+    None,
+    Gaussian,   // symmetric, jitterMs is the standard deviation
+    Exponential // late-only, jitterMs is the mean lateness (Bluetooth, network)
+};
+
+struct DeviceClock
+{
+    double nominalRate;
+    double ppm; // actual rate = nominal * (1 + ppm * 1e-6)
+    int blockSize;
+    Jitter jitter = Jitter::None;
+    double jitterMs = 0.0;
+};
+
+struct Scenario
+{
+    const char* name;
+    DeviceClock writer;
+    DeviceClock reader;
+    double seconds = 300.0;
+    double warmupSeconds = 20.0;
+    double maxConvergenceSeconds = 60.0;
+    double dropoutEverySeconds = 0.0; // writer stalls this often...
+    double dropoutMs = 0.0;           // ...for this long, then delivers the backlog back to back
+    bool adaptive = false;
+    atk::InterpolationType interpolation = atk::InterpolationType::Lagrange;
+    bool sharedSource = false; // write a second, silent channel into a BroadcastFifo and read the tone from it
+};
+
+// clang-format off
+const Scenario kScenarios[] = {
+    {"locked",           {48000.0,    0.0, 480},                            {48000.0, 0.0, 480}},
+    {"drift+100ppm",     {48000.0,  100.0, 512},                            {48000.0, 0.0, 512}},
+    {"drift-250ppm-src", {44100.0, -250.0, 441},                            {48000.0, 0.0, 480}},
+    {"block-mismatch",   {48000.0,   60.0, 1024},                           {44100.0, -40.0, 128}},
+    {"usb-jitter",       {48000.0,   50.0, 256, Jitter::Gaussian, 0.3},     {48000.0, 0.0, 480, Jitter::Gaussian, 0.3}},
+    {"bluetooth",        {48000.0,  -80.0, 512, Jitter::Exponential, 4.0},  {48000.0, 0.0, 480}, 300.0, 20.0, 60.0, 0.0, 0.0, true},
+    {"dropouts",         {48000.0,   30.0, 480},                            {48000.0, 0.0, 480}, 300.0, 20.0, 60.0, 7.0, 6.0},
+    {"sinc-drift",       {48000.0,  150.0, 480},                            {44100.0, 0.0, 441}, 300.0, 20.0, 60.0, 0.0, 0.0, false, atk::InterpolationType::SincMedium},
+    {"shared-source",    {48000.0,  120.0, 480},                            {48000.0, 0.0, 480}, 300.0, 20.0, 60.0, 0.0, 0.0, false, atk::InterpolationType::Lagrange, true},
+};
+// clang-format on
+
+// Portable, seeded distributions on top of mt19937_64 so runs match across standard libraries
+class Random
+{
+public:
+    explicit Random(uint64_t seed)
+        : engine(seed)
+    {
+    }
+
+    double uniform()
+    {
+        return static_cast<double>(engine() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    double gaussian()
+    {
+        const double u1 = std::max(uniform(), 1.0e-300);
+        return std::sqrt(-2.0 * std::log(u1)) * std::cos(kTwoPi * uniform());
+    }
+
+    double exponential()
+    {
+        return -std::log(1.0 - uniform());
+    }
+
+private:
+    std::mt19937_64 engine;
+};
+
+// Callback n of a device is due at n * block / actualRate, plus jitter. Callbacks never overtake
+// each other: a late one pushes the next one back if needed.
+class SimulatedDevice
+{
+public:
+    SimulatedDevice(const DeviceClock& c, uint64_t seed, double startOffset)
+        : config(c)
+        , random(seed)
+        , period(c.blockSize / (c.nominalRate * (1.0 + c.ppm * 1.0e-6)))
+        , offset(startOffset)
+    {
+        scheduleNext(0.0);
+    }
+
+    double getNextTime() const
+    {
+        return nextTime;
+    }
+
+    void advance(double stallUntil)
+    {
+        ++index;
+        scheduleNext(stallUntil);
+    }
+
+    const DeviceClock& config;
+
+private:
+    void scheduleNext(double notBefore)
+    {
+        double jitterSeconds = 0.0;
+        if (config.jitter == Jitter::Gaussian)
+            jitterSeconds = random.gaussian() * config.jitterMs * 1.0e-3;
+        else if (config.jitter == Jitter::Exponential)
+            jitterSeconds = random.exponential() * config.jitterMs * 1.0e-3;
+
+        const double due = offset + static_cast<double>(index) * period + jitterSeconds;
+        nextTime = std::max({due, notBefore, lastTime});
+        lastTime = nextTime;
+    }
+
+    Random random;
+    double period;
+    double offset;
+    int64_t index = 0;
+    double nextTime = 0.0;
+    double lastTime = 0.0;
+};
+
+struct Result
+{
+    bool passed = true;
+    double convergenceSeconds = -1.0; // first time the level is in band
+    double longestExcursion = 0.0;    // longest spell out of band after that
+    uint64_t underflows = 0;
+    int discontinuities = 0;
+    double driftPpm = 0.0;
+    double expectedPpm = 0.0;
+    int minLevel = 0;
+    int maxLevel = 0;
+    int targetLevel = 0;
+};
+
+double g_simulatedTime = 0.0;
+
+double simulatedClock(void*)
+{
+    return g_simulatedTime;
+}
+
+Result run(const Scenario& scenario, std::FILE* trace)
+{
+    SyncBuffer buffer(scenario.name);
+    buffer.setInterpolationType(scenario.interpolation);
+    buffer.setAdaptiveTargetEnabled(scenario.adaptive);
+    buffer.setClock(&simulatedClock, nullptr);
+
+    std::shared_ptr<atk::BroadcastFifo> source;
+    if (scenario.sharedSource)
+    {
+        source = std::make_shared<atk::BroadcastFifo>(2, FIXED_BUFFER_SIZE);
+        source->setClock(&simulatedClock, nullptr);
+        buffer.setSource(source, {1});
+    }
+
+    SimulatedDevice writer(scenario.writer, 1, 0.0);
+    SimulatedDevice reader(scenario.reader, 2, 0.37 * scenario.reader.blockSize / scenario.reader.nominalRate);
+
+    // A 50 Hz sine at the writer's rate; phase continuity at the reader exposes drops and repeats
+    constexpr double kToneHz = 50.0;
+    constexpr float kAmplitude = 0.5f;
+    const double maxStep = kTwoPi * kToneHz / scenario.reader.nominalRate * kAmplitude;
+    const float discontinuityThreshold = static_cast<float>(4.0 * maxStep + 1.0e-3);
+
+    std::vector<float> writeBlock(static_cast<size_t>(scenario.writer.blockSize));
+    std::vector<float> silentBlock(static_cast<size_t>(scenario.writer.blockSize));
+    std::vector<float> readBlock(static_cast<size_t>(scenario.reader.blockSize));
+    const float* writePtr = writeBlock.data();
+    const float* sourcePtrs[] = {silentBlock.data(), writeBlock.data()};
+    float* readPtr = readBlock.data();
+    int64_t writerSample = 0;
+
+    // The compensation band SyncBuffer steers the window minimum into
+    const double nominalRatio = scenario.writer.nominalRate / scenario.reader.nominalRate;
+    const double baseLevel = std::ceil(scenario.reader.blockSize * nominalRatio);
+
+    Result result;
+    result.expectedPpm =
+        ((1.0 + scenario.writer.ppm * 1.0e-6) / (1.0 + scenario.reader.ppm * 1.0e-6) - 1.0) * 1.0e6;
+
+    double leftBandAt = -1.0;
+    float lastOutput = 0.0f;
+    bool haveLastOutput = false;
+    uint64_t underflowsAtWarmup = 0;
+    bool warmedUp = false;
+    double nextDropout = scenario.dropoutEverySeconds > 0.0 ? scenario.dropoutEverySeconds : 1.0e300;
+    double stallUntil = 0.0;
+
+    while (true)
+    {
+        const bool writerFirst = writer.getNextTime() <= reader.getNextTime();
+        g_simulatedTime = writerFirst ? writer.getNextTime() : reader.getNextTime();
+        if (g_simulatedTime >= scenario.seconds)
+            break;
+
+        if (writerFirst)
+        {
+            for (auto& sample : writeBlock)
+                sample = kAmplitude
+                       * static_cast<float>(std::sin(kTwoPi * kToneHz * static_cast<double>(writerSample++)
+                                                     / scenario.writer.nominalRate));
+            if (source)
+                source->write(sourcePtrs, 2, scenario.writer.blockSize, scenario.writer.nominalRate);
+            else
+                buffer.write(&writePtr, 1, scenario.writer.blockSize, scenario.writer.nominalRate);
+
+            if (g_simulatedTime >= nextDropout)
+            {
+                stallUntil = g_simulatedTime + scenario.dropoutMs * 1.0e-3;
+                nextDropout += scenario.dropoutEverySeconds;
+            }
+            writer.advance(stallUntil);
+            continue;
+        }
+
+        const bool ok = buffer.read(&readPtr, 1, scenario.reader.blockSize, scenario.reader.nominalRate);
+        reader.advance(0.0);
+
+        if (!warmedUp && g_simulatedTime >= scenario.warmupSeconds)
+        {
+            warmedUp = true;
+            underflowsAtWarmup = buffer.getStats().underflows;
+            haveLastOutput = false;
+        }
+
+        const auto stats = buffer.getStats();
+
+        if (warmedUp && ok)
+        {
+            for (const float sample : readBlock)
+            {
+                if (haveLastOutput && std::abs(sample - lastOutput) > discontinuityThreshold)
+                    ++result.discontinuities;
+                lastOutput = sample;
+                haveLastOutput = true;
+            }
+        }
+        else
+        {
+            haveLastOutput = false;
+        }
+
+        // Same band as SyncBuffer: target +/- hysteresis, hysteresis capped in adaptive mode. The
+        // level only moves in whole writer blocks, so the minimum may overshoot the top of the band
+        // by up to one block before compensation notices.
+        const double factor = buffer.getTargetLevelFactorInUse();
+        const double hysteresis = std::min<double>(buffer.getHysteresis(), scenario.adaptive ? factor - 1.0 : 1.0e9);
+        const double tolerance = baseLevel * hysteresis + 1.0;
+        const int worstLevel = std::min(stats.minLevel, stats.maxLevel - scenario.writer.blockSize);
+        const double offset = worstLevel - stats.targetLevel;
+        const bool inBand =
+            stats.targetLevel > 0 && offset >= -tolerance && offset <= tolerance + scenario.writer.blockSize;
+        if (inBand && result.convergenceSeconds < 0.0)
+            result.convergenceSeconds = g_simulatedTime;
+        else if (inBand && leftBandAt >= 0.0)
+        {
+            result.longestExcursion = std::max(result.longestExcursion, g_simulatedTime - leftBandAt);
+            leftBandAt = -1.0;
+        }
+        else if (!inBand && result.convergenceSeconds >= 0.0 && leftBandAt < 0.0)
+            leftBandAt = g_simulatedTime;
+
+        if (trace != nullptr)
+            std::fprintf(
+                trace,
+                "%s,%.6f,%d,%d,%d,%d,%.8f,%.2f,%llu\n",
+                scenario.name,
+                g_simulatedTime,
+                stats.currentLevel,
+                stats.minLevel,
+                stats.maxLevel,
+                stats.targetLevel,
+                stats.appliedRatio,
+                stats.driftPpm,
+                static_cast<unsigned long long>(stats.underflows)
+            );
+    }
+
+    const auto stats = buffer.getStats();
+    result.underflows = stats.underflows - underflowsAtWarmup;
+    result.driftPpm = stats.driftPpm;
+    result.minLevel = stats.minLevel;
+    result.maxLevel = stats.maxLevel;
+    result.targetLevel = stats.targetLevel;
+    if (leftBandAt >= 0.0)
+        result.longestExcursion = std::max(result.longestExcursion, scenario.seconds - leftBandAt);
+
+    // Timing-based, so the error shrinks with run length; jitter at the end points remains
+    const double driftTolerance = 2.0 + 0.02 * std::abs(result.expectedPpm);
+
+    result.passed = result.convergenceSeconds >= 0.0
+                 && result.convergenceSeconds <= scenario.maxConvergenceSeconds
+                 && result.longestExcursion <= scenario.maxConvergenceSeconds
+                 && result.underflows == 0
+                 && result.discontinuities == 0
+                 && std::abs(result.driftPpm - result.expectedPpm) <= driftTolerance;
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const char* only = argc > 1 && std::strcmp(argv[1], "all") != 0 ? argv[1] : nullptr;
+    std::FILE* trace = argc > 2 ? std::fopen(argv[2], "w") : nullptr;
+    if (trace != nullptr)
+        std::fprintf(trace, "scenario,time,level,min,max,target,ratio,drift_ppm,underflows\n");
+
+    std::printf(
+        "%-18s %10s %10s %9s %9s %7s %7s %7s %10s %6s\n",
+        "scenario",
+        "converged",
+        "excursion",
+        "drift",
+        "expected",
+        "min",
+        "max",
+        "target",
+        "underflows",
+        "result"
+    );
+
+    int failures = 0;
+    int ran = 0;
+    for (const auto& scenario : kScenarios)
+    {
+        if (only != nullptr && std::strcmp(only, scenario.name) != 0)
+            continue;
+
+        ++ran;
+        const auto result = run(scenario, trace);
+        if (!result.passed)
+            ++failures;
+
+        std::printf(
+            "%-18s %9.1fs %9.1fs %8.1f %9.1f %7d %7d %7d %10llu %6s",
+            scenario.name,
+            result.convergenceSeconds,
+            result.longestExcursion,
+            result.driftPpm,
+            result.expectedPpm,
+            result.minLevel,
+            result.maxLevel,
+            result.targetLevel,
+            static_cast<unsigned long long>(result.underflows),
+            result.passed ? "OK" : "FAILED"
+        );
+        if (result.discontinuities > 0)
+            std::printf("  (%d discontinuities)", result.discontinuities);
+        std::printf("\n");
+    }
+
+    if (trace != nullptr)
+        std::fclose(trace);
+
+    if (ran == 0)
+    {
+        std::fprintf(stderr, "unknown scenario: %s\n", only);
+        return 2;
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -37,6 +37,53 @@ static juce::File getFallbackSettingsFile(const juce::String& name)
     return opts.getDefaultFile();
 }
 
+static juce::String getCurrentSceneCollectionName()
+{
+    char* name = obs_frontend_get_current_scene_collection();
+    juce::String result = juce::String::fromUTF8(name != nullptr ? name : "");
+    bfree(name);
+    return result;
+}
+
+// Collection being switched away from; empty when no switch is in progress
+static juce::String g_outgoingSceneCollection;
+
+// Keeps AudioServer's devices open across scene collection switches, and opens the incoming
+// collection's devices while the outgoing one's sources are being destroyed
+static void sceneCollectionEventCallback(enum obs_frontend_event event, void* private_data)
+{
+    juce::ignoreUnused(private_data);
+
+    auto* audioServer = atk::AudioServer::getInstanceWithoutCreating();
+    if (audioServer == nullptr)
+        return;
+
+    switch (event)
+    {
+    case OBS_FRONTEND_EVENT_SCENE_COLLECTION_CHANGING:
+        g_outgoingSceneCollection = getCurrentSceneCollectionName();
+        audioServer->beginSceneCollectionSwitch(g_outgoingSceneCollection);
+        break;
+    case OBS_FRONTEND_EVENT_SCENE_COLLECTION_CLEANUP:
+        // By now OBS reports the incoming collection as current; if it still reports the
+        // outgoing one, there is nothing to preopen and the hold alone keeps devices open
+        if (g_outgoingSceneCollection.isNotEmpty())
+        {
+            auto incoming = getCurrentSceneCollectionName();
+            if (incoming != g_outgoingSceneCollection)
+                audioServer->preopenSceneCollectionDevices(incoming);
+        }
+        break;
+    case OBS_FRONTEND_EVENT_SCENE_COLLECTION_CHANGED:
+    case OBS_FRONTEND_EVENT_EXIT:
+        g_outgoingSceneCollection.clear();
+        audioServer->endSceneCollectionSwitch();
+        break;
+    default:
+        break;
+    }
+}
+
 juce::File atk::getSettingsFile(const juce::String& name)
 {
     auto* module = obs_current_module();
@@ -81,6 +128,7 @@ bool atk::create()
     // Initialize Audio server
     if (auto* audioServer = atk::AudioServer::getInstance())
         audioServer->initialize();
+    obs_frontend_add_event_callback(sceneCollectionEventCallback, nullptr);
 
     // Initialize RealtimeThreadPool synchronously so it's ready when filters are created
     if (auto* threadPool = atk::RealtimeThreadPool::getInstance())
@@ -132,6 +180,9 @@ void atk::destroy()
         atk::MidiServer::deleteInstance();
     }
 
+    obs_frontend_remove_event_callback(sceneCollectionEventCallback, nullptr);
+    g_outgoingSceneCollection.clear();
+
     if (auto* audioServer = atk::AudioServer::getInstance())
     {
         audioServer->shutdown();
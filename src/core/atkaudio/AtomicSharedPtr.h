@@ -1,26 +1,32 @@
 #pragma once
 
 #include <atomic>
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 namespace atk
 {
 
 // Atomic shared_ptr wrapper compatible with Apple libc++ (which lacks std::atomic<shared_ptr>).
-// Uses a spinlock for synchronization - safe for infrequent updates from UI thread
-// with frequent reads from audio thread.
+// Epoch-based (RCU-style): the current value lives in a heap slot that readers copy from inside
+// a read-side critical section; writers swap the slot and wait out a grace period before touching
+// the old one.
 //
 // THREAD SAFETY:
 // - All operations are thread-safe
-// - Readers spin briefly if a write is in progress (nanoseconds)
+// - load() is wait-free: an epoch read, two counter updates and one shared_ptr copy, no loops.
+//   Readers never wait for a writer, even one that is preempted mid-store
+// - Writers serialize on a mutex and block until readers already inside load() have left
 //
 // DESTRUCTION SAFETY:
-// - Old values are held by the writer until the next store()
+// - Old values are held by the writer until no reader copy is left
 // - This ensures destruction happens on the writer thread, not reader
 //
 // USAGE CONTRACT:
-// - Writers should be infrequent (UI thread updates)
+// - Writers should be infrequent (UI thread updates) and must not run on the audio thread
 // - Readers can be frequent (audio thread)
 //
 // NOTE: memory_order parameters are accepted for API compatibility but ignored.
@@ -29,19 +35,18 @@ class AtomicSharedPtr
 {
 public:
     AtomicSharedPtr()
-        : spinlock(new std::atomic<bool>(false))
+        : current(new std::shared_ptr<T>())
     {
     }
 
     explicit AtomicSharedPtr(std::shared_ptr<T> p)
-        : ptr(std::move(p))
-        , spinlock(new std::atomic<bool>(false))
+        : current(new std::shared_ptr<T>(std::move(p)))
     {
     }
 
     ~AtomicSharedPtr()
     {
-        delete spinlock;
+        delete current.load(std::memory_order_relaxed);
     }
 
     // Non-copyable and non-movable
@@ -52,61 +57,80 @@ public:
 
     std::shared_ptr<T> load([[maybe_unused]] std::memory_order order = std::memory_order_acquire) const
     {
-        lock();
-        auto result = ptr;
-        unlock();
+        // A reader that saw a stale epoch just counts against the other parity; writers wait on
+        // both, so it is still covered
+        auto& readers = activeReaders[epoch.load(std::memory_order_seq_cst) & 1];
+        readers.fetch_add(1, std::memory_order_seq_cst);
+        auto result = *current.load(std::memory_order_seq_cst);
+        readers.fetch_sub(1, std::memory_order_release);
         return result;
     }
 
     void store(std::shared_ptr<T> desired, [[maybe_unused]] std::memory_order order = std::memory_order_release)
     {
-        (void)exchange(std::move(desired));
+        std::lock_guard<std::mutex> lock(writeMutex);
+        swap(std::move(desired));
+        releaseUnused();
     }
 
     [[nodiscard]] std::shared_ptr<T>
     exchange(std::shared_ptr<T> desired, [[maybe_unused]] std::memory_order order = std::memory_order_acq_rel)
     {
-        lock();
-        auto old = std::move(ptr);
-        ptr = std::move(desired);
-        unlock();
+        std::lock_guard<std::mutex> lock(writeMutex);
+        auto old = swap(std::move(desired));
+        releaseUnused();
+        return old;
+    }
+
+private:
+    // Returns the previous value, which is also retained
+    std::shared_ptr<T> swap(std::shared_ptr<T> desired)
+    {
+        auto* oldSlot = current.exchange(new std::shared_ptr<T>(std::move(desired)), std::memory_order_seq_cst);
+        waitForReaders();
+
+        // No reader can reach the old slot any more, but copies taken from it may still be alive
+        auto old = std::move(*oldSlot);
+        delete oldSlot;
 
         // Keep old values alive to ensure destruction happens here (writer thread),
         // not when reader's copy goes out of scope.
         if (old)
-            retained.push_back(std::move(old));
+            retained.push_back(old);
+        return old;
+    }
 
-        // Remove entries where we're the sole owner (refcount == 1)
-        // Safe to delete - no readers have copies
+    // Remove entries where we're the sole owner (refcount == 1)
+    // Safe to delete - no readers have copies, and none can take a new one
+    void releaseUnused()
+    {
         auto it = retained.begin();
         while (it != retained.end())
             if (it->use_count() == 1)
                 it = retained.erase(it);
             else
                 ++it;
-
-        return retained.empty() ? nullptr : retained.back();
     }
 
-private:
-    void lock() const
+    // Grace period. Any reader that loaded the old slot incremented one of the two counters before
+    // the swap. Flipping the epoch sends new readers to the other counter, so the old one drains;
+    // doing it twice drains both, whichever parity each straggler picked.
+    void waitForReaders()
     {
-        bool expected = false;
-        while (!spinlock->compare_exchange_weak(expected, true, std::memory_order_acquire))
+        for (int flip = 0; flip < 2; ++flip)
         {
-            expected = false;
-            while (spinlock->load(std::memory_order_relaxed))
-                ;
+            const auto previous = epoch.fetch_add(1, std::memory_order_seq_cst);
+            const auto& readers = activeReaders[previous & 1];
+            while (readers.load(std::memory_order_seq_cst) != 0)
+                std::this_thread::yield();
         }
     }
 
-    void unlock() const
-    {
-        spinlock->store(false, std::memory_order_release);
-    }
+    std::atomic<std::shared_ptr<T>*> current;
+    std::atomic<uint64_t> epoch{0};
+    mutable std::atomic<int> activeReaders[2]{};
 
-    std::shared_ptr<T> ptr;
-    std::atomic<bool>* spinlock;
+    std::mutex writeMutex;
 
     // Prevent destruction on reader thread by keeping old values alive
     std::vector<std::shared_ptr<T>> retained;
@@ -1,6 +1,7 @@
 #include "AudioProcessorGraphMT.h"
 
 #include <atkaudio/Logging.h>
+#include "../RealtimeMemory.h"
 #include "SubgraphExtractor.h"
 #include "RealtimeThreadPool.h"
 #include "DependencyTaskGraph.h"
@@ -1984,14 +1985,30 @@ public:
         {
             audioBuffer.setSize(CHAIN_MAX_CHANNELS, blockSize, false, false, true);
             midiBuffer.ensureSize(blockSize);
+            lockMemory();
         }
 
         void resize(int blockSize)
         {
+            lockedAudio.release();
             audioBuffer.setSize(CHAIN_MAX_CHANNELS, blockSize, false, false, true);
             audioBuffer.clear();
             midiBuffer.ensureSize(blockSize);
+            lockMemory();
         }
+
+    private:
+        // AudioBuffer keeps all channels in one allocation, so a single region covers them
+        void lockMemory()
+        {
+            if (audioBuffer.getNumSamples() > 0)
+                lockedAudio.lock(
+                    audioBuffer.getWritePointer(0),
+                    sizeof(float) * static_cast<size_t>(audioBuffer.getNumChannels() * audioBuffer.getNumSamples())
+                );
+        }
+
+        rtmemory::LockedRegion lockedAudio;
     };
 
     std::shared_ptr<PooledBuffer> acquireBuffer(int blockSize)
@@ -2090,6 +2107,7 @@ public:
                 );
                 it->second->delayLine.reset();
                 it->second->delayLine.setMaximumDelayInSamples(MAX_DELAY_SAMPLES);
+                prefaultDelayLine(*it->second, numChannels);
                 it->second->preparedChannels = numChannels;
             }
             it->second->delayAmount.store(delayNeeded);
@@ -2100,6 +2118,7 @@ public:
         pooledLine->delayLine.prepare(juce::dsp::ProcessSpec{sampleRate, blockSize, static_cast<uint32>(numChannels)});
         pooledLine->delayLine.reset();
         pooledLine->delayLine.setMaximumDelayInSamples(MAX_DELAY_SAMPLES);
+        prefaultDelayLine(*pooledLine, numChannels);
         pooledLine->delayAmount.store(delayNeeded);
         pooledLine->preparedChannels = numChannels;
         delayLines[key] = pooledLine;
@@ -2121,6 +2140,21 @@ public:
     }
 
 private:
+    // juce::dsp::DelayLine keeps its storage private, so it can't be mlocked. When realtime memory locking
+    // is enabled, writing one full revolution of zeros maps every page here instead of on the audio thread.
+    static void prefaultDelayLine(PooledDelayLine& line, int numChannels)
+    {
+        if (!rtmemory::isLockingEnabled())
+            return;
+
+        const int ringSize = line.delayLine.getMaximumDelayInSamples() + 2;
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < ringSize; ++i)
+                line.delayLine.pushSample(ch, 0.0f);
+
+        line.delayLine.reset();
+    }
+
     std::unordered_map<DelayLineKey, std::shared_ptr<PooledDelayLine>, DelayLineKeyHash> delayLines;
 };
 
@@ -2506,6 +2540,7 @@ public:
         DelayLinePool& delayPool
     )
         : settings(s)
+        , owner(graph)
         , nodes(n)
         , bufferPool(pool)
         , delayLinePool(delayPool)
@@ -3024,6 +3059,9 @@ public:
 
             cachedNumSamples = numSamples;
 
+            taskGraph.setPriority(owner.getSchedulingPriority());
+            taskGraph.setMaxWorkers(owner.getMaxWorkers());
+
             // Execute all chains respecting dependencies
             // Input routing happens inside each task before processing
             pool->executeDependencyGraph(&taskGraph);
@@ -3163,7 +3201,8 @@ private:
     }
 
     PrepareSettings settings;
-    const Nodes& nodes; // Reference to graph nodes for latency checking
+    AudioProcessorGraphMT& owner; // Supplies the pool scheduling settings
+    const Nodes& nodes;           // Reference to graph nodes for latency checking
     std::vector<std::unique_ptr<ChainRenderSequence>> chains;
     std::vector<std::vector<ChainRenderSequence*>> chainsByLevel;
     int maxTopologicalLevel = 0;
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "DependencyTaskGraph.h"
+
 #include <juce_audio_utils/juce_audio_utils.h>
 
 namespace atk
@@ -397,6 +399,35 @@ public:
     */
     void rebuild();
 
+    //==============================================================================
+    /** Sets how this graph competes with other graphs for the shared realtime thread pool.
+
+        Critical graphs never wait for another graph: while the pool is busy, its workers switch
+        to a Critical graph as soon as they finish their current task. Normal graphs are admitted
+        before Background ones.
+        Takes effect from the next processed block.
+    */
+    void setSchedulingPriority(TaskGraphPriority newPriority) noexcept
+    {
+        schedulingPriority.store(newPriority, std::memory_order_relaxed);
+    }
+
+    TaskGraphPriority getSchedulingPriority() const noexcept
+    {
+        return schedulingPriority.load(std::memory_order_relaxed);
+    }
+
+    /** Limits how many pool workers may process this graph at once; 0 means no limit. */
+    void setMaxWorkers(int newMaxWorkers) noexcept
+    {
+        maxWorkers.store(juce::jmax(0, newMaxWorkers), std::memory_order_relaxed);
+    }
+
+    int getMaxWorkers() const noexcept
+    {
+        return maxWorkers.load(std::memory_order_relaxed);
+    }
+
     //==============================================================================
     /** A special type of AudioProcessor that can live inside an AudioProcessorGraphMT
         in order to use the audio that comes into and out of the graph itself.
@@ -542,6 +573,9 @@ private:
     class Pimpl;
     std::unique_ptr<Pimpl> pimpl;
 
+    std::atomic<TaskGraphPriority> schedulingPriority{TaskGraphPriority::Normal};
+    std::atomic<int> maxWorkers{0};
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioProcessorGraphMT)
 };
 
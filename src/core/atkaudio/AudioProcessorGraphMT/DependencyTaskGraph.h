@@ -5,6 +5,8 @@
 // - Lock-free MPMC queue for task scheduling
 // - Dynamic preferred child: heaviest ready child executes on same thread
 // - EMA-smoothed execution times for chain selection
+// - Ready-width tracking so the pool wakes only as many workers as there are ready tasks
+// - Per-graph priority class and worker cap, enforced by RealtimeThreadPool
 
 #pragma once
 
@@ -109,6 +111,15 @@ private:
     alignas(64) Slot slots[Capacity];
 };
 
+//==============================================================================
+// Scheduling class of a graph in the shared pool
+enum class TaskGraphPriority
+{
+    Critical,  // never queues behind another graph; takes the pool's workers from it between tasks
+    Normal,    // admitted before Background graphs
+    Background
+};
+
 //==============================================================================
 struct TaskNode
 {
@@ -142,7 +153,8 @@ class DependencyTaskGraph
     static constexpr double kReleaseCoeff = 1.0 - (1.0 / 1024.0); // ~1024 samples to decay
 
 public:
-    using WakeCallback = void (*)();
+    // Called with the number of tasks that just became ready
+    using WakeCallback = void (*)(int numReady);
 
     DependencyTaskGraph() = default;
 
@@ -169,6 +181,50 @@ public:
         wakeCallback = callback;
     }
 
+    void setPriority(TaskGraphPriority newPriority)
+    {
+        priority.store(newPriority, std::memory_order_relaxed);
+    }
+
+    TaskGraphPriority getPriority() const
+    {
+        return priority.load(std::memory_order_relaxed);
+    }
+
+    // Maximum number of pool workers that may run this graph's tasks at once (0 = no limit)
+    void setMaxWorkers(int newMaxWorkers)
+    {
+        maxWorkers.store((std::max)(0, newMaxWorkers), std::memory_order_relaxed);
+    }
+
+    int getMaxWorkers() const
+    {
+        return maxWorkers.load(std::memory_order_relaxed);
+    }
+
+    // Incremented by every prepare(); lets workers tell runs of the same graph apart
+    uint32_t getRunEpoch() const
+    {
+        return runEpoch.load(std::memory_order_acquire);
+    }
+
+    // Claims one of the graph's worker slots for the current run
+    bool tryJoinWorker()
+    {
+        const int cap = maxWorkers.load(std::memory_order_relaxed);
+        int current = participants.load(std::memory_order_relaxed);
+        while (cap <= 0 || current < cap)
+            if (participants.compare_exchange_weak(current, current + 1, std::memory_order_relaxed))
+                return true;
+        return false;
+    }
+
+    bool canAcceptWorker() const
+    {
+        const int cap = maxWorkers.load(std::memory_order_relaxed);
+        return cap <= 0 || participants.load(std::memory_order_relaxed) < cap;
+    }
+
     size_t addTask(void* userData, void (*execute)(void*), int dependencyCount = 0)
     {
         size_t index = tasks.size();
@@ -199,12 +255,35 @@ public:
         totalTasks = tasks.size();
 
         // Reset all tasks and push roots to ready queue
+        int numRoots = 0;
         for (size_t i = 0; i < tasks.size(); ++i)
         {
             tasks[i]->reset();
             if (tasks[i]->initialDependencyCount == 0)
+            {
                 readyQueue.tryPush(i);
+                ++numRoots;
+            }
         }
+
+        initialReadyCount = numRoots;
+        inFlightTasks.store(numRoots, std::memory_order_relaxed);
+        peakInFlightTasks.store(numRoots, std::memory_order_relaxed);
+        participants.store(0, std::memory_order_relaxed);
+        runEpoch.fetch_add(1, std::memory_order_release);
+    }
+
+    // Number of root tasks queued by the last prepare()
+    int getInitialReadyCount() const
+    {
+        return initialReadyCount;
+    }
+
+    // Largest number of tasks that were ready or running at the same time during the last run.
+    // Independent of how many workers actually took part.
+    int getPeakReadyWidth() const
+    {
+        return peakInFlightTasks.load(std::memory_order_acquire);
     }
 
     void waitUntilDone()
@@ -275,7 +354,7 @@ private:
         // // Collect all ready dependents and find the heaviest one
         // size_t heaviestReadyIndex = SIZE_MAX;
         // int64_t heaviestWeight = -1;
-        bool pushedToQueue = false;
+        int numPushed = 0;
 
         for (size_t depIndex : task.dependentIndices)
         {
@@ -299,14 +378,25 @@ private:
                 //     {
                 // Not the heaviest, push to shared queue
                 readyQueue.tryPush(depIndex);
-                pushedToQueue = true;
+                ++numPushed;
                 //     }
             }
         }
 
+        // This task leaves the in-flight set as its ready dependents join it
+        if (numPushed != 1)
+        {
+            const int inFlight = inFlightTasks.fetch_add(numPushed - 1, std::memory_order_relaxed) + numPushed - 1;
+            int peak = peakInFlightTasks.load(std::memory_order_relaxed);
+            while (inFlight > peak
+                   && !peakInFlightTasks.compare_exchange_weak(peak, inFlight, std::memory_order_relaxed))
+            {
+            }
+        }
+
         // Wake workers if we pushed any tasks to the queue
-        if (pushedToQueue && wakeCallback)
-            wakeCallback();
+        if (numPushed > 0 && wakeCallback)
+            wakeCallback(numPushed);
 
         // mark this task as completed
         if (completedCount.fetch_add(1, std::memory_order_acq_rel) + 1 >= totalTasks)
@@ -327,6 +417,15 @@ private:
     size_t totalTasks = 0;
     std::atomic<bool> waitFlag{false};
     WakeCallback wakeCallback = nullptr;
+
+    int initialReadyCount = 0;
+    std::atomic<int> inFlightTasks{0};
+    std::atomic<int> peakInFlightTasks{0};
+
+    std::atomic<TaskGraphPriority> priority{TaskGraphPriority::Normal};
+    std::atomic<int> maxWorkers{0};
+    std::atomic<int> participants{0};
+    std::atomic<uint32_t> runEpoch{0};
 };
 
 } // namespace atk
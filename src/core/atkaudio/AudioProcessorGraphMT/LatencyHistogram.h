@@ -0,0 +1,104 @@
+// Copyright (c) 2025 atkAudio
+// Lock-free log-linear latency histogram (4 sub-buckets per octave) for realtime statistics
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+
+namespace atk
+{
+
+class LatencyHistogram
+{
+public:
+    static constexpr int kSubBucketBits = 2;
+    static constexpr int kSubBuckets = 1 << kSubBucketBits;
+    static constexpr int kNumBuckets = 64 * kSubBuckets;
+
+    // Safe to call concurrently from any thread; all counters are relaxed.
+    void record(int64_t nanoseconds) noexcept
+    {
+        if (nanoseconds < 0)
+            nanoseconds = 0;
+
+        buckets[bucketFor(static_cast<uint64_t>(nanoseconds))].fetch_add(1, std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_relaxed);
+
+        int64_t previousMax = maxValue.load(std::memory_order_relaxed);
+        while (nanoseconds > previousMax
+               && !maxValue.compare_exchange_weak(previousMax, nanoseconds, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    // Upper bound of the bucket containing the given percentile (0..100), or 0 if empty.
+    int64_t getPercentile(double percentile) const noexcept
+    {
+        const uint64_t total = count.load(std::memory_order_relaxed);
+        if (total == 0)
+            return 0;
+
+        const auto rank = static_cast<uint64_t>(percentile / 100.0 * static_cast<double>(total - 1)) + 1;
+        uint64_t seen = 0;
+        for (int i = 0; i < kNumBuckets; ++i)
+        {
+            seen += buckets[i].load(std::memory_order_relaxed);
+            if (seen >= rank)
+            {
+                const auto upper = static_cast<int64_t>(bucketUpperBound(i));
+                const auto max = getMax();
+                return upper < max ? upper : max;
+            }
+        }
+        return getMax();
+    }
+
+    uint64_t getCount() const noexcept
+    {
+        return count.load(std::memory_order_relaxed);
+    }
+
+    int64_t getMax() const noexcept
+    {
+        return maxValue.load(std::memory_order_relaxed);
+    }
+
+    void reset() noexcept
+    {
+        for (auto& bucket : buckets)
+            bucket.store(0, std::memory_order_relaxed);
+        count.store(0, std::memory_order_relaxed);
+        maxValue.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    static int bucketFor(uint64_t value) noexcept
+    {
+        if (value < kSubBuckets)
+            return static_cast<int>(value);
+
+        const int octave = 63 - std::countl_zero(value);
+        const auto sub = static_cast<int>((value >> (octave - kSubBucketBits)) & (kSubBuckets - 1));
+        return (octave - kSubBucketBits + 1) * kSubBuckets + sub;
+    }
+
+    static uint64_t bucketUpperBound(int bucket) noexcept
+    {
+        if (bucket < kSubBuckets)
+            return static_cast<uint64_t>(bucket);
+
+        const int octave = bucket / kSubBuckets + kSubBucketBits - 1;
+        const auto sub = static_cast<uint64_t>(bucket % kSubBuckets);
+        const int shift = octave - kSubBucketBits;
+        return ((kSubBuckets + sub + 1) << shift) - 1;
+    }
+
+    std::array<std::atomic<uint64_t>, kNumBuckets> buckets{};
+    std::atomic<uint64_t> count{0};
+    std::atomic<int64_t> maxValue{0};
+};
+
+} // namespace atk
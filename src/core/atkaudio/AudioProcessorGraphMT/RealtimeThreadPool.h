@@ -3,14 +3,18 @@
 #pragma once
 
 #include "../CpuInfo.h"
+#include "../Denormals.h"
+#include "../RealtimeMemory.h"
 #include <atkaudio/Logging.h>
 #include "../RealtimeThread.h"
 #include "DependencyTaskGraph.h"
+#include "LatencyHistogram.h"
 
 #include <juce_core/juce_core.h>
 
 #include <algorithm>
 #include <atomic>
+#include <cmath>
 #include <memory>
 #include <mutex>
 #include <thread>
@@ -126,12 +130,50 @@ private:
 /**
     Realtime thread pool for parallel task execution.
     Supports both fire-and-forget tasks and dependency graph execution.
+
+    Only idle workers are woken, and only as many as there are ready tasks. Graph work is further
+    limited to an active set sized from the ready width measured across recent graphs: it grows
+    immediately when a wider graph arrives and shrinks slowly once the width drops.
+
+    Idle workers park in the kernel. The pool learns each graph's submission period and workers
+    wake shortly before the next expected block, spinning only inside a jitter-sized window
+    around it (or while a graph is in flight).
+
+    Graphs run one at a time. Waiting Normal graphs are admitted before Background ones. A
+    Critical graph that finds the pool busy doesn't queue either: it takes a separate slot that
+    workers check at every task boundary, so they leave the running graph for it as soon as their
+    current task is done, and its caller runs its tasks too. A graph's worker cap limits how many
+    workers join each run.
 */
 class RealtimeThreadPool
 {
 public:
     static constexpr int kMaxWorkers = 32;
 
+    // Per-graph decay of the measured parallelism (~512 graph runs to settle)
+    static constexpr double kParallelismRelease = 1.0 - (1.0 / 512.0);
+
+    // Block arrival prediction
+    static constexpr int kMaxTrackedGraphs = 16;
+    static constexpr int64_t kMinPeriodNs = 250'000;
+    static constexpr int64_t kMaxPeriodNs = 200'000'000;
+    static constexpr int64_t kMinSpinWindowNs = 100'000;
+    static constexpr int64_t kMaxSpinWindowNs = 1'000'000;
+    static constexpr int kStalePeriods = 4;
+    static constexpr int64_t kNoArrival = INT64_MAX;
+
+    struct IdleStats
+    {
+        double spinFraction = 0.0;   // worker time burnt spinning while idle
+        double parkedFraction = 0.0; // worker time blocked in the kernel
+        double busyFraction = 0.0;   // worker time running tasks
+        uint64_t wakeCount = 0;
+        int64_t wakeLatencyP50Ns = 0;
+        int64_t wakeLatencyP90Ns = 0;
+        int64_t wakeLatencyP99Ns = 0;
+        int64_t wakeLatencyMaxNs = 0;
+    };
+
     static RealtimeThreadPool* getInstance()
     {
         if (!instance)
@@ -178,6 +220,9 @@ public:
         for (auto& w : workers)
             w->waitUntilStarted();
 
+        parallelismEnvelope = static_cast<double>(numWorkers);
+        activeWorkers.store(numWorkers, std::memory_order_relaxed);
+
         initialized.store(true, std::memory_order_release);
     }
 
@@ -188,6 +233,20 @@ public:
 
         initialized.store(false, std::memory_order_release);
 
+        const auto stats = getIdleStats();
+        atk::logging::info(
+            "RealtimeThreadPool::shutdown",
+            juce::String::formatted(
+                "idle spin %.1f%%, parked %.1f%%, busy %.1f%%; wake latency p50 %.1f us, p99 %.1f us, max %.1f us",
+                stats.spinFraction * 100.0,
+                stats.parkedFraction * 100.0,
+                stats.busyFraction * 100.0,
+                stats.wakeLatencyP50Ns / 1000.0,
+                stats.wakeLatencyP99Ns / 1000.0,
+                stats.wakeLatencyMaxNs / 1000.0
+            )
+        );
+
         // Workers handle their own cleanup in destructor
         workers.clear();
 
@@ -204,7 +263,95 @@ public:
         return static_cast<int>(workers.size());
     }
 
-    // Submit a fire-and-forget task (wakes all workers to compete)
+    // Workers currently allowed to take part in graph execution
+    int getNumActiveWorkers() const
+    {
+        return activeWorkers.load(std::memory_order_relaxed);
+    }
+
+    // Decaying peak of the ready width over recently executed graphs
+    double getMeasuredParallelism() const
+    {
+        return measuredParallelism.load(std::memory_order_relaxed);
+    }
+
+    IdleStats getIdleStats() const
+    {
+        IdleStats stats;
+        int64_t spin = 0;
+        int64_t parked = 0;
+        int64_t busy = 0;
+        for (const auto& w : workers)
+        {
+            if (!w)
+                continue;
+            spin += w->spinNs.load(std::memory_order_relaxed);
+            parked += w->parkedNs.load(std::memory_order_relaxed);
+            busy += w->busyNs.load(std::memory_order_relaxed);
+        }
+
+        if (const auto total = static_cast<double>(spin + parked + busy); total > 0.0)
+        {
+            stats.spinFraction = spin / total;
+            stats.parkedFraction = parked / total;
+            stats.busyFraction = busy / total;
+        }
+
+        stats.wakeCount = wakeLatency.getCount();
+        stats.wakeLatencyP50Ns = wakeLatency.getPercentile(50.0);
+        stats.wakeLatencyP90Ns = wakeLatency.getPercentile(90.0);
+        stats.wakeLatencyP99Ns = wakeLatency.getPercentile(99.0);
+        stats.wakeLatencyMaxNs = wakeLatency.getMax();
+        return stats;
+    }
+
+    void resetIdleStats()
+    {
+        for (const auto& w : workers)
+        {
+            if (!w)
+                continue;
+            w->spinNs.store(0, std::memory_order_relaxed);
+            w->parkedNs.store(0, std::memory_order_relaxed);
+            w->busyNs.store(0, std::memory_order_relaxed);
+        }
+        wakeLatency.reset();
+    }
+
+    // Earliest predicted block arrival at or after now - window, or kNoArrival if no graph has a
+    // learned period. `window` receives the spin window around it.
+    int64_t predictNextArrival(int64_t now, int64_t& window) const
+    {
+        int64_t next = kNoArrival;
+        int64_t jitter = 0;
+        for (const auto& slot : arrivalSlots)
+        {
+            const int64_t period = slot.periodNs.load(std::memory_order_relaxed);
+            if (period <= 0)
+                continue;
+
+            const int64_t last = slot.lastArrivalNs.load(std::memory_order_relaxed);
+            if (now - last > kStalePeriods * period)
+                continue;
+
+            int64_t arrival = last + period;
+            const int64_t slotJitter = slot.jitterNs.load(std::memory_order_relaxed);
+            const int64_t slotWindow = std::clamp(2 * slotJitter + kMinSpinWindowNs, kMinSpinWindowNs, kMaxSpinWindowNs);
+            if (arrival < now - slotWindow)
+                arrival += ((now - slotWindow - arrival) / period + 1) * period;
+
+            if (arrival < next)
+            {
+                next = arrival;
+                jitter = slotJitter;
+            }
+        }
+
+        window = std::clamp(2 * jitter + kMinSpinWindowNs, kMinSpinWindowNs, kMaxSpinWindowNs);
+        return next;
+    }
+
+    // Submit a fire-and-forget task (wakes one idle worker; busy workers cascade further wake-ups)
     bool submitTask(void (*execute)(void*), void* userData)
     {
         if (!initialized.load(std::memory_order_acquire) || execute == nullptr)
@@ -212,8 +359,7 @@ public:
 
         if (taskQueue.tryPush(execute, userData))
         {
-            // wakeAllWorkers();
-            wakeFirstWorker();
+            wakeIdleWorkers(1, getNumWorkers());
             return true;
         }
         return false;
@@ -231,27 +377,41 @@ public:
         // TODO(atk): taskQueue and executeDependencyGraph are separate paths, but graph submission
         // still uses a single shared currentGraph slot; executeMutex serializes callers to prevent
         // overwrite and waitUntilDone() stalls until a realtime-safe MPSC-style handoff replaces it.
-        std::lock_guard<std::mutex> lock(executeMutex);
+        const int64_t arrivalNs = steadyNowNs();
+        std::unique_lock<std::mutex> lock(executeMutex, std::defer_lock);
+
+        if (!acquireExecution(lock, graph->getPriority()))
+        {
+            executeCritical(graph);
+            return;
+        }
+
+        recordArrival(graph, arrivalNs);
 
         graph->setWakeCallback(
-            []()
+            [](int numReady)
             {
-                if (instance)
-                    instance->wakeAllWorkers();
+                // The worker that readied these tasks picks one up itself
+                if (instance && numReady > 1)
+                    if (auto* running = instance->currentGraph.load(std::memory_order_acquire))
+                        instance->wakeIdleWorkers(numReady - 1, instance->getWorkerLimit(*running));
             }
         );
 
         graph->prepare();
         currentGraph.store(graph, std::memory_order_release);
 
-        // // Wake first worker (cascades to wake others)
-        // wakeFirstWorker();
-        wakeAllWorkers();
+        wakeIdleWorkers(graph->getInitialReadyCount(), getWorkerLimit(*graph));
 
         graph->waitUntilDone();
 
         currentGraph.store(nullptr, std::memory_order_release);
         graph->setWakeCallback(nullptr);
+
+        // A capped graph can't use more workers than its cap, so it shouldn't grow the active set
+        const int cap = graph->getMaxWorkers();
+        const int width = graph->getPeakReadyWidth();
+        updateActiveWorkers(cap > 0 ? (std::min)(width, cap) : width);
     }
 
     bool isCalledFromWorkerThread() const
@@ -271,14 +431,190 @@ public:
                 worker->signal();
     }
 
-    // Wake first worker (cascades to others via wakeNextWorker)
+    // Wake first worker
     void wakeFirstWorker()
     {
         if (!workers.empty() && workers[0])
             workers[0]->signal();
     }
 
+    // Wake up to `count` idle workers among the first `limit`. Lower indices are preferred so the
+    // same cores stay hot and the rest can remain parked. Returns the number woken.
+    int wakeIdleWorkers(int count, int limit)
+    {
+        // Pairs with the fence in Worker::run so a queued task and a parking worker can't miss each other
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        const int n = (std::min)(limit, getNumWorkers());
+        int woken = 0;
+        for (int i = 0; i < n && woken < count; ++i)
+            if (workers[i] && workers[i]->tryWakeIfIdle())
+                ++woken;
+        return woken;
+    }
+
 private:
+    // Called after each graph run (serialized by executeMutex): instant attack, slow release
+    void updateActiveWorkers(int readyWidth)
+    {
+        const double width = static_cast<double>(readyWidth);
+        if (width >= parallelismEnvelope)
+            parallelismEnvelope = width;
+        else
+            parallelismEnvelope = width + (parallelismEnvelope - width) * kParallelismRelease;
+
+        measuredParallelism.store(parallelismEnvelope, std::memory_order_relaxed);
+
+        const int target = std::clamp(static_cast<int>(std::lround(parallelismEnvelope)), 1, getNumWorkers());
+        activeWorkers.store(target, std::memory_order_relaxed);
+    }
+
+    // Critical graphs only try the lock; see executeCritical(). Others wait until no more urgent
+    // graph is queued.
+    bool acquireExecution(std::unique_lock<std::mutex>& lock, TaskGraphPriority priority)
+    {
+        if (priority == TaskGraphPriority::Critical)
+            return lock.try_lock();
+
+        const auto level = static_cast<size_t>(priority);
+        waitingGraphs[level].fetch_add(1, std::memory_order_acq_rel);
+
+        for (int spins = 0;; ++spins)
+        {
+            bool moreUrgentWaiting = false;
+            for (size_t i = 0; i < level; ++i)
+                moreUrgentWaiting |= waitingGraphs[i].load(std::memory_order_acquire) > 0;
+
+            if (!moreUrgentWaiting && lock.try_lock())
+                break;
+
+            if (spins < 64)
+                cpuPause();
+            else
+                std::this_thread::yield();
+        }
+
+        waitingGraphs[level].fetch_sub(1, std::memory_order_acq_rel);
+        return true;
+    }
+
+    // A Critical graph while another graph holds the pool. Workers finish the task they are running
+    // and then prefer this graph; the caller works on it as well, so it never runs slower than it
+    // would on the caller alone. Only one Critical graph at a time takes the slot, any other runs
+    // on its caller's thread.
+    void executeCritical(DependencyTaskGraph* graph)
+    {
+        std::unique_lock<std::mutex> lock(criticalMutex, std::try_to_lock);
+        if (!lock.owns_lock())
+        {
+            executeOnCallingThread(graph);
+            return;
+        }
+
+        graph->setWakeCallback(
+            [](int numReady)
+            {
+                if (instance && numReady > 1)
+                    if (auto* running = instance->criticalGraph.load(std::memory_order_acquire))
+                        instance->wakeIdleWorkers(numReady - 1, instance->getCriticalWorkerLimit(*running));
+            }
+        );
+
+        graph->prepare();
+        criticalGraph.store(graph, std::memory_order_release);
+
+        wakeIdleWorkers(graph->getInitialReadyCount(), getCriticalWorkerLimit(*graph));
+
+        while (!graph->isComplete())
+            if (!graph->tryExecuteOneTask())
+                cpuPause();
+
+        criticalGraph.store(nullptr, std::memory_order_release);
+        graph->setWakeCallback(nullptr);
+    }
+
+    // Runs a graph serially on the caller's thread. Executing in ready-queue order respects every
+    // dependency, and no worker can see the graph because it is never published.
+    static void executeOnCallingThread(DependencyTaskGraph* graph)
+    {
+        graph->prepare();
+        while (graph->tryExecuteOneTask())
+        {
+        }
+    }
+
+    int getWorkerLimit(const DependencyTaskGraph& graph) const
+    {
+        const int active = getNumActiveWorkers();
+        const int cap = graph.getMaxWorkers();
+        return cap > 0 ? (std::min)(active, cap) : active;
+    }
+
+    // The active set is sized for the graphs holding the pool; a Critical graph may take any worker
+    int getCriticalWorkerLimit(const DependencyTaskGraph& graph) const
+    {
+        const int cap = graph.getMaxWorkers();
+        return cap > 0 ? (std::min)(getNumWorkers(), cap) : getNumWorkers();
+    }
+
+    // Called under executeMutex. Learns each graph's submission period and jitter.
+    void recordArrival(const void* key, int64_t now)
+    {
+        ArrivalSlot* slot = nullptr;
+        ArrivalSlot* oldest = &arrivalSlots[0];
+        for (auto& s : arrivalSlots)
+        {
+            if (s.key == key)
+            {
+                slot = &s;
+                break;
+            }
+            if (s.lastArrivalNs.load(std::memory_order_relaxed) < oldest->lastArrivalNs.load(std::memory_order_relaxed))
+                oldest = &s;
+        }
+
+        if (slot == nullptr)
+        {
+            oldest->key = key;
+            oldest->periodNs.store(0, std::memory_order_relaxed);
+            oldest->jitterNs.store(0, std::memory_order_relaxed);
+            oldest->lastArrivalNs.store(now, std::memory_order_relaxed);
+            return;
+        }
+
+        const int64_t interval = now - slot->lastArrivalNs.load(std::memory_order_relaxed);
+        if (interval >= kMinPeriodNs && interval <= kMaxPeriodNs)
+        {
+            int64_t period = slot->periodNs.load(std::memory_order_relaxed);
+            int64_t jitter = slot->jitterNs.load(std::memory_order_relaxed);
+            if (period == 0)
+            {
+                period = interval;
+            }
+            else
+            {
+                const int64_t deviation = interval > period ? interval - period : period - interval;
+                jitter += (deviation - jitter) / 8;
+                period += (interval - period) / 8;
+            }
+            slot->periodNs.store(period, std::memory_order_relaxed);
+            slot->jitterNs.store(jitter, std::memory_order_relaxed);
+        }
+
+        slot->lastArrivalNs.store(now, std::memory_order_relaxed);
+    }
+
+    bool hasPendingWork() const
+    {
+        if (auto* graph = criticalGraph.load(std::memory_order_acquire))
+            if (graph->hasWork())
+                return true;
+        if (auto* graph = currentGraph.load(std::memory_order_acquire))
+            if (graph->hasWork())
+                return true;
+        return !taskQueue.isEmpty();
+    }
+
     class Worker
     {
     public:
@@ -295,8 +631,8 @@ private:
         ~Worker()
         {
             shouldExit.store(true, std::memory_order_release);
-            wakeFlag.store(true, std::memory_order_release);
-            spinAtomicNotifyOne(wakeFlag);
+            wakeFlag.store(1, std::memory_order_seq_cst);
+            parkWake(wakeFlag);
             if (thread.joinable())
                 thread.join();
         }
@@ -314,38 +650,133 @@ private:
 
         void signal()
         {
-            wakeFlag.store(true, std::memory_order_release);
-            spinAtomicNotifyOne(wakeFlag);
+            signalTimeNs.store(steadyNowNs(), std::memory_order_relaxed);
+            wakeFlag.store(1, std::memory_order_seq_cst);
+
+            // Spinning workers see the flag; only a kernel-parked one needs the syscall
+            if (sleeping.load(std::memory_order_seq_cst))
+                parkWake(wakeFlag);
         }
 
-        void wakeNextWorker()
+        // Claims and wakes this worker if it is parked; busy workers find new work on their own
+        bool tryWakeIfIdle()
         {
-            // Don't wake next worker if pool is shutting down
-            if (!pool.initialized.load(std::memory_order_acquire))
-                return;
+            if (!idle.load(std::memory_order_relaxed) || !idle.exchange(false, std::memory_order_acq_rel))
+                return false;
 
-            const int total = static_cast<int>(pool.workers.size());
-            if (total <= 1)
-                return;
+            signal();
+            return true;
+        }
 
-            int nextIndex = (workerIndex + 1) % total;
-            if (nextIndex == workerIndex)
-                return;
+        // True if this worker has already joined the graph's current run, or is among the workers
+        // the graph may use and one of its slots is still free
+        bool canRun(const DependencyTaskGraph& graph, bool critical) const
+        {
+            if (isJoined(graph, critical ? criticalJoin : poolJoin))
+                return true;
 
-            auto* nextWorker = pool.workers[nextIndex].get();
-            if (nextWorker)
-                nextWorker->signal();
+            const int limit = critical ? pool.getCriticalWorkerLimit(graph) : pool.getWorkerLimit(graph);
+            return workerIndex < limit && graph.canAcceptWorker();
         }
 
+        // Idle accounting, read by RealtimeThreadPool::getIdleStats()
+        std::atomic<int64_t> spinNs{0};
+        std::atomic<int64_t> parkedNs{0};
+        std::atomic<int64_t> busyNs{0};
+
     private:
+        // The run of a graph this worker has joined. Kept per slot, so that switching to a
+        // Critical graph and back doesn't take a second place in the graph it left.
+        struct JoinedRun
+        {
+            const DependencyTaskGraph* graph = nullptr;
+            uint32_t epoch = 0;
+        };
+
+        static bool isJoined(const DependencyTaskGraph& graph, const JoinedRun& joined)
+        {
+            return joined.graph == &graph && joined.epoch == graph.getRunEpoch();
+        }
+
+        // Enforces the graph's worker cap; a worker joins once per run
+        static bool joinGraph(DependencyTaskGraph& graph, JoinedRun& joined)
+        {
+            if (isJoined(graph, joined))
+                return true;
+
+            if (!graph.tryJoinWorker())
+                return false;
+
+            joined.graph = &graph;
+            joined.epoch = graph.getRunEpoch();
+            return true;
+        }
+
+        // Returns once woken. Spins only while a graph it may join is in flight, or inside the window
+        // around the next predicted block if it is in the active set; otherwise parks in the kernel,
+        // until that window opens if it is in the active set and until signalled if not.
+        void park()
+        {
+            int64_t now = steadyNowNs();
+
+            while (wakeFlag.load(std::memory_order_acquire) == 0)
+            {
+                int64_t window = 0;
+                const bool active = workerIndex < pool.getNumActiveWorkers();
+                const int64_t nextArrival = active ? pool.predictNextArrival(now, window) : kNoArrival;
+                const auto* critical = pool.criticalGraph.load(std::memory_order_acquire);
+                const auto* graph = pool.currentGraph.load(std::memory_order_acquire);
+                const bool graphInFlight =
+                    (critical != nullptr && !critical->isComplete() && canRun(*critical, true))
+                    || (graph != nullptr && !graph->isComplete() && canRun(*graph, false));
+
+                if (graphInFlight || (nextArrival != kNoArrival && now >= nextArrival - window))
+                {
+                    for (int i = 0; i < 64 && wakeFlag.load(std::memory_order_relaxed) == 0; ++i)
+                        cpuPause();
+
+                    const int64_t after = steadyNowNs();
+                    spinNs.fetch_add(after - now, std::memory_order_relaxed);
+                    now = after;
+                    continue;
+                }
+
+                const int64_t timeout = nextArrival != kNoArrival ? nextArrival - window - now : -1;
+                sleeping.store(true, std::memory_order_seq_cst);
+                parkWait(wakeFlag, 0, timeout);
+                sleeping.store(false, std::memory_order_relaxed);
+
+                const int64_t after = steadyNowNs();
+                parkedNs.fetch_add(after - now, std::memory_order_relaxed);
+                now = after;
+            }
+
+            wakeFlag.store(0, std::memory_order_relaxed);
+
+            // Self-wakes from the idle re-check carry no signal time
+            if (const int64_t signalled = signalTimeNs.exchange(0, std::memory_order_relaxed); signalled > 0)
+                pool.wakeLatency.record(now - signalled);
+        }
+
         void run()
         {
+            // Map the stack before the first graph runs on it
+            rtmemory::prefaultStack(lockedStack);
             started.store(true, std::memory_order_release);
 
             while (!shouldExit.load(std::memory_order_acquire))
             {
-                spinAtomicWait(wakeFlag, false);
-                wakeFlag.store(false, std::memory_order_relaxed);
+                // Advertise as idle, then re-check for work queued before a waker could see the flag
+                idle.store(true, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (pool.hasPendingWork() && idle.exchange(false, std::memory_order_acq_rel))
+                    wakeFlag.store(1, std::memory_order_relaxed);
+
+                park();
+                const int64_t busyStart = steadyNowNs();
+
+                // Hosted plugin tails decaying into denormals would otherwise spike CPU during silence
+                ScopedFlushDenormals noDenormals;
 
                 // Process tasks as long as there's work available
                 bool didWork;
@@ -353,10 +784,18 @@ private:
                 {
                     didWork = false;
 
+                    // A Critical graph that arrived while another runs goes first, between any two tasks
+                    auto* critical = pool.criticalGraph.load(std::memory_order_acquire);
+                    if (critical != nullptr && joinGraph(*critical, criticalJoin) && critical->tryExecuteOneTask())
+                    {
+                        didWork = true;
+                        continue;
+                    }
+
                     // Check for dependency graph work
-                    if (auto* graph = pool.currentGraph.load(std::memory_order_acquire))
+                    auto* graph = pool.currentGraph.load(std::memory_order_acquire);
+                    if (graph != nullptr && joinGraph(*graph, poolJoin))
                     {
-                        wakeNextWorker();
                         if (graph->tryExecuteOneTask())
                         {
                             didWork = true;
@@ -368,20 +807,31 @@ private:
                     RealtimeTaskQueue::Task task;
                     if (pool.taskQueue.tryPop(task))
                     {
-                        wakeNextWorker();
+                        // Cascade: more tasks queued than workers awake
+                        if (!pool.taskQueue.isEmpty())
+                            pool.wakeIdleWorkers(1, pool.getNumWorkers());
                         if (task.execute)
                             task.execute(task.userData);
                         didWork = true;
                     }
                 } while (didWork);
+
+                rtmemory::samplePageFaults();
+                busyNs.fetch_add(steadyNowNs() - busyStart, std::memory_order_relaxed);
             }
         }
 
         RealtimeThreadPool& pool;
         int workerIndex;
-        std::atomic<bool> wakeFlag{false};
+        std::atomic<uint32_t> wakeFlag{0};
+        std::atomic<bool> sleeping{false};
+        std::atomic<int64_t> signalTimeNs{0};
+        std::atomic<bool> idle{false};
         std::atomic<bool> shouldExit{false};
+        JoinedRun poolJoin;
+        JoinedRun criticalJoin;
         std::atomic<bool> started{false};
+        rtmemory::LockedRegion lockedStack;
         std::thread thread;
     };
 
@@ -392,8 +842,26 @@ private:
     std::vector<std::unique_ptr<Worker>> workers;
     RealtimeTaskQueue taskQueue;
     std::atomic<DependencyTaskGraph*> currentGraph{nullptr};
+    std::atomic<DependencyTaskGraph*> criticalGraph{nullptr}; // see executeCritical()
     std::atomic<bool> initialized{false};
     std::mutex executeMutex;
+    std::mutex criticalMutex;
+
+    std::atomic<int> waitingGraphs[3]{}; // indexed by TaskGraphPriority
+    double parallelismEnvelope = 0.0;    // guarded by executeMutex
+    std::atomic<int> activeWorkers{0};
+    std::atomic<double> measuredParallelism{0.0};
+
+    struct ArrivalSlot
+    {
+        const void* key = nullptr; // guarded by executeMutex
+        std::atomic<int64_t> lastArrivalNs{0};
+        std::atomic<int64_t> periodNs{0};
+        std::atomic<int64_t> jitterNs{0};
+    };
+
+    ArrivalSlot arrivalSlots[kMaxTrackedGraphs];
+    LatencyHistogram wakeLatency;
 
     RealtimeThreadPool(const RealtimeThreadPool&) = delete;
     RealtimeThreadPool& operator=(const RealtimeThreadPool&) = delete;
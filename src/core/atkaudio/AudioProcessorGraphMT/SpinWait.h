@@ -1,9 +1,14 @@
 // Copyright (c) 2025 atkAudio
-// Spin wait with exponential backoff (8→8192) then atomic::wait fallback
+// Spin wait with exponential backoff (8→8192) then atomic::wait fallback,
+// plus a timed park/wake pair for workers that sleep between audio blocks
 
 #pragma once
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
 
 #if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
 #include <emmintrin.h>
@@ -11,6 +16,19 @@
 #include <intrin.h>
 #endif
 
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#pragma comment(lib, "Synchronization.lib")
+#endif
+
 namespace atk
 {
 
@@ -57,4 +75,68 @@ void spinAtomicNotifyAll(std::atomic<T>& atomic)
     atomic.notify_all();
 }
 
+inline int64_t steadyNowNs() noexcept
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// Blocks in the kernel while atomic == oldValue, for at most timeoutNs (negative waits forever).
+// Returns false on timeout. Pair with parkWake(); std::atomic::notify cannot wake this waiter.
+inline bool parkWait(std::atomic<uint32_t>& atomic, uint32_t oldValue, int64_t timeoutNs = -1) noexcept
+{
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex word must be 32-bit");
+
+    const int64_t deadline = timeoutNs >= 0 ? steadyNowNs() + timeoutNs : 0;
+
+    while (atomic.load(std::memory_order_acquire) == oldValue)
+    {
+        int64_t remaining = -1;
+        if (timeoutNs >= 0)
+        {
+            remaining = deadline - steadyNowNs();
+            if (remaining <= 0)
+                return false;
+        }
+
+#if defined(__linux__)
+        timespec ts{};
+        ts.tv_sec = static_cast<time_t>(remaining / 1000000000);
+        ts.tv_nsec = static_cast<long>(remaining % 1000000000);
+        syscall(
+            SYS_futex,
+            reinterpret_cast<uint32_t*>(&atomic),
+            FUTEX_WAIT_PRIVATE,
+            oldValue,
+            remaining >= 0 ? &ts : nullptr,
+            nullptr,
+            0
+        );
+#elif defined(_WIN32)
+        // WaitOnAddress has millisecond resolution; round up so a timed park never ends early
+        const DWORD ms = remaining >= 0 ? static_cast<DWORD>((remaining + 999999) / 1000000) : INFINITE;
+        WaitOnAddress(reinterpret_cast<volatile void*>(&atomic), &oldValue, sizeof(uint32_t), ms);
+#else
+        // No public timed address wait: sleep in short slices, or block on atomic::wait when untimed
+        if (remaining < 0)
+            atomic.wait(oldValue, std::memory_order_acquire);
+        else
+            std::this_thread::sleep_for(std::chrono::nanoseconds((std::min)(remaining, int64_t{250000})));
+#endif
+    }
+
+    return true;
+}
+
+inline void parkWake(std::atomic<uint32_t>& atomic) noexcept
+{
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&atomic), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#elif defined(_WIN32)
+    WakeByAddressSingle(reinterpret_cast<void*>(&atomic));
+#else
+    atomic.notify_one();
+#endif
+}
+
 } // namespace atk
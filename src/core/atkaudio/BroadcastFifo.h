@@ -0,0 +1,254 @@
+#pragma once
+
+#include "JitterEstimator.h"
+#include "RealtimeMemory.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+
+namespace atk
+{
+
+// Single-writer, multi-reader multichannel ring for fanning one stream out to many consumers.
+// The writer never waits for, or even knows about, its readers: each reader keeps its own Cursor
+// and copies out what it has not consumed yet, so one write costs the same for any number of
+// readers, and a reader only copies the channels it asks for.
+// A reader that falls more than the capacity behind has lost data. getNumReady() and peek() report
+// that with -1 and the reader resyncs; the writer is never held back by a stalled reader.
+// The writer's sample rate, block size and callback timing are published with the data, so a
+// reader can drift-correct against the writer without hearing from its thread.
+// setSize() must not overlap anything else.
+class BroadcastFifo
+{
+public:
+    static constexpr size_t kAlignment = 64;
+
+    // Owned by one reader thread
+    struct Cursor
+    {
+        uint64_t position = 0;
+    };
+
+    BroadcastFifo() = default;
+
+    BroadcastFifo(int numChannels, int numSamples)
+    {
+        setSize(numChannels, numSamples);
+    }
+
+    // Holds at least numSamples per channel; the actual capacity is the next power of two
+    void setSize(int newNumChannels, int numSamples)
+    {
+        newNumChannels = std::max(0, newNumChannels);
+        uint32_t newCapacity = kMinCapacity;
+        while (newCapacity < static_cast<uint32_t>(std::max(numSamples, 0)))
+            newCapacity <<= 1;
+
+        lockedStorage.release();
+        storage.reset();
+
+        numChannels = newNumChannels;
+        capacity = newCapacity;
+        mask = capacity - 1;
+
+        const size_t numBytes = static_cast<size_t>(numChannels) * capacity * sizeof(float);
+        if (numBytes > 0)
+        {
+            storage.reset(static_cast<float*>(::operator new[](numBytes, std::align_val_t{kAlignment})));
+            std::memset(storage.get(), 0, numBytes);
+            lockedStorage.lock(storage.get(), numBytes);
+        }
+
+        writePos.store(0, std::memory_order_release);
+        reservedPos.store(0, std::memory_order_release);
+        writerTiming.reset();
+    }
+
+    int getNumChannels() const
+    {
+        return numChannels;
+    }
+
+    int getCapacity() const
+    {
+        return static_cast<int>(capacity);
+    }
+
+    // Source of the write timestamps (seconds) behind the writer timing, as in SyncBuffer. Defaults
+    // to the steady clock; pass nullptr to restore it. Not while writing.
+    using Clock = double (*)(void* context);
+
+    void setClock(Clock newClock, void* context)
+    {
+        clock = newClock;
+        clockContext = context;
+        writerTiming.reset();
+    }
+
+    // Writer thread only. Never blocks and never drops the new block; channels the source doesn't
+    // have are written as silence.
+    void write(const float* const* src, int numSrcChannels, int numSamples, double sampleRate)
+    {
+        writerTiming.addCallback(nowSeconds(), numSamples, sampleRate, WRITER_QUANTILE_PROBABILITY);
+        writerSampleRate.store(sampleRate, std::memory_order_relaxed);
+        writerBlockSize.store(numSamples, std::memory_order_relaxed);
+
+        numSamples = std::min(numSamples, static_cast<int>(capacity));
+        if (numSamples <= 0 || numChannels <= 0)
+            return;
+
+        const uint64_t start = writePos.load(std::memory_order_relaxed);
+
+        // Readers check this after copying: anything they read within a capacity of it may have
+        // been overwritten while they were at it
+        reservedPos.store(start + static_cast<uint64_t>(numSamples), std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        const uint32_t offset = static_cast<uint32_t>(start) & mask;
+        const uint32_t size1 = std::min(static_cast<uint32_t>(numSamples), capacity - offset);
+        const uint32_t size2 = static_cast<uint32_t>(numSamples) - size1;
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            float* dst = getChannel(ch);
+            if (ch < numSrcChannels && src[ch] != nullptr)
+            {
+                std::memcpy(dst + offset, src[ch], size1 * sizeof(float));
+                std::memcpy(dst, src[ch] + size1, size2 * sizeof(float));
+            }
+            else
+            {
+                std::memset(dst + offset, 0, size1 * sizeof(float));
+                std::memset(dst, 0, size2 * sizeof(float));
+            }
+        }
+
+        writePos.store(start + static_cast<uint64_t>(numSamples), std::memory_order_release);
+    }
+
+    // Samples written since the cursor, or -1 if the writer has lapped it
+    int getNumReady(const Cursor& cursor) const
+    {
+        const uint64_t ready = writePos.load(std::memory_order_acquire) - cursor.position;
+        return ready > capacity ? -1 : static_cast<int>(ready);
+    }
+
+    // Copies up to numSamples from the cursor without consuming them. dest[i] receives source
+    // channel channels[i]; an index the ring doesn't have gives silence. Returns the number of
+    // samples copied, or -1 if the writer overwrote any of them meanwhile, in which case dest is
+    // garbage and the cursor needs a resync().
+    int peek(const Cursor& cursor, float* const* dest, const int* channels, int numDestChannels, int numSamples) const
+    {
+        const int ready = getNumReady(cursor);
+        if (ready < 0)
+            return -1;
+
+        const int toRead = std::min(numSamples, ready);
+        if (toRead <= 0)
+            return 0;
+
+        const uint32_t offset = static_cast<uint32_t>(cursor.position) & mask;
+        const uint32_t size1 = std::min(static_cast<uint32_t>(toRead), capacity - offset);
+        const uint32_t size2 = static_cast<uint32_t>(toRead) - size1;
+
+        for (int i = 0; i < numDestChannels; ++i)
+        {
+            const int ch = channels[i];
+            if (ch >= 0 && ch < numChannels)
+            {
+                const float* src = getChannel(ch);
+                std::memcpy(dest[i], src + offset, size1 * sizeof(float));
+                std::memcpy(dest[i] + size1, src, size2 * sizeof(float));
+            }
+            else
+            {
+                std::memset(dest[i], 0, static_cast<size_t>(toRead) * sizeof(float));
+            }
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t reserved = reservedPos.load(std::memory_order_relaxed);
+        if (reserved - cursor.position > capacity)
+            return -1;
+
+        return toRead;
+    }
+
+    // Never moves past the write position
+    void advance(Cursor& cursor, int numSamples) const
+    {
+        const int ready = getNumReady(cursor);
+        if (ready > 0 && numSamples > 0)
+            cursor.position += static_cast<uint64_t>(std::min(numSamples, ready));
+    }
+
+    // Moves the cursor to the write position, so that it starts with nothing to read
+    void resync(Cursor& cursor) const
+    {
+        cursor.position = writePos.load(std::memory_order_acquire);
+    }
+
+    // Of the most recent write; 0 before the first
+    double getSampleRate() const
+    {
+        return writerSampleRate.load(std::memory_order_relaxed);
+    }
+
+    int getBlockSize() const
+    {
+        return writerBlockSize.load(std::memory_order_relaxed);
+    }
+
+    // The published quantile covers WRITER_QUANTILE_PROBABILITY of the writer's callbacks
+    const PublishedJitter& getWriterTiming() const
+    {
+        return writerTiming;
+    }
+
+    // Matches the SyncBuffer default bound of one underrun in a thousand reads
+    static constexpr double WRITER_QUANTILE_PROBABILITY = 1.0 - 0.5 * 1.0e-3;
+
+private:
+    struct AlignedDelete
+    {
+        void operator()(float* p) const noexcept
+        {
+            ::operator delete[](p, std::align_val_t{kAlignment});
+        }
+    };
+
+    static constexpr uint32_t kMinCapacity = kAlignment / sizeof(float);
+
+    double nowSeconds() const
+    {
+        if (clock != nullptr)
+            return clock(clockContext);
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    float* getChannel(int channel) const
+    {
+        return storage.get() + static_cast<size_t>(channel) * capacity;
+    }
+
+    int numChannels = 0;
+    uint32_t capacity = kMinCapacity;
+    uint32_t mask = kMinCapacity - 1;
+    // Readers poll these; the writer's own state lives on other lines
+    alignas(kAlignment) std::atomic<uint64_t> writePos{0};
+    std::atomic<uint64_t> reservedPos{0};
+    alignas(kAlignment) std::atomic<double> writerSampleRate{0.0};
+    std::atomic<int> writerBlockSize{0};
+    PublishedJitter writerTiming;
+    Clock clock{nullptr};
+    void* clockContext{nullptr};
+    std::unique_ptr<float[], AlignedDelete> storage;
+    rtmemory::LockedRegion lockedStorage;
+};
+
+} // namespace atk
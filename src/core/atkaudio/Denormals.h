@@ -0,0 +1,114 @@
+// Copyright (c) 2025 atkAudio
+// Flush-to-zero / denormals-are-zero control for realtime audio threads
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#include <xmmintrin.h>
+#define ATK_DENORMALS_X86 1
+#elif defined(_MSC_VER) && defined(_M_ARM64)
+#include <float.h>
+#define ATK_DENORMALS_MSVC_ARM64 1
+#elif defined(__aarch64__)
+#define ATK_DENORMALS_AARCH64 1
+#endif
+
+namespace atk
+{
+
+namespace denormals
+{
+
+// Global toggle. Enabled by default; disable only for hosted plugins that rely on IEEE denormal behaviour.
+inline std::atomic<bool> flushToZeroEnabled{true};
+
+inline bool isFlushToZeroEnabled() noexcept
+{
+    return flushToZeroEnabled.load(std::memory_order_relaxed);
+}
+
+inline void setFlushToZeroEnabled(bool enabled) noexcept
+{
+    flushToZeroEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+// Returns true if the calling thread currently flushes denormals to zero.
+inline bool isFlushToZeroActiveOnThisThread() noexcept
+{
+#if ATK_DENORMALS_X86
+    return (_mm_getcsr() & 0x8040u) == 0x8040u;
+#elif ATK_DENORMALS_MSVC_ARM64
+    unsigned int current = 0;
+    _controlfp_s(&current, 0, 0);
+    return (current & _MCW_DN) == _DN_FLUSH;
+#elif ATK_DENORMALS_AARCH64
+    uint64_t fpcr = 0;
+    __asm__ __volatile__("mrs %0, fpcr" : "=r"(fpcr));
+    return (fpcr & (1ull << 24)) != 0;
+#else
+    return false;
+#endif
+}
+
+} // namespace denormals
+
+// RAII guard that enables FTZ/DAZ on the calling thread for its lifetime and restores the
+// previous floating point control state afterwards. Does nothing when the global toggle is off,
+// so the caller's (IEEE) behaviour is preserved.
+class ScopedFlushDenormals
+{
+public:
+    ScopedFlushDenormals() noexcept
+    {
+        if (!denormals::isFlushToZeroEnabled())
+            return;
+
+        active = true;
+#if ATK_DENORMALS_X86
+        // Bit 15 = FTZ (flush results), bit 6 = DAZ (treat inputs as zero)
+        saved = _mm_getcsr();
+        _mm_setcsr(static_cast<unsigned int>(saved) | 0x8040u);
+#elif ATK_DENORMALS_MSVC_ARM64
+        unsigned int current = 0;
+        _controlfp_s(&current, 0, 0);
+        saved = current;
+        _controlfp_s(&current, _DN_FLUSH, _MCW_DN);
+#elif ATK_DENORMALS_AARCH64
+        // FPCR.FZ (bit 24) covers both inputs and results on AArch64
+        __asm__ __volatile__("mrs %0, fpcr" : "=r"(saved));
+        const uint64_t flushed = saved | (1ull << 24);
+        __asm__ __volatile__("msr fpcr, %0" : : "r"(flushed));
+#endif
+    }
+
+    ~ScopedFlushDenormals() noexcept
+    {
+        if (!active)
+            return;
+
+#if ATK_DENORMALS_X86
+        _mm_setcsr(static_cast<unsigned int>(saved));
+#elif ATK_DENORMALS_MSVC_ARM64
+        unsigned int current = 0;
+        _controlfp_s(&current, static_cast<unsigned int>(saved) & _MCW_DN, _MCW_DN);
+#elif ATK_DENORMALS_AARCH64
+        __asm__ __volatile__("msr fpcr, %0" : : "r"(saved));
+#endif
+    }
+
+    ScopedFlushDenormals(const ScopedFlushDenormals&) = delete;
+    ScopedFlushDenormals& operator=(const ScopedFlushDenormals&) = delete;
+
+private:
+    uint64_t saved = 0;
+    bool active = false;
+};
+
+} // namespace atk
+
+#undef ATK_DENORMALS_X86
+#undef ATK_DENORMALS_MSVC_ARM64
+#undef ATK_DENORMALS_AARCH64
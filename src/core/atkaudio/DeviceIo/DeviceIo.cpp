@@ -169,6 +169,16 @@ float atk::DeviceIo::getOutputDelay() const
     return outputDelayMs.load(std::memory_order_acquire);
 }
 
+atk::SyncBufferStats atk::DeviceIo::getInputStats() const
+{
+    return deviceIoApp ? deviceIoApp->getToObsBuffer().getStats() : SyncBufferStats{};
+}
+
+atk::SyncBufferStats atk::DeviceIo::getOutputStats() const
+{
+    return deviceIoApp ? deviceIoApp->getFromObsBuffer().getStats() : SyncBufferStats{};
+}
+
 void atk::DeviceIo::getState(std::string& s)
 {
     if (deviceIoApp == nullptr)
@@ -2,6 +2,8 @@
 
 #include "../atkAudioModule.h"
 
+#include <atkaudio/SyncBufferStats.h>
+
 #include <atomic>
 #include <memory>
 #include <string>
@@ -33,6 +35,10 @@ public:
     void setOutputDelay(float delayMs);
     float getOutputDelay() const;
 
+    // Health of the device -> OBS and OBS -> device bridges; lock-free
+    SyncBufferStats getInputStats() const;
+    SyncBufferStats getOutputStats() const;
+
     void getState(std::string& s) override;
     void setState(std::string& s) override;
 
@@ -1,7 +1,9 @@
 #pragma once
 
+#include "../Denormals.h"
 #include "../FifoBuffer2.h"
 #include "../LookAndFeel.h"
+#include "../RealtimeMemory.h"
 #include <atkaudio/Logging.h>
 #include <atkaudio/ModuleInfrastructure/AudioServer/AudioServer.h>
 #include <atkaudio/ModuleInfrastructure/Bridge/ModuleAudioIODeviceType.h>
@@ -128,6 +130,9 @@ public:
         const juce::AudioIODeviceCallbackContext&
     ) override
     {
+        atk::ScopedFlushDenormals noDenormals;
+        atk::rtmemory::samplePageFaults();
+
         if (needsBufferClear.exchange(false)) {
             toObsBuffer.reset();
             fromObsBuffer.reset();
@@ -327,6 +327,11 @@ float atk::DeviceIo2::getOutputDelay() const
     return outputDelayMs.load(std::memory_order_acquire);
 }
 
+std::vector<atk::AudioClient::SubscriptionStats> atk::DeviceIo2::getSubscriptionStats() const
+{
+    return audioClient.getSubscriptionStats();
+}
+
 void atk::DeviceIo2::setInputChannelMapping(const std::vector<std::vector<bool>>& mapping)
 {
     routingMatrix.setInputMapping(mapping);
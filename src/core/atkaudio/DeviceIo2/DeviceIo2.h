@@ -33,6 +33,9 @@ public:
     void setOutputDelay(float delayMs);
     float getOutputDelay() const;
 
+    // Health of each subscribed device channel's SyncBuffer; lock-free
+    std::vector<AudioClient::SubscriptionStats> getSubscriptionStats() const;
+
     void setInputChannelMapping(const std::vector<std::vector<bool>>& mapping);
     std::vector<std::vector<bool>> getInputChannelMapping() const;
 
@@ -1,31 +1,33 @@
 #pragma once
 
+#include "RealtimeMemory.h"
+
 #include <algorithm>
 #include <atomic>
-#include <vector>
+#include <cstdint>
 #include <cstring>
+#include <memory>
+#include <new>
 
 namespace atk
 {
 
-// Simple lock-free FIFO buffer for audio
+// Simple lock-free FIFO buffer for audio.
+// All channels share one 64-byte aligned allocation. The capacity is rounded up to a power of two
+// and read/write positions run freely, so indexing is a mask and a full buffer needs no guard sample.
 class FifoBuffer
 {
 public:
-    FifoBuffer()
-        : numChannels(0)
-        , totalSize(0)
-        , readPos(0)
-        , writePos(0)
-    {
-    }
+    static constexpr size_t kAlignment = 64;
+
+    FifoBuffer() = default;
 
     void reset()
     {
         readPos.store(0, std::memory_order_release);
         writePos.store(0, std::memory_order_release);
-        for (auto& channel : buffer)
-            std::fill(channel.begin(), channel.end(), 0.0f);
+        if (storage)
+            std::memset(storage.get(), 0, static_cast<size_t>(numChannels) * capacity * sizeof(float));
     }
 
     void read(float* dest, int channel, int numSamples, bool advance = true)
@@ -33,26 +35,44 @@ public:
         if (channel >= numChannels || numSamples <= 0)
             return;
 
-        const int readPosition = readPos.load(std::memory_order_acquire);
-        const int available = getNumReady();
-        const int toRead = std::min(numSamples, available);
+        const uint32_t readPosition = readPos.load(std::memory_order_acquire);
+        const int toRead = std::min(numSamples, getNumReady());
 
         if (toRead <= 0)
             return;
 
-        const int start1 = readPosition;
-        const int size1 = std::min(toRead, totalSize - start1);
-        const int size2 = toRead - size1;
-
-        const float* src = buffer[channel].data();
-        if (size1 > 0)
-            std::copy(src + start1, src + start1 + size1, dest);
+        const uint32_t start = readPosition & mask;
+        const uint32_t size1 = std::min(static_cast<uint32_t>(toRead), capacity - start);
+        const uint32_t size2 = static_cast<uint32_t>(toRead) - size1;
 
+        const float* src = getChannel(channel);
+        std::memcpy(dest, src + start, size1 * sizeof(float));
         if (size2 > 0)
-            std::copy(src, src + size2, dest + size1);
+            std::memcpy(dest + size1, src, size2 * sizeof(float));
 
         if (advance)
-            readPos.store((readPosition + toRead) % totalSize, std::memory_order_release);
+            readPos.store(readPosition + static_cast<uint32_t>(toRead), std::memory_order_release);
+    }
+
+    // Like read(advance = false), but sums into dest instead of overwriting it
+    void readAdding(float* dest, int channel, int numSamples) const
+    {
+        if (channel >= numChannels || numSamples <= 0)
+            return;
+
+        const uint32_t readPosition = readPos.load(std::memory_order_acquire);
+        const int toRead = std::min(numSamples, getNumReady());
+
+        if (toRead <= 0)
+            return;
+
+        const uint32_t start = readPosition & mask;
+        const uint32_t size1 = std::min(static_cast<uint32_t>(toRead), capacity - start);
+        const uint32_t size2 = static_cast<uint32_t>(toRead) - size1;
+
+        const float* src = getChannel(channel);
+        addSpan(dest, src + start, size1);
+        addSpan(dest + size1, src, size2);
     }
 
     void write(const float* data, int channel, int numSamples, bool advance = true)
@@ -60,53 +80,51 @@ public:
         if (channel >= numChannels || numSamples <= 0)
             return;
 
-        const int writePosition = writePos.load(std::memory_order_acquire);
-        const int freeSpace = getFreeSpace();
-        const int toWrite = std::min(numSamples, freeSpace);
+        const uint32_t writePosition = writePos.load(std::memory_order_acquire);
+        const int toWrite = std::min(numSamples, getFreeSpace());
 
         if (toWrite <= 0)
             return;
 
-        const int start1 = writePosition;
-        const int size1 = std::min(toWrite, totalSize - start1);
-        const int size2 = toWrite - size1;
-
-        float* dst = buffer[channel].data();
-        if (size1 > 0)
-            std::copy(data, data + size1, dst + start1);
+        const uint32_t start = writePosition & mask;
+        const uint32_t size1 = std::min(static_cast<uint32_t>(toWrite), capacity - start);
+        const uint32_t size2 = static_cast<uint32_t>(toWrite) - size1;
 
+        float* dst = getChannel(channel);
+        std::memcpy(dst + start, data, size1 * sizeof(float));
         if (size2 > 0)
-            std::copy(data + size1, data + size1 + size2, dst);
+            std::memcpy(dst, data + size1, size2 * sizeof(float));
 
         if (advance)
-            writePos.store((writePosition + toWrite) % totalSize, std::memory_order_release);
+            writePos.store(writePosition + static_cast<uint32_t>(toWrite), std::memory_order_release);
     }
 
+    // Never moves past the write position
     void advanceRead(int numSamples)
     {
-        const int readPosition = readPos.load(std::memory_order_acquire);
-        readPos.store((readPosition + numSamples) % totalSize, std::memory_order_release);
+        const int toAdvance = std::min(numSamples, getNumReady());
+        if (toAdvance <= 0)
+            return;
+
+        const uint32_t readPosition = readPos.load(std::memory_order_acquire);
+        readPos.store(readPosition + static_cast<uint32_t>(toAdvance), std::memory_order_release);
     }
 
     int getNumReady() const
     {
-        const int writePosition = writePos.load(std::memory_order_acquire);
-        const int readPosition = readPos.load(std::memory_order_acquire);
-        if (writePosition >= readPosition)
-            return writePosition - readPosition;
-        else
-            return totalSize - readPosition + writePosition;
+        const uint32_t writePosition = writePos.load(std::memory_order_acquire);
+        const uint32_t readPosition = readPos.load(std::memory_order_acquire);
+        return static_cast<int>(writePosition - readPosition);
     }
 
     int getTotalSize() const
     {
-        return totalSize;
+        return static_cast<int>(capacity);
     }
 
     int getFreeSpace() const
     {
-        // Keep one sample as guard to distinguish full from empty
-        return totalSize - getNumReady() - 1;
+        return static_cast<int>(capacity) - getNumReady();
     }
 
     int getNumChannels() const
@@ -114,26 +132,72 @@ public:
         return numChannels;
     }
 
+    // Holds at least numSamples per channel; the actual capacity is the next power of two
     void setSize(int newNumChannels, int numSamples)
     {
-        if (newNumChannels == numChannels && numSamples == totalSize)
+        newNumChannels = std::max(0, newNumChannels);
+        const uint32_t newCapacity = roundUpCapacity(numSamples);
+
+        if (newNumChannels == numChannels && newCapacity == capacity)
             return;
 
+        // Unlock before the storage is reallocated
+        lockedStorage.release();
+        storage.reset();
+
         numChannels = newNumChannels;
-        totalSize = numSamples;
-        buffer.resize(numChannels);
-        for (auto& channel : buffer)
-            channel.resize(totalSize, 0.0f);
+        capacity = newCapacity;
+        mask = capacity - 1;
+
+        const size_t numBytes = static_cast<size_t>(numChannels) * capacity * sizeof(float);
+        if (numBytes > 0)
+        {
+            storage.reset(static_cast<float*>(::operator new[](numBytes, std::align_val_t{kAlignment})));
+            lockedStorage.lock(storage.get(), numBytes);
+        }
 
         reset();
     }
 
 private:
-    int numChannels;
-    int totalSize;
-    std::atomic<int> readPos;
-    std::atomic<int> writePos;
-    std::vector<std::vector<float>> buffer;
+    struct AlignedDelete
+    {
+        void operator()(float* p) const noexcept
+        {
+            ::operator delete[](p, std::align_val_t{kAlignment});
+        }
+    };
+
+    // At least one cache line per channel keeps every channel start aligned
+    static constexpr uint32_t kMinCapacity = kAlignment / sizeof(float);
+
+    static uint32_t roundUpCapacity(int numSamples)
+    {
+        uint32_t size = kMinCapacity;
+        while (size < static_cast<uint32_t>(std::max(numSamples, 0)))
+            size <<= 1;
+        return size;
+    }
+
+    static void addSpan(float* dest, const float* src, uint32_t numSamples)
+    {
+        for (uint32_t i = 0; i < numSamples; ++i)
+            dest[i] += src[i];
+    }
+
+    float* getChannel(int channel) const
+    {
+        return storage.get() + static_cast<size_t>(channel) * capacity;
+    }
+
+    int numChannels = 0;
+    uint32_t capacity = kMinCapacity;
+    uint32_t mask = kMinCapacity - 1;
+    // Separate cache lines so the reader and writer threads don't contend on one line
+    alignas(kAlignment) std::atomic<uint32_t> readPos{0};
+    alignas(kAlignment) std::atomic<uint32_t> writePos{0};
+    std::unique_ptr<float[], AlignedDelete> storage;
+    rtmemory::LockedRegion lockedStorage;
 };
 
 } // namespace atk
@@ -1,15 +1,23 @@
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <cmath>
 #include <condition_variable>
 #include <cstdint>
 #include <iomanip>
 #include <iostream>
+#include <memory>
 #include <mutex>
 #include <sstream>
 #include <thread>
+#include <vector>
+#include "BroadcastFifo.h"
 #include "FifoBuffer.h"
+#include "JitterEstimator.h"
+#include "SlidingMinMax.h"
+#include "SyncBufferStats.h"
 
 #include <juce_core/juce_core.h>
 
@@ -26,277 +34,419 @@ namespace atk
 enum class InterpolationType
 {
     Linear,
-    Lagrange
+    Lagrange,
+    SincMedium, // 16-tap windowed sinc
+    SincHigh    // 32-tap windowed sinc
 };
 
-class Interpolator
+inline bool isSincInterpolation(InterpolationType type) noexcept
+{
+    return type == InterpolationType::SincMedium || type == InterpolationType::SincHigh;
+}
+
+// Quality used by SyncBuffers that don't choose their own (device bridges). Read at construction.
+inline std::atomic<InterpolationType> defaultInterpolationType{InterpolationType::Lagrange};
+
+// Whether SyncBuffers start with the jitter-adaptive latency target enabled. Read at construction.
+inline std::atomic<bool> defaultAdaptiveTarget{false};
+
+//==============================================================================
+// Kaiser-windowed sinc kernels tabulated at numPhases + 1 fractional offsets in [0, 1].
+// The cutoff is fixed at design time; SincKernel linearly interpolates between neighbouring
+// phases, so any fractional position and ratio can use the same bank.
+class SincFilterBank
 {
 public:
-    virtual ~Interpolator() = default;
+    // cutoff is relative to the input Nyquist frequency
+    SincFilterBank(int taps, int phases, double cutoff, double kaiserBeta)
+        : numTaps(taps)
+        , numPhases(phases)
+        , designCutoff(cutoff)
+        , coefficients(static_cast<size_t>((phases + 1) * taps))
+    {
+        const double centre = numTaps / 2 - 1;
+        const double halfLength = numTaps / 2;
+        const double windowNorm = 1.0 / besselI0(kaiserBeta);
+
+        for (int p = 0; p <= numPhases; ++p)
+        {
+            const double fraction = static_cast<double>(p) / numPhases;
+            float* phase = coefficients.data() + static_cast<size_t>(p) * numTaps;
+
+            double sum = 0.0;
+            for (int k = 0; k < numTaps; ++k)
+            {
+                const double t = k - centre - fraction;
+                const double x = t / halfLength;
+                const double window = std::abs(x) < 1.0 ? besselI0(kaiserBeta * std::sqrt(1.0 - x * x)) * windowNorm
+                                                        : 0.0;
+                const double arg = juce::MathConstants<double>::pi * cutoff * t;
+                const double sinc = std::abs(arg) < 1.0e-9 ? 1.0 : std::sin(arg) / arg;
+
+                const double h = cutoff * sinc * window;
+                phase[k] = static_cast<float>(h);
+                sum += h;
+            }
+
+            // Unity DC gain at every offset, so slow ratio changes don't modulate the level
+            for (int k = 0; k < numTaps; ++k)
+                phase[k] = static_cast<float>(phase[k] / sum);
+        }
+    }
+
+    // Bank for a quality level. Downsampling (ratio > 1) lowers the cutoff below the output Nyquist.
+    static std::shared_ptr<const SincFilterBank> create(InterpolationType type, double nominalRatio)
+    {
+        const bool high = type == InterpolationType::SincHigh;
+        const double passband = high ? 0.94 : 0.90;
+        const double cutoff = passband / std::max(1.0, nominalRatio);
+
+        return std::make_shared<const SincFilterBank>(high ? 32 : 16, high ? 512 : 256, cutoff, high ? 9.0 : 7.0);
+    }
+
+    int getNumTaps() const noexcept
+    {
+        return numTaps;
+    }
+
+    int getNumPhases() const noexcept
+    {
+        return numPhases;
+    }
+
+    double getCutoff() const noexcept
+    {
+        return designCutoff;
+    }
+
+    const float* getPhase(int phase) const noexcept
+    {
+        return coefficients.data() + static_cast<size_t>(phase) * numTaps;
+    }
+
+private:
+    static double besselI0(double x) noexcept
+    {
+        double sum = 1.0;
+        double term = 1.0;
+        const double halfX = 0.5 * x;
+        for (int k = 1; k < 64 && term > sum * 1.0e-12; ++k)
+        {
+            term *= (halfX / k) * (halfX / k);
+            sum += term;
+        }
+        return sum;
+    }
+
+    int numTaps;
+    int numPhases;
+    double designCutoff;
+    std::vector<float> coefficients;
+};
+
+//==============================================================================
+// Block resamplers that advance all channels of a frame together. Every channel shares one read
+// position, so the kernel coefficients are computed once per output frame and then applied across
+// a frame-interleaved history; the inner loop runs over channels and vectorises. The kernel is a
+// template parameter, leaving one virtual call per block instead of one per channel.
+class MultichannelInterpolator
+{
+public:
+    virtual ~MultichannelInterpolator() = default;
     virtual void reset() noexcept = 0;
+
+    // Overwrites up to numOutputSamples frames of every output channel. Returns the number of
+    // input frames consumed; numProduced receives the number of output frames written.
     virtual int process(
         double speedRatio,
-        const float* inputSamples,
-        float* outputSamples,
-        int numOutputSamples,
+        const float* const* inputs,
         int numInputSamples,
-        int wrapAround
-    ) noexcept = 0;
-    virtual int processAdding(
-        double speedRatio,
-        const float* inputSamples,
-        float* outputSamples,
+        float* const* outputs,
         int numOutputSamples,
-        int numInputSamples,
-        int wrapAround,
-        float gain
+        int& numProduced
     ) noexcept = 0;
 };
 
-class LinearInterpolator : public Interpolator
+// 5-point Lagrange: subSamplePos is the offset between the two centre taps, so the latency is
+// two samples
+struct LagrangeKernel
+{
+    static constexpr int numTaps = 5;
+    static constexpr double initialSubSamplePos = 1.0;
+
+    void getCoefficients(double subSamplePos, float* coefficients) const noexcept
+    {
+        const auto offset = static_cast<float>(subSamplePos);
+        coefficients[0] = calcCoefficient<0>(offset);
+        coefficients[1] = calcCoefficient<1>(offset);
+        coefficients[2] = calcCoefficient<2>(offset);
+        coefficients[3] = calcCoefficient<3>(offset);
+        coefficients[4] = calcCoefficient<4>(offset);
+    }
+
+private:
+    template <int k>
+    static float calcCoefficient(float offset) noexcept
+    {
+        float c = 1.0f;
+        if constexpr (k != 0)
+            c *= (-2.0f - offset) * (1.0f / (0 - k));
+        if constexpr (k != 1)
+            c *= (-1.0f - offset) * (1.0f / (1 - k));
+        if constexpr (k != 2)
+            c *= (0.0f - offset) * (1.0f / (2 - k));
+        if constexpr (k != 3)
+            c *= (1.0f - offset) * (1.0f / (3 - k));
+        if constexpr (k != 4)
+            c *= (2.0f - offset) * (1.0f / (4 - k));
+        return c;
+    }
+};
+
+// Polyphase windowed sinc, positioned like LagrangeKernel: subSamplePos is the offset between the
+// two centre taps, so the latency is taps / 2 samples. Taps must match the bank.
+template <int Taps>
+struct SincKernel
+{
+    static constexpr int numTaps = Taps;
+    static constexpr double initialSubSamplePos = 1.0;
+
+    std::shared_ptr<const SincFilterBank> bank;
+
+    void getCoefficients(double subSamplePos, float* coefficients) const noexcept
+    {
+        const double phasePos = subSamplePos * bank->getNumPhases();
+        const int phase = std::min(static_cast<int>(phasePos), bank->getNumPhases() - 1);
+        const auto alpha = static_cast<float>(phasePos - phase);
+
+        const float* a = bank->getPhase(phase);
+        const float* b = bank->getPhase(phase + 1);
+        for (int k = 0; k < numTaps; ++k)
+            coefficients[k] = a[k] + alpha * (b[k] - a[k]);
+    }
+};
+
+// Lanes is the number of channels accumulated together; 4 fills an SSE/NEON register
+template <typename Kernel, int Lanes = 4>
+class MultichannelInterpolatorImpl : public MultichannelInterpolator
 {
 public:
-    LinearInterpolator() noexcept
+    MultichannelInterpolatorImpl(int channels, Kernel k = {})
+        : kernel(std::move(k))
+        , numChannels(std::max(1, channels))
+        , frameStride((numChannels + Lanes - 1) / Lanes * Lanes)
+        , history(static_cast<size_t>(2 * Kernel::numTaps * frameStride))
     {
         reset();
     }
 
     void reset() noexcept override
     {
-        lastInputSamples[0] = 0.0f;
-        lastInputSamples[1] = 0.0f;
-        subSamplePos = 0.0;
+        std::fill(history.begin(), history.end(), 0.0f);
+        writeIndex = 0;
+        subSamplePos = Kernel::initialSubSamplePos;
     }
 
     int process(
         double speedRatio,
-        const float* inputSamples,
-        float* outputSamples,
-        int numOutputSamples,
+        const float* const* inputs,
         int numInputSamples,
-        int wrapAround
+        float* const* outputs,
+        int numOutputSamples,
+        int& numProduced
     ) noexcept override
     {
-        (void)wrapAround; // Unused - reserved for future use
+        numProduced = 0;
         if (speedRatio <= 0.0)
             return 0;
 
         int pos = 0;
-        auto* out = outputSamples;
+        float coefficients[Kernel::numTaps];
 
-        while (numOutputSamples > 0)
+        while (numProduced < numOutputSamples)
         {
             while (subSamplePos >= 1.0)
             {
                 if (pos >= numInputSamples)
                     return pos;
 
-                pushInterpolationSample(inputSamples[pos++]);
+                pushFrame(inputs, pos++);
                 subSamplePos -= 1.0;
             }
 
-            *out++ = interpolate();
-            subSamplePos += speedRatio;
-            --numOutputSamples;
-        }
-
-        return pos;
-    }
-
-    int processAdding(
-        double speedRatio,
-        const float* inputSamples,
-        float* outputSamples,
-        int numOutputSamples,
-        int numInputSamples,
-        int wrapAround,
-        float gain
-    ) noexcept override
-    {
-        (void)wrapAround; // Unused - reserved for future use
-        if (speedRatio <= 0.0)
-            return 0;
+            kernel.getCoefficients(subSamplePos, coefficients);
 
-        int pos = 0;
-        auto* out = outputSamples;
-
-        while (numOutputSamples > 0)
-        {
-            while (subSamplePos >= 1.0)
+            // Lanes channels at a time, accumulated in registers, oldest frame first. Taps are
+            // split across independent partial sums so long kernels aren't one dependency chain.
+            const float* window = history.data() + static_cast<size_t>(writeIndex) * frameStride;
+            for (int group = 0; group < frameStride; group += Lanes)
             {
-                if (pos >= numInputSamples)
-                    return pos;
-
-                pushInterpolationSample(inputSamples[pos++]);
-                subSamplePos -= 1.0;
+                float acc[Partials][Lanes] = {};
+                const float* tap = window + group;
+                int k = 0;
+                for (; k + Partials <= Kernel::numTaps; k += Partials)
+                    for (int p = 0; p < Partials; ++p, tap += frameStride)
+                        for (int lane = 0; lane < Lanes; ++lane)
+                            acc[p][lane] += coefficients[k + p] * tap[lane];
+                for (; k < Kernel::numTaps; ++k, tap += frameStride)
+                    for (int lane = 0; lane < Lanes; ++lane)
+                        acc[0][lane] += coefficients[k] * tap[lane];
+
+                for (int p = 1; p < Partials; ++p)
+                    for (int lane = 0; lane < Lanes; ++lane)
+                        acc[0][lane] += acc[p][lane];
+
+                const int lanesUsed = std::min(Lanes, numChannels - group);
+                for (int lane = 0; lane < lanesUsed; ++lane)
+                    outputs[group + lane][numProduced] = acc[0][lane];
             }
 
-            *out++ += gain * interpolate();
             subSamplePos += speedRatio;
-            --numOutputSamples;
+            ++numProduced;
         }
 
         return pos;
     }
 
 private:
-    void pushInterpolationSample(float newValue) noexcept
+    // Each frame is stored twice so the newest numTaps frames are always contiguous. Padding
+    // channels stay zero.
+    void pushFrame(const float* const* inputs, int pos) noexcept
     {
-        lastInputSamples[0] = lastInputSamples[1];
-        lastInputSamples[1] = newValue;
+        float* first = history.data() + static_cast<size_t>(writeIndex) * frameStride;
+        float* second = first + static_cast<size_t>(Kernel::numTaps) * frameStride;
+        for (int ch = 0; ch < numChannels; ++ch)
+            first[ch] = second[ch] = inputs[ch][pos];
+        if (++writeIndex == Kernel::numTaps)
+            writeIndex = 0;
     }
 
-    float interpolate() const noexcept
-    {
-        auto alpha = static_cast<float>(subSamplePos);
-        return lastInputSamples[0] + alpha * (lastInputSamples[1] - lastInputSamples[0]);
-    }
+    // Eight accumulators per group: two registers' worth of independent work
+    static constexpr int Partials = std::max(1, std::min(8 / Lanes, Kernel::numTaps));
 
-    float lastInputSamples[2];
-    double subSamplePos;
+    Kernel kernel;
+    int numChannels;
+    int frameStride;
+    std::vector<float> history;
+    int writeIndex{0};
+    double subSamplePos{0.0};
 };
 
-class LagrangeInterpolator : public Interpolator
+// Linear interpolation channel by channel. Two taps don't repay transposing the input into
+// frames, so each channel runs a tight loop from the shared starting position instead.
+class PlanarLinearInterpolator : public MultichannelInterpolator
 {
 public:
-    LagrangeInterpolator() noexcept
+    explicit PlanarLinearInterpolator(int channels)
+        : numChannels(std::max(1, channels))
+        , lastInputSamples(static_cast<size_t>(2 * numChannels))
     {
         reset();
     }
 
     void reset() noexcept override
     {
-        subSamplePos = 1.0;
-        indexBuffer = 0;
-        for (int i = 0; i < 5; ++i)
-            lastInputSamples[i] = 0.0f;
+        std::fill(lastInputSamples.begin(), lastInputSamples.end(), 0.0f);
+        subSamplePos = 0.0;
     }
 
     int process(
         double speedRatio,
-        const float* inputSamples,
-        float* outputSamples,
-        int numOutputSamples,
+        const float* const* inputs,
         int numInputSamples,
-        int wrapAround
-    ) noexcept override
-    {
-        (void)wrapAround; // Unused - reserved for future use
-        if (speedRatio <= 0.0)
-            return 0;
-
-        int pos = 0;
-        auto* out = outputSamples;
-
-        while (numOutputSamples > 0)
-        {
-            while (subSamplePos >= 1.0)
-            {
-                if (pos >= numInputSamples)
-                    return pos;
-
-                pushInterpolationSample(inputSamples[pos++]);
-                subSamplePos -= 1.0;
-            }
-
-            *out++ = interpolate();
-            subSamplePos += speedRatio;
-            --numOutputSamples;
-        }
-
-        return pos;
-    }
-
-    int processAdding(
-        double speedRatio,
-        const float* inputSamples,
-        float* outputSamples,
+        float* const* outputs,
         int numOutputSamples,
-        int numInputSamples,
-        int wrapAround,
-        float gain
+        int& numProduced
     ) noexcept override
     {
-        (void)wrapAround; // Unused - reserved for future use
+        numProduced = 0;
         if (speedRatio <= 0.0)
             return 0;
 
+        // Every channel starts from, and ends at, the same position
         int pos = 0;
-        auto* out = outputSamples;
-
-        while (numOutputSamples > 0)
+        double endPos = subSamplePos;
+        for (int ch = 0; ch < numChannels; ++ch)
         {
-            while (subSamplePos >= 1.0)
+            const float* in = inputs[ch];
+            float* out = outputs[ch];
+            float previous = lastInputSamples[static_cast<size_t>(2 * ch)];
+            float current = lastInputSamples[static_cast<size_t>(2 * ch + 1)];
+            double position = subSamplePos;
+            int produced = 0;
+            pos = 0;
+
+            while (produced < numOutputSamples)
             {
-                if (pos >= numInputSamples)
-                    return pos;
+                while (position >= 1.0 && pos < numInputSamples)
+                {
+                    previous = current;
+                    current = in[pos++];
+                    position -= 1.0;
+                }
+                if (position >= 1.0)
+                    break;
 
-                pushInterpolationSample(inputSamples[pos++]);
-                subSamplePos -= 1.0;
+                out[produced++] = previous + static_cast<float>(position) * (current - previous);
+                position += speedRatio;
             }
 
-            *out++ += gain * interpolate();
-            subSamplePos += speedRatio;
-            --numOutputSamples;
+            lastInputSamples[static_cast<size_t>(2 * ch)] = previous;
+            lastInputSamples[static_cast<size_t>(2 * ch + 1)] = current;
+            endPos = position;
+            numProduced = produced;
         }
 
+        subSamplePos = endPos;
         return pos;
     }
 
 private:
-    void pushInterpolationSample(float newValue) noexcept
-    {
-        lastInputSamples[indexBuffer] = newValue;
-        if (++indexBuffer == 5)
-            indexBuffer = 0;
-    }
-
-    template <int k>
-    static float calcCoefficient(float input, float offset) noexcept
-    {
-        if constexpr (k != 0)
-            input *= (-2.0f - offset) * (1.0f / (0 - k));
-        if constexpr (k != 1)
-            input *= (-1.0f - offset) * (1.0f / (1 - k));
-        if constexpr (k != 2)
-            input *= (0.0f - offset) * (1.0f / (2 - k));
-        if constexpr (k != 3)
-            input *= (1.0f - offset) * (1.0f / (3 - k));
-        if constexpr (k != 4)
-            input *= (2.0f - offset) * (1.0f / (4 - k));
-        return input;
-    }
+    int numChannels;
+    std::vector<float> lastInputSamples; // previous, current per channel
+    double subSamplePos{0.0};
+};
 
-    float interpolate() const noexcept
+// Mono and stereo would waste half of a 4-lane group, so they accumulate two lanes at a time
+template <typename Kernel>
+std::unique_ptr<MultichannelInterpolator> makeMultichannelInterpolator(int numChannels, Kernel kernel = {})
+{
+    if (numChannels <= 2)
+        return std::make_unique<MultichannelInterpolatorImpl<Kernel, 2>>(numChannels, std::move(kernel));
+    return std::make_unique<MultichannelInterpolatorImpl<Kernel, 4>>(numChannels, std::move(kernel));
+}
+
+// bank is required for the sinc types and ignored otherwise
+inline std::unique_ptr<MultichannelInterpolator> createMultichannelInterpolator(
+    InterpolationType type,
+    int numChannels,
+    std::shared_ptr<const SincFilterBank> bank = nullptr
+)
+{
+    switch (type)
     {
-        auto offset = static_cast<float>(subSamplePos);
-        auto index = indexBuffer;
-
-        float result = 0.0f;
-        result += calcCoefficient<0>(lastInputSamples[index], offset);
-        if (++index == 5)
-            index = 0;
-        result += calcCoefficient<1>(lastInputSamples[index], offset);
-        if (++index == 5)
-            index = 0;
-        result += calcCoefficient<2>(lastInputSamples[index], offset);
-        if (++index == 5)
-            index = 0;
-        result += calcCoefficient<3>(lastInputSamples[index], offset);
-        if (++index == 5)
-            index = 0;
-        result += calcCoefficient<4>(lastInputSamples[index], offset);
-
-        return result;
+    case InterpolationType::Linear:
+        return std::make_unique<PlanarLinearInterpolator>(numChannels);
+    case InterpolationType::Lagrange:
+        break;
+    case InterpolationType::SincMedium:
+        if (bank != nullptr && bank->getNumTaps() == 16)
+            return makeMultichannelInterpolator(numChannels, SincKernel<16>{std::move(bank)});
+        break;
+    case InterpolationType::SincHigh:
+        if (bank != nullptr && bank->getNumTaps() == 32)
+            return makeMultichannelInterpolator(numChannels, SincKernel<32>{std::move(bank)});
+        break;
     }
-
-    float lastInputSamples[5];
-    double subSamplePos;
-    int indexBuffer{0};
-};
+    return makeMultichannelInterpolator<LagrangeKernel>(numChannels);
+}
 
 } // namespace atk
 
+// Wait-free single-producer/single-consumer multichannel FIFO.
+// One thread may call write() while another calls read()/advanceRead(); neither ever blocks or
+// gives up on the other. Each block is published to the reader only after every channel has been
+// copied, via the release store of the write index. setSize() must not overlap read or write.
 class FifoBuffer2
 {
 public:
@@ -307,24 +457,18 @@ public:
 
     void setSize(int numChannels, int numSamples)
     {
-        std::lock_guard<std::mutex> lock1(writeLock);
-        std::lock_guard<std::mutex> lock2(readLock);
-
-        buffer.setSize(numChannels, numSamples + 1);
+        buffer.setSize(numChannels, numSamples);
     }
 
+    // Returns the number of samples written per channel; less than numSamples only if the FIFO is full
     int write(const float* const* src, int numChannels, int numSamples)
     {
-        std::unique_lock<std::mutex> lock(writeLock, std::try_to_lock);
-        if (!lock.owns_lock())
-            return 0;
-
         numChannels = std::min(numChannels, buffer.getNumChannels());
 
-        int freeSpace = buffer.getFreeSpace();
-        int toWrite = std::min(numSamples, freeSpace);
+        // Free space can only grow while we copy, so every channel gets exactly toWrite samples
+        const int toWrite = std::min(numSamples, buffer.getFreeSpace());
 
-        if (toWrite <= 0)
+        if (toWrite <= 0 || numChannels <= 0)
             return 0;
 
         for (int ch = 0; ch < numChannels; ++ch)
@@ -344,33 +488,19 @@ public:
         bool addToBuffer = false
     )
     {
-        std::unique_lock<std::mutex> lock(readLock, std::try_to_lock);
-        if (!lock.owns_lock())
-            return 0;
-
         numChannels = std::min(numChannels, buffer.getNumChannels());
 
-        int available = buffer.getNumReady();
-        int toRead = std::min(numSamples, available);
+        // Available samples can only grow while we copy, so every channel gets exactly toRead samples
+        const int toRead = std::min(numSamples, buffer.getNumReady());
 
         if (toRead <= 0)
             return 0;
 
-        if (addToBuffer)
-        {
-            if (tempReadBuffer.size() < static_cast<size_t>(toRead))
-                tempReadBuffer.resize(toRead);
-
-            for (int ch = 0; ch < numChannels; ++ch)
-            {
-                buffer.read(tempReadBuffer.data(), ch, toRead, false);
-                for (int i = 0; i < toRead; ++i)
-                    dest[ch][i] += tempReadBuffer[i];
-            }
-        }
-        else
+        for (int ch = 0; ch < numChannels; ++ch)
         {
-            for (int ch = 0; ch < numChannels; ++ch)
+            if (addToBuffer)
+                buffer.readAdding(dest[ch], ch, toRead);
+            else
                 buffer.read(dest[ch], ch, toRead, false);
         }
 
@@ -397,11 +527,6 @@ public:
 
 private:
     atk::FifoBuffer buffer;
-
-    std::vector<float> tempReadBuffer;
-
-    std::mutex writeLock;
-    std::mutex readLock;
 };
 
 class SyncBuffer
@@ -414,7 +539,8 @@ public:
         , writerBufferSize(-1)
         , targetLevelFactor(TARGET_SAFETY_BUFFER_LEVEL)
         , hysteresis(0.5)
-        , interpolationType(atk::InterpolationType::Lagrange)
+        , interpolationType(atk::defaultInterpolationType.load(std::memory_order_relaxed))
+        , adaptiveTarget(atk::defaultAdaptiveTarget.load(std::memory_order_relaxed))
     {
     }
 
@@ -423,9 +549,11 @@ public:
         tag = debugTag;
     }
 
+    // Pins the target, so it also turns the adaptive target off
     void setTargetLevelFactor(float factor)
     {
         targetLevelFactor.store(factor, std::memory_order_release);
+        adaptiveTarget.store(false, std::memory_order_release);
     }
 
     float getTargetLevelFactor() const
@@ -451,7 +579,7 @@ public:
         if (interpolationType != type)
         {
             interpolationType = type;
-            isPrepared = false; // Force re-prepare to recreate interpolators
+            isPrepared = false; // Force re-prepare to recreate the interpolator
         }
     }
 
@@ -460,8 +588,143 @@ public:
         return interpolationType;
     }
 
+    // Number of reads the drift estimate looks back over. Longer windows correct more smoothly
+    // but react more slowly; the cost per read doesn't depend on the length.
+    void setLevelHistorySize(int numReads)
+    {
+        std::lock_guard<std::mutex> lock1(writeLock);
+        std::lock_guard<std::mutex> lock2(readLock);
+
+        numReads = std::clamp(numReads, MIN_LEVEL_HISTORY_SIZE, MAX_LEVEL_HISTORY_SIZE);
+        if (numReads != levelHistory.getWindowSize())
+        {
+            levelHistory.setWindowSize(numReads);
+            bufferCompensation = 0.0;
+            wasAtTargetLevel = false;
+        }
+    }
+
+    int getLevelHistorySize()
+    {
+        std::lock_guard<std::mutex> lock(readLock);
+        return levelHistory.getWindowSize();
+    }
+
+    // Adaptive mode replaces the fixed target level factor with the smallest one whose headroom
+    // covers the measured callback jitter of both sides, so that on average no more than
+    // maxUnderrunProbability of reads find the buffer short. Hysteresis is capped so the lower
+    // threshold never drops below one reader block.
+    void setAdaptiveTargetEnabled(bool enabled)
+    {
+        adaptiveTarget.store(enabled, std::memory_order_release);
+    }
+
+    bool isAdaptiveTargetEnabled() const
+    {
+        return adaptiveTarget.load(std::memory_order_acquire);
+    }
+
+    void setMaxUnderrunProbability(float probability)
+    {
+        maxUnderrunProbability.store(std::clamp(probability, 1.0e-6f, 0.5f), std::memory_order_release);
+    }
+
+    float getMaxUnderrunProbability() const
+    {
+        return maxUnderrunProbability.load(std::memory_order_acquire);
+    }
+
+    // Monitoring; safe from any thread. Zero until the drift estimate has a full history window.
+    int getTargetLevel() const
+    {
+        return currentTargetLevel.load(std::memory_order_relaxed);
+    }
+
+    float getTargetLevelFactorInUse() const
+    {
+        return currentTargetFactor.load(std::memory_order_relaxed);
+    }
+
+    // RMS callback arrival jitter of the writing and reading sides, in milliseconds
+    float getWriterJitterMs() const
+    {
+        return writerTiming.getRms() * 1000.0f;
+    }
+
+    float getReaderJitterMs() const
+    {
+        return readerTiming.getRms() * 1000.0f;
+    }
+
+    // Source of the callback timestamps (seconds) behind the jitter estimate. Defaults to the
+    // steady clock; simulations substitute their own timeline. Pass nullptr to restore the default.
+    using Clock = double (*)(void* context);
+
+    void setClock(Clock newClock, void* context)
+    {
+        std::lock_guard<std::mutex> lock1(writeLock);
+        std::lock_guard<std::mutex> lock2(readLock);
+
+        clock = newClock;
+        clockContext = context;
+        resetJitterEstimates();
+    }
+
+    // Reads from a shared BroadcastFifo instead of this buffer's own FIFO; write() is then unused.
+    // Only `channels` of the source are read, in that order, so the reader sees channels.size()
+    // channels. The cursor, drift estimate and interpolator stay per SyncBuffer; the writer's rate
+    // and timing come from the source. Changing only the channels keeps the read position, so the
+    // level carries over. Pass nullptr to go back to write().
+    void setSource(std::shared_ptr<const atk::BroadcastFifo> newSource, std::vector<int> channels)
+    {
+        std::lock_guard<std::mutex> lock1(writeLock);
+        std::lock_guard<std::mutex> lock2(readLock);
+
+        if (newSource == source && channels == sourceChannels)
+            return;
+
+        if (newSource != source)
+        {
+            source = std::move(newSource);
+            if (source)
+                source->resync(sourceCursor);
+        }
+
+        sourceChannels = std::move(channels);
+        if (source)
+            writerNumChannels = static_cast<int>(sourceChannels.size());
+        isPrepared = false;
+    }
+
+    // Lock-free; safe from any thread, including while audio runs
+    atk::SyncBufferStats getStats() const
+    {
+        atk::SyncBufferStats stats;
+        stats.isPrepared = isPrepared.load(std::memory_order_acquire);
+        stats.currentLevel = statLevel.load(std::memory_order_relaxed);
+        stats.minLevel = statMinLevel.load(std::memory_order_relaxed);
+        stats.maxLevel = statMaxLevel.load(std::memory_order_relaxed);
+        stats.targetLevel = currentTargetLevel.load(std::memory_order_relaxed);
+        stats.appliedRatio = statRatio.load(std::memory_order_relaxed);
+        const double writerError = writerTiming.getClockError();
+        const double readerError = readerTiming.getClockError();
+        stats.driftPpm = ((1.0 + writerError) / (1.0 + readerError) - 1.0) * 1.0e6;
+        stats.writerJitterMs = getWriterJitterMs();
+        stats.readerJitterMs = getReaderJitterMs();
+        stats.underflows = underflowCount.load(std::memory_order_relaxed);
+        stats.overflows = overflowCount.load(std::memory_order_relaxed);
+        stats.resets = resetCount.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    static constexpr int DEFAULT_LEVEL_HISTORY_SIZE = 1024;
+    static constexpr int MIN_LEVEL_HISTORY_SIZE = 16;
+    static constexpr int MAX_LEVEL_HISTORY_SIZE = 65536;
+
     int getNumReady()
     {
+        if (source)
+            return std::max(0, source->getNumReady(sourceCursor));
         return fifoBuffer.getBuffer().getNumReady();
     }
 
@@ -481,15 +744,15 @@ public:
         std::lock_guard<std::mutex> lock2(readLock);
 
         fifoBuffer.getBuffer().reset();
+        if (source)
+            source->resync(sourceCursor);
+        countEvent(resetCount);
 
-        for (auto& interp : interpolators)
-            if (interp)
-                interp->reset();
+        if (interpolator)
+            interpolator->reset();
 
-        readCallCount = 0;
-        historyIndex = 0;
-        if (!bufferLevelHistory.empty())
-            bufferLevelHistory.assign(BUFFER_HISTORY_SIZE, readerBufferSize);
+        levelHistory.reset();
+        resetJitterEstimates();
 
         bufferCompensation = 0.0;
         wasAtTargetLevel = false;
@@ -525,27 +788,34 @@ public:
         }
 
         numChannels = std::max(readerNumChannels, writerNumChannels);
+        countEvent(resetCount);
 
-        interpolators.clear();
-        interpolators.reserve(writerNumChannels);
+        // The filter bank is designed for the nominal rate pair
+        preparedRatio = writerSampleRate / readerSampleRate;
+        std::shared_ptr<const atk::SincFilterBank> sincBank;
+        if (atk::isSincInterpolation(interpolationType))
+            sincBank = atk::SincFilterBank::create(interpolationType, preparedRatio);
 
-        for (int i = 0; i < writerNumChannels; ++i)
-            if (interpolationType == atk::InterpolationType::Linear)
-                interpolators.push_back(std::make_unique<atk::LinearInterpolator>());
-            else
-                interpolators.push_back(std::make_unique<atk::LagrangeInterpolator>());
+        interpolator = atk::createMultichannelInterpolator(interpolationType, writerNumChannels, sincBank);
 
-        fifoBuffer.setSize(numChannels, FIXED_BUFFER_SIZE);
+        // With a source the samples stay there, and the cursor keeps its place
+        fifoBuffer.setSize(source ? 0 : numChannels, FIXED_BUFFER_SIZE);
 
+        lockedTempBuffers.clear();
         tempBuffer.resize(numChannels);
         for (auto& channel : tempBuffer)
             channel.resize(FIXED_BUFFER_SIZE);
+        lockTempBuffers();
 
         tempPtrs.resize(numChannels);
+        outputPtrs.resize(numChannels);
+
+        lockedFoldBuffer.release();
+        foldBuffer.assign(static_cast<size_t>(std::max(0, writerNumChannels - 1)) * readerBufferSize, 0.0f);
+        lockFoldBuffer();
 
-        readCallCount = 0;
-        historyIndex = 0;
-        bufferLevelHistory.assign(BUFFER_HISTORY_SIZE, readerBufferSize);
+        levelHistory.reset();
+        resetJitterEstimates();
 
         bufferCompensation = 0.0;
         wasAtTargetLevel = false;
@@ -556,12 +826,14 @@ public:
     int write(const float* const* src, int numChannels, int numSamples, double sampleRate)
     {
         std::unique_lock<std::mutex> lock(writeLock, std::try_to_lock);
-        if (!lock.owns_lock())
+        if (!lock.owns_lock() || source)
             return 0;
 
         writerSampleRate = sampleRate;
         writerBufferSize = numSamples;
 
+        writerTiming.addCallback(nowSeconds(), numSamples, sampleRate, getQuantileProbability());
+
         if (writerNumChannels < numChannels)
         {
             writerNumChannels = numChannels;
@@ -571,7 +843,10 @@ public:
         if (!isPrepared.load(std::memory_order_acquire))
             return 0;
 
-        return fifoBuffer.write(src, numChannels, numSamples);
+        const int written = fifoBuffer.write(src, numChannels, numSamples);
+        if (written < numSamples)
+            countEvent(overflowCount);
+        return written;
     }
 
     bool read(
@@ -589,12 +864,27 @@ public:
         readerSampleRate = sampleRate;
         readerBufferSize = numSamples > readerBufferSize ? numSamples : readerBufferSize;
 
+        if (source)
+            refreshWriterFromSource();
+
+        readerTiming.addCallback(nowSeconds(), numSamples, sampleRate, getQuantileProbability());
+
         if (readerNumChannels < numChannels)
         {
             readerNumChannels = numChannels;
             isPrepared.store(false, std::memory_order_release);
         }
 
+        // A sinc bank's cutoff is designed for one rate pair; redesign if the device rates changed.
+        // Drift compensation stays well inside the 1% tolerance.
+        if (atk::isSincInterpolation(interpolationType)
+            && writerSampleRate > 0.0
+            && readerSampleRate > 0.0
+            && std::abs(writerSampleRate / readerSampleRate - preparedRatio) > 0.01 * preparedRatio)
+        {
+            isPrepared.store(false, std::memory_order_release);
+        }
+
         if (!isPrepared.load(std::memory_order_acquire) //
             && writerNumChannels > 0
             && writerSampleRate > 0.0
@@ -615,29 +905,54 @@ public:
 
         auto ratio = writerSampleRate / readerSampleRate;
 
-        int samplesInFifo = fifoBuffer.getFifo().getNumReady();
+        int samplesInFifo = getWriterSamplesReady();
 
-        bufferLevelHistory[historyIndex] = samplesInFifo;
-        readCallCount++;
-        historyIndex = (historyIndex + 1) % BUFFER_HISTORY_SIZE;
+        levelHistory.push(samplesInFifo);
+        statLevel.store(samplesInFifo, std::memory_order_relaxed);
+        statMinLevel.store(levelHistory.getMin(), std::memory_order_relaxed);
+        statMaxLevel.store(levelHistory.getMax(), std::memory_order_relaxed);
 
-        if (readCallCount >= BUFFER_HISTORY_SIZE)
+        if (levelHistory.isFull())
         {
-            int minBufferLevel = samplesInFifo;
-            int maxBaseLevel = 0;
-            for (int i = 0; i < BUFFER_HISTORY_SIZE; ++i)
-            {
-                minBufferLevel = std::min(minBufferLevel, bufferLevelHistory[i]);
-                maxBaseLevel = std::max(maxBaseLevel, bufferLevelHistory[i]);
-            }
+            const int maxBaseLevel = levelHistory.getMax();
+
+            // Until the window has seen writes land between reads at every phase, the lowest level
+            // a read can meet may be up to one writer block below the observed minimum. With nearly
+            // equal periods that phase only comes round at a crossing, minutes apart, and a slow
+            // writer then skips a block between two reads.
+            const int minBufferLevel = std::min(levelHistory.getMin(), maxBaseLevel - writerBufferSize);
 
             int baseTargetLevel =
                 std::min(static_cast<int>(std::ceil(readerBufferSize * ratio)), maxBaseLevel);
 
             float targetFactor = targetLevelFactor.load(std::memory_order_acquire);
             float hyst = hysteresis.load(std::memory_order_acquire);
+
+            const float writerQuantile = writerTiming.getQuantile();
+            const float readerQuantile = readerTiming.getQuantile();
+            if (adaptiveTarget.load(std::memory_order_acquire)
+                && writerQuantile >= 0.0f
+                && readerQuantile >= 0.0f
+                && baseTargetLevel > 0)
+            {
+                // A late writer and an early reader both eat into the margin, so their worst
+                // cases add up
+                const double headroom = (writerQuantile + readerQuantile) * writerSampleRate;
+                targetFactor = static_cast<float>(std::clamp(
+                    1.0 + headroom / baseTargetLevel,
+                    static_cast<double>(MIN_ADAPTIVE_TARGET_FACTOR),
+                    static_cast<double>(MAX_ADAPTIVE_TARGET_FACTOR)
+                ));
+                hyst = std::min(hyst, targetFactor - 1.0f);
+            }
+
             int targetLevel = static_cast<int>(baseTargetLevel * targetFactor);
-            int lowThreshold = static_cast<int>(baseTargetLevel * (targetFactor - hyst));
+            currentTargetLevel.store(targetLevel, std::memory_order_relaxed);
+            currentTargetFactor.store(targetFactor, std::memory_order_relaxed);
+            // The level moves in whole blocks, so a minimum sitting exactly on what one read consumes
+            // gives no warning before the next step down underflows; keep the floor above it
+            int lowThreshold =
+                std::max(static_cast<int>(baseTargetLevel * (targetFactor - hyst)), baseTargetLevel + 1);
             int highThreshold = static_cast<int>(baseTargetLevel * (targetFactor + hyst));
 
             // Hysteresis: only adjust when outside [low, high] range
@@ -645,7 +960,7 @@ public:
             {
                 int error = minBufferLevel - targetLevel;
                 int64_t windowSamples =
-                    static_cast<int64_t>(readerBufferSize) * BUFFER_HISTORY_SIZE;
+                    static_cast<int64_t>(readerBufferSize) * levelHistory.getWindowSize();
                 bufferCompensation = static_cast<double>(error) / windowSamples;
                 wasAtTargetLevel = (minBufferLevel >= lowThreshold);
             }
@@ -687,12 +1002,18 @@ public:
             for (int ch = 0; ch < numChannels; ++ch)
                 std::memset(dest[ch], 0, sizeof(float) * numSamples);
 
-        if (tempBuffer.size() < static_cast<size_t>(writerNumChannels))
-            tempBuffer.resize(writerNumChannels);
-        if (tempBuffer.size() > 0
-            && tempBuffer[0].size() < static_cast<size_t>(writerSamplesNeeded))
-            for (auto& channel : tempBuffer)
-                channel.resize(writerSamplesNeeded);
+        if (tempBuffer.size() < static_cast<size_t>(writerNumChannels)
+            || (tempBuffer.size() > 0
+                && tempBuffer[0].size() < static_cast<size_t>(writerSamplesNeeded)))
+        {
+            lockedTempBuffers.clear();
+            if (tempBuffer.size() < static_cast<size_t>(writerNumChannels))
+                tempBuffer.resize(writerNumChannels);
+            if (tempBuffer[0].size() < static_cast<size_t>(writerSamplesNeeded))
+                for (auto& channel : tempBuffer)
+                    channel.resize(writerSamplesNeeded);
+            lockTempBuffers();
+        }
 
         if (tempPtrs.size() < static_cast<size_t>(writerNumChannels))
             tempPtrs.resize(writerNumChannels);
@@ -700,15 +1021,19 @@ public:
         for (int ch = 0; ch < writerNumChannels; ++ch)
             tempPtrs[ch] = tempBuffer[ch].data();
 
-        auto writerSamples =
-            fifoBuffer.read(tempPtrs.data(), writerNumChannels, writerSamplesNeeded, false);
+        auto writerSamples = peekWriterSamples(writerSamplesNeeded);
 
         if (writerSamples == 0)
+        {
+            countEvent(underflowCount);
             return false;
+        }
 
         auto finalRatio = compensatedRatio;
         if (writerSamples < writerSamplesNeeded)
         {
+            countEvent(underflowCount);
+
             double availabilityFactor = static_cast<double>(writerSamples) / writerSamplesNeeded;
             finalRatio = compensatedRatio * availabilityFactor;
 
@@ -719,12 +1044,8 @@ public:
             oss << std::put_time(std::localtime(&time_t_now), "%H:%M:%S");
             auto timestamp = oss.str();
 
-            int histMin = samplesInFifo, histMax = 0;
-            for (int i = 0; i < BUFFER_HISTORY_SIZE; ++i)
-            {
-                histMin = std::min(histMin, bufferLevelHistory[i]);
-                histMax = std::max(histMax, bufferLevelHistory[i]);
-            }
+            const int histMin = levelHistory.getMin();
+            const int histMax = levelHistory.getMax();
 
             DBG("[SYNC] "
                 << (tag.isNotEmpty() ? tag + " " : "")
@@ -743,43 +1064,46 @@ public:
                 << juce::String(finalRatio, 4));
 #endif
         }
-        int maxSamplesConsumed = 0;
+        // Source channels beyond the reader's are rendered into foldBuffer, then mixed onto
+        // dest[srcCh % numChannels] with a power-preserving gain
+        const int numFolded = std::max(0, writerNumChannels - numChannels);
+        if (foldBuffer.size() < static_cast<size_t>(numFolded) * numSamples)
+        {
+            lockedFoldBuffer.release();
+            foldBuffer.resize(static_cast<size_t>(numFolded) * numSamples);
+            lockFoldBuffer();
+        }
 
-        auto channelGain = 1.0f;
-        if (writerNumChannels > numChannels)
-            channelGain =
-                static_cast<float>(std::sqrt(static_cast<double>(numChannels) / writerNumChannels));
+        if (outputPtrs.size() < static_cast<size_t>(writerNumChannels))
+            outputPtrs.resize(writerNumChannels);
 
         for (int srcCh = 0; srcCh < writerNumChannels; ++srcCh)
+            outputPtrs[srcCh] = srcCh < numChannels
+                                  ? dest[srcCh]
+                                  : foldBuffer.data() + static_cast<size_t>(srcCh - numChannels) * numSamples;
+
+        int samplesProduced = 0;
+        const int maxSamplesConsumed = interpolator->process(
+            finalRatio,
+            tempPtrs.data(),
+            writerSamples,
+            outputPtrs.data(),
+            numSamples,
+            samplesProduced
+        );
+
+        if (numFolded > 0)
         {
-            int destCh = srcCh % numChannels;
+            const auto channelGain =
+                static_cast<float>(std::sqrt(static_cast<double>(numChannels) / writerNumChannels));
 
-            int samplesConsumed;
-            if (srcCh < numChannels)
-            {
-                samplesConsumed = interpolators[srcCh]->process(
-                    finalRatio,
-                    tempBuffer[srcCh].data(),
-                    dest[destCh],
-                    numSamples,
-                    writerSamples,
-                    0
-                );
-            }
-            else
+            for (int srcCh = numChannels; srcCh < writerNumChannels; ++srcCh)
             {
-                samplesConsumed = interpolators[srcCh]->processAdding(
-                    finalRatio,
-                    tempBuffer[srcCh].data(),
-                    dest[destCh],
-                    numSamples,
-                    writerSamples,
-                    0,
-                    channelGain
-                );
+                float* out = dest[srcCh % numChannels];
+                const float* folded = outputPtrs[srcCh];
+                for (int i = 0; i < samplesProduced; ++i)
+                    out[i] += channelGain * folded[i];
             }
-
-            maxSamplesConsumed = std::max(maxSamplesConsumed, samplesConsumed);
         }
 
         int samplesToAdvance = std::min(maxSamplesConsumed, writerSamples);
@@ -793,12 +1117,8 @@ public:
             oss << std::put_time(std::localtime(&time_t_now), "%H:%M:%S");
             auto timestamp = oss.str();
 
-            int histMin = samplesInFifo, histMax = 0;
-            for (int i = 0; i < BUFFER_HISTORY_SIZE; ++i)
-            {
-                histMin = std::min(histMin, bufferLevelHistory[i]);
-                histMax = std::max(histMax, bufferLevelHistory[i]);
-            }
+            const int histMin = levelHistory.getMin();
+            const int histMax = levelHistory.getMax();
 
             DBG("[SYNC] "
                 << (tag.isNotEmpty() ? tag + " " : "")
@@ -816,7 +1136,11 @@ public:
 #endif
         }
 
-        fifoBuffer.advanceRead(samplesToAdvance);
+        if (source)
+            source->advance(sourceCursor, samplesToAdvance);
+        else
+            fifoBuffer.advanceRead(samplesToAdvance);
+        statRatio.store(finalRatio, std::memory_order_relaxed);
 
         return true;
     }
@@ -827,16 +1151,111 @@ public:
     }
 
 private:
+    void lockTempBuffers()
+    {
+        lockedTempBuffers.resize(tempBuffer.size());
+        for (size_t ch = 0; ch < tempBuffer.size(); ++ch)
+            lockedTempBuffers[ch].lock(tempBuffer[ch].data(), tempBuffer[ch].size() * sizeof(float));
+    }
+
+    // Read side: with a source, what write() would have recorded about the writer comes from there
+    void refreshWriterFromSource()
+    {
+        writerTiming.publishFrom(source->getWriterTiming());
+
+        const double sourceRate = source->getSampleRate();
+        const int sourceBlockSize = source->getBlockSize();
+        if (sourceRate > 0.0)
+            writerSampleRate = sourceRate;
+        if (sourceBlockSize > 0)
+            writerBufferSize = sourceBlockSize;
+    }
+
+    // A cursor the source's writer has lapped lost samples the way a full FIFO drops a write, so it
+    // counts as an overflow, and it starts over empty
+    int getWriterSamplesReady()
+    {
+        if (!source)
+            return fifoBuffer.getFifo().getNumReady();
+
+        const int ready = source->getNumReady(sourceCursor);
+        if (ready >= 0)
+            return ready;
+
+        countEvent(overflowCount);
+        source->resync(sourceCursor);
+        return 0;
+    }
+
+    int peekWriterSamples(int numSamples)
+    {
+        if (!source)
+            return fifoBuffer.read(tempPtrs.data(), writerNumChannels, numSamples, false);
+
+        const int numRead =
+            source->peek(sourceCursor, tempPtrs.data(), sourceChannels.data(), writerNumChannels, numSamples);
+        if (numRead >= 0)
+            return numRead;
+
+        countEvent(overflowCount);
+        source->resync(sourceCursor);
+        return 0;
+    }
+
+    // Callback timestamps (seconds) for the jitter estimates
+    double nowSeconds() const
+    {
+        if (clock != nullptr)
+            return clock(clockContext);
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Union bound: each side may take half of the allowed underrun probability
+    double getQuantileProbability() const
+    {
+        return 1.0 - 0.5 * maxUnderrunProbability.load(std::memory_order_relaxed);
+    }
+
+    // Only with both locks held
+    void resetJitterEstimates()
+    {
+        writerTiming.reset();
+        readerTiming.reset();
+        currentTargetLevel.store(0, std::memory_order_relaxed);
+        currentTargetFactor.store(0.0f, std::memory_order_relaxed);
+    }
+
+    // Each counter has a single writing side (or is written under both locks; with a source the
+    // overflow count belongs to the read side), so a plain relaxed load and store is enough and
+    // the audio path never does a read-modify-write
+    static void countEvent(std::atomic<uint64_t>& counter)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    void lockFoldBuffer()
+    {
+        if (!foldBuffer.empty())
+            lockedFoldBuffer.lock(foldBuffer.data(), foldBuffer.size() * sizeof(float));
+    }
+
     juce::String tag;
     std::atomic_bool isPrepared{false};
     int numChannels{0};
 
     FifoBuffer2 fifoBuffer;
-    std::vector<std::unique_ptr<atk::Interpolator>> interpolators;
+    std::shared_ptr<const atk::BroadcastFifo> source;
+    std::vector<int> sourceChannels;
+    atk::BroadcastFifo::Cursor sourceCursor;
+    std::unique_ptr<atk::MultichannelInterpolator> interpolator;
     atk::InterpolationType interpolationType;
 
     std::vector<std::vector<float>> tempBuffer;
+    std::vector<atk::rtmemory::LockedRegion> lockedTempBuffers;
     std::vector<float*> tempPtrs;
+    std::vector<float*> outputPtrs;
+    std::vector<float> foldBuffer;
+    atk::rtmemory::LockedRegion lockedFoldBuffer;
 
     int readerBufferSize{0};
     int writerBufferSize{0};
@@ -845,12 +1264,10 @@ private:
 
     double readerSampleRate{0.0};
     double writerSampleRate{0.0};
+    double preparedRatio{1.0};
 
-    static constexpr int BUFFER_HISTORY_SIZE = 1024;
-
-    std::vector<int> bufferLevelHistory;
-    int historyIndex{0};
-    int readCallCount{0};
+    // Fill level sampled once per read; its min/max over the window steer drift compensation
+    atk::SlidingMinMax<int> levelHistory{DEFAULT_LEVEL_HISTORY_SIZE};
 
     double bufferCompensation{0.0};
     bool wasAtTargetLevel{false};
@@ -858,6 +1275,30 @@ private:
     std::atomic<float> targetLevelFactor{1.5f};
     std::atomic<float> hysteresis{0.5f};
 
+    static constexpr float MIN_ADAPTIVE_TARGET_FACTOR = 1.05f;
+    static constexpr float MAX_ADAPTIVE_TARGET_FACTOR = 4.0f;
+
+    Clock clock{nullptr};
+    void* clockContext{nullptr};
+
+    std::atomic<bool> adaptiveTarget{false};
+    std::atomic<float> maxUnderrunProbability{1.0e-3f};
+
+    // Each estimator is only fed by its own side; the results cross over through its atomics
+    atk::PublishedJitter writerTiming;
+    atk::PublishedJitter readerTiming;
+    std::atomic<int> currentTargetLevel{0};
+    std::atomic<float> currentTargetFactor{0.0f};
+
+    // Telemetry published for getStats()
+    std::atomic<int> statLevel{0};
+    std::atomic<int> statMinLevel{0};
+    std::atomic<int> statMaxLevel{0};
+    std::atomic<double> statRatio{0.0};
+    std::atomic<uint64_t> underflowCount{0};
+    std::atomic<uint64_t> overflowCount{0};
+    std::atomic<uint64_t> resetCount{0};
+
     std::mutex readLock;
     std::mutex writeLock;
 };
@@ -1,5 +1,9 @@
 #include "GlobalSettings.h"
 
+#include "Denormals.h"
+#include "FifoBuffer2.h"
+#include "RealtimeMemory.h"
+
 #include <atkaudio/atkaudio.h>
 
 #include <juce_core/juce_core.h>
@@ -10,6 +14,10 @@
 namespace
 {
 constexpr const char* kLoggingEnabledKey = "global.logging.enabled";
+constexpr const char* kFlushDenormalsKey = "global.audio.flushDenormals";
+constexpr const char* kLockRealtimeMemoryKey = "global.audio.lockMemory";
+constexpr const char* kResamplerQualityKey = "global.audio.resamplerQuality";
+constexpr const char* kAdaptiveLatencyKey = "global.audio.adaptiveLatency";
 
 enum class SettingsLifecycleState
 {
@@ -23,6 +31,14 @@ std::unique_ptr<juce::PropertiesFile> g_settingsFile;
 SettingsLifecycleState g_settingsLifecycleState = SettingsLifecycleState::idle;
 bool g_loggingEnabled = false;
 
+void applyResamplerQuality(int quality)
+{
+    const auto type = static_cast<atk::InterpolationType>(
+        juce::jlimit(0, static_cast<int>(atk::InterpolationType::SincHigh), quality)
+    );
+    atk::defaultInterpolationType.store(type, std::memory_order_relaxed);
+}
+
 void ensureSettingsLoaded()
 {
     if (g_settingsLifecycleState == SettingsLifecycleState::shutdown)
@@ -38,6 +54,13 @@ void ensureSettingsLoaded()
     g_settingsFile = std::make_unique<juce::PropertiesFile>(atk::getSettingsFile("atkAudio Plugin for OBS"), options);
 
     g_loggingEnabled = g_settingsFile->getBoolValue(kLoggingEnabledKey, false);
+    atk::denormals::setFlushToZeroEnabled(g_settingsFile->getBoolValue(kFlushDenormalsKey, true));
+    atk::rtmemory::setLockingEnabled(g_settingsFile->getBoolValue(kLockRealtimeMemoryKey, false));
+    applyResamplerQuality(g_settingsFile->getIntValue(kResamplerQualityKey, 1));
+    atk::defaultAdaptiveTarget.store(
+        g_settingsFile->getBoolValue(kAdaptiveLatencyKey, false),
+        std::memory_order_relaxed
+    );
     g_settingsLifecycleState = SettingsLifecycleState::active;
 }
 } // namespace
@@ -91,3 +114,105 @@ void atk::settings::setLoggingEnabled(bool enabled)
         g_settingsFile->saveIfNeeded();
     }
 }
+
+bool atk::settings::isFlushDenormalsEnabled()
+{
+    const std::lock_guard<std::mutex> lock(g_settingsMutex);
+
+    ensureSettingsLoaded();
+    return atk::denormals::isFlushToZeroEnabled();
+}
+
+void atk::settings::setFlushDenormalsEnabled(bool enabled)
+{
+    const std::lock_guard<std::mutex> lock(g_settingsMutex);
+
+    if (g_settingsLifecycleState != SettingsLifecycleState::shutdown)
+        ensureSettingsLoaded();
+
+    // Audio threads pick this up on their next callback
+    atk::denormals::setFlushToZeroEnabled(enabled);
+
+    if (g_settingsFile != nullptr)
+    {
+        g_settingsFile->setValue(kFlushDenormalsKey, enabled);
+        g_settingsFile->saveIfNeeded();
+    }
+}
+
+bool atk::settings::isLockRealtimeMemoryEnabled()
+{
+    const std::lock_guard<std::mutex> lock(g_settingsMutex);
+
+    ensureSettingsLoaded();
+    return atk::rtmemory::isLockingEnabled();
+}
+
+void atk::settings::setLockRealtimeMemoryEnabled(bool enabled)
+{
+    const std::lock_guard<std::mutex> lock(g_settingsMutex);
+
+    if (g_settingsLifecycleState != SettingsLifecycleState::shutdown)
+        ensureSettingsLoaded();
+
+    atk::rtmemory::setLockingEnabled(enabled);
+
+    if (g_settingsFile != nullptr)
+    {
+        g_settingsFile->setValue(kLockRealtimeMemoryKey, enabled);
+        g_settingsFile->saveIfNeeded();
+    }
+}
+
+int atk::settings::getResamplerQuality()
+{
+    const std::lock_guard<std::mutex> lock(g_settingsMutex);
+
+    ensureSettingsLoaded();
+    return static_cast<int>(atk::defaultInterpolationType.load(std::memory_order_relaxed));
+}
+
+void atk::settings::setResamplerQuality(int quality)
+{
+    const std::lock_guard<std::mutex> lock(g_settingsMutex);
+
+    if (g_settingsLifecycleState != SettingsLifecycleState::shutdown)
+        ensureSettingsLoaded();
+
+    // New SyncBuffers pick this up; open devices keep their interpolators
+    applyResamplerQuality(quality);
+
+    if (g_settingsFile != nullptr)
+    {
+        g_settingsFile->setValue(
+            kResamplerQualityKey,
+            static_cast<int>(atk::defaultInterpolationType.load(std::memory_order_relaxed))
+        );
+        g_settingsFile->saveIfNeeded();
+    }
+}
+
+bool atk::settings::isAdaptiveDeviceLatencyEnabled()
+{
+    const std::lock_guard<std::mutex> lock(g_settingsMutex);
+
+    ensureSettingsLoaded();
+    return atk::defaultAdaptiveTarget.load(std::memory_order_relaxed);
+}
+
+void atk::settings::setAdaptiveDeviceLatencyEnabled(bool enabled)
+{
+    const std::lock_guard<std::mutex> lock(g_settingsMutex);
+
+    if (g_settingsLifecycleState != SettingsLifecycleState::shutdown)
+        ensureSettingsLoaded();
+
+    // New SyncBuffers pick this up; open devices keep their current target
+    atk::defaultAdaptiveTarget.store(enabled, std::memory_order_relaxed);
+
+    if (g_settingsFile != nullptr)
+    {
+        g_settingsFile->setValue(kAdaptiveLatencyKey, enabled);
+        g_settingsFile->saveIfNeeded();
+    }
+}
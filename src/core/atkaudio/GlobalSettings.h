@@ -7,4 +7,22 @@ void shutdown();
 
 bool isLoggingEnabled();
 void setLoggingEnabled(bool enabled);
+
+// Flush-to-zero / denormals-are-zero on realtime audio threads (default on).
+bool isFlushDenormalsEnabled();
+void setFlushDenormalsEnabled(bool enabled);
+
+// mlock + prefault realtime buffers and worker stacks (default off). Applies to buffers allocated afterwards.
+bool isLockRealtimeMemoryEnabled();
+void setLockRealtimeMemoryEnabled(bool enabled);
+
+// Device bridge SyncBuffer interpolation: 0 linear, 1 Lagrange (default), 2 sinc 16 taps, 3 sinc 32 taps.
+// Applies to devices opened afterwards.
+int getResamplerQuality();
+void setResamplerQuality(int quality);
+
+// Device bridge SyncBuffers size their latency from measured callback jitter instead of a fixed
+// 1.5 blocks (default off). Applies to devices opened afterwards.
+bool isAdaptiveDeviceLatencyEnabled();
+void setAdaptiveDeviceLatencyEnabled(bool enabled);
 } // namespace atk::settings
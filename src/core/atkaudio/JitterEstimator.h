@@ -0,0 +1,218 @@
+// Copyright (c) 2025 atkAudio
+// Callback arrival jitter, and the effective sample rate of a device measured against the steady clock
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+
+namespace atk
+{
+
+// Fed once per callback from the callback's own thread; not thread-safe.
+// A callback is expected one block after the previous one (previous numSamples / sampleRate).
+// The deviation from that, minus its running mean (clock skew between the device and the
+// steady clock), is the jitter. Its magnitude goes into a log-spaced histogram whose counts are
+// halved every AGE_INTERVAL callbacks, so quantiles track the last few thousand callbacks.
+// The effective rate is the samples delivered since the first callback over the time since then;
+// arrival jitter only affects the end points, so it converges as 1 / elapsed time.
+class JitterEstimator
+{
+public:
+    static constexpr int NUM_BINS = 96;
+    static constexpr int BINS_PER_OCTAVE = 4;
+    static constexpr double MIN_SECONDS = 1.0e-6; // 96 bins at 4 per octave reach ~16 s
+    static constexpr int AGE_INTERVAL = 4096;
+
+    void reset() noexcept
+    {
+        counts.fill(0.0);
+        totalCount = 0.0;
+        numMeasurements = 0;
+        sinceAging = 0;
+        lastArrival = -1.0;
+        expectedInterval = 0.0;
+        meanDeviation = 0.0;
+        meanSquare = 0.0;
+        rateAnchor = -1.0;
+        samplesSinceAnchor = 0.0;
+    }
+
+    void addCallback(double nowSeconds, int numSamples, double sampleRate) noexcept
+    {
+        const double interval = nowSeconds - lastArrival;
+        const double expected = expectedInterval;
+
+        lastArrival = nowSeconds;
+        expectedInterval = sampleRate > 0.0 ? numSamples / sampleRate : 0.0;
+
+        // First callback, or the stream stalled (device restart, scene switch): not jitter, and
+        // the rate measurement starts over
+        if (expected <= 0.0 || interval < 0.0 || interval > expected * MAX_GAP_BLOCKS)
+        {
+            rateAnchor = nowSeconds;
+            samplesSinceAnchor = 0.0;
+            return;
+        }
+
+        samplesSinceAnchor += expected * sampleRate;
+
+        const double deviation = interval - expected;
+        meanDeviation += (deviation - meanDeviation) * MEAN_SMOOTHING;
+        const double jitter = std::abs(deviation - meanDeviation);
+        meanSquare += (jitter * jitter - meanSquare) * MEAN_SMOOTHING;
+
+        counts[static_cast<size_t>(binFor(jitter))] += 1.0;
+        totalCount += 1.0;
+        ++numMeasurements;
+
+        if (++sinceAging >= AGE_INTERVAL)
+        {
+            sinceAging = 0;
+            for (auto& count : counts)
+                count *= 0.5;
+            totalCount *= 0.5;
+        }
+    }
+
+    int64_t getNumMeasurements() const noexcept
+    {
+        return numMeasurements;
+    }
+
+    // Smallest jitter (seconds) that a fraction `probability` of callbacks stays within
+    double getQuantile(double probability) const noexcept
+    {
+        if (totalCount <= 0.0)
+            return 0.0;
+
+        const double wanted = std::clamp(probability, 0.0, 1.0) * totalCount;
+        double cumulative = 0.0;
+        for (int bin = 0; bin < NUM_BINS; ++bin)
+        {
+            cumulative += counts[static_cast<size_t>(bin)];
+            if (cumulative >= wanted)
+                return upperEdge(bin);
+        }
+        return upperEdge(NUM_BINS - 1);
+    }
+
+    double getRmsSeconds() const noexcept
+    {
+        return std::sqrt(meanSquare);
+    }
+
+    // Samples per second of the steady clock; 0 until a callback interval has been seen
+    double getMeasuredSampleRate() const noexcept
+    {
+        const double elapsed = lastArrival - rateAnchor;
+        return rateAnchor >= 0.0 && elapsed > 0.0 ? samplesSinceAnchor / elapsed : 0.0;
+    }
+
+private:
+    static constexpr double MAX_GAP_BLOCKS = 8.0;
+    static constexpr double MEAN_SMOOTHING = 1.0 / 256.0;
+
+    static int binFor(double seconds) noexcept
+    {
+        if (seconds < MIN_SECONDS)
+            return 0;
+        const int bin = 1 + static_cast<int>(std::log2(seconds / MIN_SECONDS) * BINS_PER_OCTAVE);
+        return std::min(bin, NUM_BINS - 1);
+    }
+
+    static double upperEdge(int bin) noexcept
+    {
+        return MIN_SECONDS * std::exp2(static_cast<double>(bin) / BINS_PER_OCTAVE);
+    }
+
+    std::array<double, NUM_BINS> counts{};
+    double totalCount{0.0};
+    int64_t numMeasurements{0};
+    int sinceAging{0};
+
+    double lastArrival{-1.0};
+    double expectedInterval{0.0};
+    double meanDeviation{0.0};
+    double meanSquare{0.0};
+
+    double rateAnchor{-1.0};
+    double samplesSinceAnchor{0.0};
+};
+
+// A JitterEstimator fed from one side's callbacks, with what the other side and monitors need
+// published through atomics. Results are refreshed every PUBLISH_INTERVAL callbacks; the quantile
+// only once enough callbacks have been seen for the tail to mean something.
+class PublishedJitter
+{
+public:
+    static constexpr int64_t MIN_MEASUREMENTS = 256;
+    static constexpr int64_t PUBLISH_INTERVAL = 64;
+
+    // Only while nothing feeds the estimator
+    void reset() noexcept
+    {
+        estimator.reset();
+        quantile.store(-1.0f, std::memory_order_relaxed);
+        rms.store(0.0f, std::memory_order_relaxed);
+        clockError.store(0.0, std::memory_order_relaxed);
+    }
+
+    // From the feeding side only. quantileProbability is the fraction of callbacks the published
+    // quantile must cover.
+    void addCallback(double nowSeconds, int numSamples, double sampleRate, double quantileProbability) noexcept
+    {
+        estimator.addCallback(nowSeconds, numSamples, sampleRate);
+
+        const auto numMeasurements = estimator.getNumMeasurements();
+        if (numMeasurements == 0 || numMeasurements % PUBLISH_INTERVAL != 0)
+            return;
+
+        // The buffer level moves in whole blocks, so the drift is measured from callback timing
+        const double measuredRate = estimator.getMeasuredSampleRate();
+        if (measuredRate > 0.0 && sampleRate > 0.0)
+            clockError.store(measuredRate / sampleRate - 1.0, std::memory_order_relaxed);
+
+        if (numMeasurements < MIN_MEASUREMENTS)
+            return;
+
+        quantile.store(static_cast<float>(estimator.getQuantile(quantileProbability)), std::memory_order_relaxed);
+        rms.store(static_cast<float>(estimator.getRmsSeconds()), std::memory_order_relaxed);
+    }
+
+    // Takes over another estimator's results, for a side whose callbacks are seen elsewhere
+    void publishFrom(const PublishedJitter& other) noexcept
+    {
+        quantile.store(other.getQuantile(), std::memory_order_relaxed);
+        rms.store(other.getRms(), std::memory_order_relaxed);
+        clockError.store(other.getClockError(), std::memory_order_relaxed);
+    }
+
+    // Seconds, -1 until measured
+    float getQuantile() const noexcept
+    {
+        return quantile.load(std::memory_order_relaxed);
+    }
+
+    float getRms() const noexcept
+    {
+        return rms.load(std::memory_order_relaxed);
+    }
+
+    // Measured rate / nominal rate - 1
+    double getClockError() const noexcept
+    {
+        return clockError.load(std::memory_order_relaxed);
+    }
+
+private:
+    JitterEstimator estimator;
+    std::atomic<float> quantile{-1.0f};
+    std::atomic<float> rms{0.0f};
+    std::atomic<double> clockError{0.0};
+};
+
+} // namespace atk
@@ -0,0 +1,809 @@
+#include "AggregateAudioDevices.h"
+#include "AudioDeviceScanner.h"
+#include "VirtualAudioDevices.h"
+#include <atkaudio/atkaudio.h>
+#include <atkaudio/FifoBuffer2.h>
+#include <atkaudio/Logging.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <mutex>
+
+namespace atk
+{
+
+namespace
+{
+constexpr int kSettingsVersion = 1;
+// Longest master block the callback handles; larger ones are played as silence
+constexpr int kMinScratchSamples = 4096;
+
+// Bits [first, first + numBits) of mask, shifted down to bit 0
+juce::BigInteger extractBits(const juce::BigInteger& mask, int first, int numBits)
+{
+    juce::BigInteger bits;
+    for (int i = 0; i < numBits; ++i)
+        if (mask[first + i])
+            bits.setBit(i);
+    return bits;
+}
+
+// The requested value if the device supports it, otherwise the supported one nearest to it
+template <typename T>
+T nearestSupported(const juce::Array<T>& supported, T requested, T fallback)
+{
+    if (supported.isEmpty())
+        return fallback;
+
+    T best = supported.getFirst();
+    for (T value : supported)
+        if (std::abs(static_cast<double>(value - requested)) < std::abs(static_cast<double>(best - requested)))
+            best = value;
+    return best;
+}
+} // namespace
+
+//==============================================================================
+class AggregateMemberTypes
+{
+public:
+    AggregateMemberTypes()
+    {
+        // Creates the built-in types first; members may be virtual devices too, but not aggregates
+        VirtualAudioDevices::addDeviceTypes(manager);
+    }
+
+    // Null if the member isn't there. A type is scanned before its first use; it is scanned again
+    // if it lacks the member and rescanAllowed is set, which this then clears.
+    std::unique_ptr<juce::AudioIODevice> createDevice(const AggregateMember& entry, bool& rescanAllowed)
+    {
+        const std::lock_guard<std::mutex> guard(lock);
+        for (auto* type : manager.getAvailableDeviceTypes())
+        {
+            if (entry.typeName.isNotEmpty() && type->getTypeName() != entry.typeName)
+                continue;
+
+            const bool firstUse = !scannedTypes.contains(type->getTypeName());
+            if (firstUse)
+            {
+                type->scanForDevices();
+                scannedTypes.add(type->getTypeName());
+            }
+
+            auto device = createFrom(*type, entry.deviceName);
+            if (device == nullptr && !firstUse && rescanAllowed)
+            {
+                rescanAllowed = false;
+                type->scanForDevices();
+                device = createFrom(*type, entry.deviceName);
+            }
+            if (device != nullptr)
+                return device;
+        }
+        return nullptr;
+    }
+
+private:
+    static std::unique_ptr<juce::AudioIODevice> createFrom(juce::AudioIODeviceType& type, const juce::String& name)
+    {
+        const bool isInput = type.getDeviceNames(true).contains(name);
+        const bool isOutput = type.getDeviceNames(false).contains(name);
+        if (!isInput && !isOutput)
+            return nullptr;
+
+        return std::unique_ptr<juce::AudioIODevice>(
+            type.createDevice(isOutput ? name : juce::String(), isInput ? name : juce::String())
+        );
+    }
+
+    std::mutex lock;
+    juce::AudioDeviceManager manager;
+    juce::StringArray scannedTypes;
+};
+
+//==============================================================================
+class AggregateAudioIODevice
+    : public juce::AudioIODevice
+    , private juce::AudioIODeviceCallback
+{
+public:
+    AggregateAudioIODevice(const juce::String& deviceName, const std::vector<AggregateMember>& memberList)
+        : juce::AudioIODevice(deviceName, AggregateAudioDevices::TYPE_NAME)
+        , memberTypes(AggregateAudioDevices::getInstance()->getMemberTypes())
+    {
+        const auto snapshot = AggregateAudioDevices::getInstance()->getScanSnapshot();
+        bool rescanAllowed = false;
+
+        for (const auto& entry : memberList)
+        {
+            auto member = std::make_unique<Member>();
+            member->entry = entry;
+
+            if (const auto* scanned = snapshot->find(entry.deviceName, entry.typeName); scanned && scanned->probed)
+            {
+                member->inputNames = scanned->inputChannelNames;
+                member->outputNames = scanned->outputChannelNames;
+                member->sampleRates = scanned->sampleRates;
+                member->bufferSizes = scanned->bufferSizes;
+            }
+            else if ((member->device = memberTypes->createDevice(entry, rescanAllowed)) != nullptr)
+            {
+                // The scan doesn't probe ASIO devices, nor those that arrived since; ask the device
+                member->inputNames = member->device->getInputChannelNames();
+                member->outputNames = member->device->getOutputChannelNames();
+                member->sampleRates = member->device->getAvailableSampleRates();
+                member->bufferSizes = member->device->getAvailableBufferSizes();
+            }
+            else
+            {
+                // Its channels are left out until it comes back and the aggregate is reopened
+                atk::logging::warning(
+                    "AggregateAudioIODevice::ctor",
+                    "\"" + deviceName + "\": member \"" + entry.deviceName + "\" is not available"
+                );
+                continue;
+            }
+
+            members.push_back(std::move(member));
+        }
+    }
+
+    ~AggregateAudioIODevice() override
+    {
+        close();
+    }
+
+    juce::StringArray getOutputChannelNames() override
+    {
+        juce::StringArray names;
+        for (const auto& member : members)
+            for (const auto& channel : member->outputNames)
+                names.add(member->entry.deviceName + ": " + channel);
+        return names;
+    }
+
+    juce::StringArray getInputChannelNames() override
+    {
+        juce::StringArray names;
+        for (const auto& member : members)
+            for (const auto& channel : member->inputNames)
+                names.add(member->entry.deviceName + ": " + channel);
+        return names;
+    }
+
+    // Rate, block size, bit depth and latencies are the clock master's
+    juce::Array<double> getAvailableSampleRates() override
+    {
+        return master() != nullptr ? master()->sampleRates : juce::Array<double>();
+    }
+
+    juce::Array<int> getAvailableBufferSizes() override
+    {
+        return master() != nullptr ? master()->bufferSizes : juce::Array<int>();
+    }
+
+    int getDefaultBufferSize() override
+    {
+        if (auto* device = masterDevice())
+            return device->getDefaultBufferSize();
+        return master() != nullptr ? nearestSupported(master()->bufferSizes, 512, 512) : 512;
+    }
+
+    juce::String open(
+        const juce::BigInteger& inputChannels,
+        const juce::BigInteger& outputChannels,
+        double sampleRate,
+        int bufferSizeSamples
+    ) override
+    {
+        close();
+
+        if (master() == nullptr)
+        {
+            lastError = "no member device is available";
+            return lastError;
+        }
+
+        int inputBase = 0;
+        int outputBase = 0;
+        bool rescanAllowed = true;
+        for (size_t i = 0; i < members.size(); ++i)
+        {
+            auto& member = *members[i];
+            const auto inputs = extractBits(inputChannels, inputBase, member.inputNames.size());
+            const auto outputs = extractBits(outputChannels, outputBase, member.outputNames.size());
+            inputBase += member.inputNames.size();
+            outputBase += member.outputNames.size();
+
+            if (i > 0 && inputs.isZero() && outputs.isZero())
+                continue;
+
+            if (member.device == nullptr)
+                member.device = memberTypes->createDevice(member.entry, rescanAllowed);
+            if (member.device == nullptr)
+            {
+                lastError = member.entry.deviceName + ": not available";
+                close();
+                return lastError;
+            }
+
+            // The others follow the master's settings where they can; their SyncBuffers convert the rest
+            auto& device = *member.device;
+            const double rate = i == 0 ? sampleRate : nearestSupported(member.sampleRates, sampleRate, sampleRate);
+            const int blockSize =
+                i == 0 ? bufferSizeSamples : nearestSupported(member.bufferSizes, bufferSizeSamples, bufferSizeSamples);
+
+            const auto error = device.open(inputs, outputs, rate, blockSize);
+            if (error.isNotEmpty())
+            {
+                lastError = device.getName() + ": " + error;
+                close();
+                return lastError;
+            }
+
+            member.opened = true;
+            member.sampleRate = device.getCurrentSampleRate();
+            member.numActiveInputs = device.getActiveInputChannels().countNumberOfSetBits();
+            member.numActiveOutputs = device.getActiveOutputChannels().countNumberOfSetBits();
+        }
+
+        allocateScratch();
+        lastError.clear();
+        deviceOpen = true;
+        return {};
+    }
+
+    void close() override
+    {
+        stop();
+
+        for (auto& member : members)
+        {
+            if (member->opened)
+                member->device->close();
+            member->opened = false;
+            member->numActiveInputs = 0;
+            member->numActiveOutputs = 0;
+        }
+        deviceOpen = false;
+    }
+
+    bool isOpen() override
+    {
+        return deviceOpen;
+    }
+
+    void start(juce::AudioIODeviceCallback* newCallback) override
+    {
+        if (!deviceOpen || newCallback == nullptr)
+            return;
+
+        stop();
+        newCallback->audioDeviceAboutToStart(this);
+        callback.store(newCallback, std::memory_order_release);
+
+        // The others first, so the master finds their input already queued
+        for (size_t i = members.size(); i-- > 1;)
+        {
+            auto& member = *members[i];
+            if (!member.opened)
+                continue;
+
+            member.inputSync.reset();
+            member.outputSync.reset();
+            member.device->start(&member);
+        }
+        master()->device->start(this);
+    }
+
+    void stop() override
+    {
+        // Stopping the master ends the client's callbacks; the others only feed it
+        if (master() != nullptr && master()->opened)
+            master()->device->stop();
+        for (size_t i = 1; i < members.size(); ++i)
+            if (members[i]->opened)
+                members[i]->device->stop();
+
+        if (auto* oldCallback = callback.exchange(nullptr, std::memory_order_acq_rel))
+            oldCallback->audioDeviceStopped();
+    }
+
+    bool isPlaying() override
+    {
+        return callback.load(std::memory_order_acquire) != nullptr
+            && masterDevice() != nullptr
+            && masterDevice()->isPlaying();
+    }
+
+    juce::String getLastError() override
+    {
+        return lastError;
+    }
+
+    int getCurrentBufferSizeSamples() override
+    {
+        return masterDevice() != nullptr ? masterDevice()->getCurrentBufferSizeSamples() : 0;
+    }
+
+    double getCurrentSampleRate() override
+    {
+        return masterDevice() != nullptr ? masterDevice()->getCurrentSampleRate() : 0.0;
+    }
+
+    int getCurrentBitDepth() override
+    {
+        return masterDevice() != nullptr ? masterDevice()->getCurrentBitDepth() : 32;
+    }
+
+    juce::BigInteger getActiveOutputChannels() const override
+    {
+        return collectActiveChannels(false);
+    }
+
+    juce::BigInteger getActiveInputChannels() const override
+    {
+        return collectActiveChannels(true);
+    }
+
+    int getOutputLatencyInSamples() override
+    {
+        return masterDevice() != nullptr ? masterDevice()->getOutputLatencyInSamples() : 0;
+    }
+
+    int getInputLatencyInSamples() override
+    {
+        return masterDevice() != nullptr ? masterDevice()->getInputLatencyInSamples() : 0;
+    }
+
+    bool hasControlPanel() const override
+    {
+        return masterDevice() != nullptr && masterDevice()->hasControlPanel();
+    }
+
+    bool showControlPanel() override
+    {
+        return masterDevice() != nullptr && masterDevice()->showControlPanel();
+    }
+
+private:
+    // A member device and, for all but the master, the callback that feeds it from the master's.
+    // inputSync carries its input to the master's clock, outputSync the master's output to its own.
+    struct Member : public juce::AudioIODeviceCallback
+    {
+        AggregateMember entry;
+        std::unique_ptr<juce::AudioIODevice> device; // created by the first open() that needs it
+        juce::StringArray inputNames;
+        juce::StringArray outputNames;
+        juce::Array<double> sampleRates;
+        juce::Array<int> bufferSizes;
+
+        bool opened = false;
+        double sampleRate = 0.0;
+        int numActiveInputs = 0;
+        int numActiveOutputs = 0;
+
+        SyncBuffer inputSync{"aggregate member input"};
+        SyncBuffer outputSync{"aggregate member output"};
+        std::vector<float*> inputScratch; // the master callback's, into the aggregate's scratch
+        std::vector<float*> outputScratch;
+
+        void audioDeviceIOCallbackWithContext(
+            const float* const* inputChannelData,
+            int numInputChannels,
+            float* const* outputChannelData,
+            int numOutputChannels,
+            int numSamples,
+            const juce::AudioIODeviceCallbackContext& /*context*/
+        ) override
+        {
+            if (numInputChannels > 0)
+                inputSync.write(inputChannelData, numInputChannels, numSamples, sampleRate);
+
+            for (int ch = 0; ch < numOutputChannels; ++ch)
+                juce::FloatVectorOperations::clear(outputChannelData[ch], numSamples);
+            if (numOutputChannels > 0)
+                outputSync.read(outputChannelData, numOutputChannels, numSamples, sampleRate, true);
+        }
+
+        void audioDeviceAboutToStart(juce::AudioIODevice* memberDevice) override
+        {
+            sampleRate = memberDevice->getCurrentSampleRate();
+        }
+
+        void audioDeviceStopped() override
+        {
+        }
+    };
+
+    Member* master() const
+    {
+        return members.empty() ? nullptr : members.front().get();
+    }
+
+    // Null until the master has been created
+    juce::AudioIODevice* masterDevice() const
+    {
+        return master() != nullptr ? master()->device.get() : nullptr;
+    }
+
+    juce::BigInteger collectActiveChannels(bool isInput) const
+    {
+        juce::BigInteger active;
+        int base = 0;
+        for (const auto& member : members)
+        {
+            if (member->opened)
+            {
+                const auto memberActive =
+                    isInput ? member->device->getActiveInputChannels() : member->device->getActiveOutputChannels();
+                for (int bit = memberActive.findNextSetBit(0); bit >= 0; bit = memberActive.findNextSetBit(bit + 1))
+                    active.setBit(base + bit);
+            }
+            base += isInput ? member->inputNames.size() : member->outputNames.size();
+        }
+        return active;
+    }
+
+    // Not while running. The callback's channel lists are the members' active channels in member
+    // order, which is the order of the aggregate's active channels.
+    void allocateScratch()
+    {
+        scratchSamples = juce::jmax(kMinScratchSamples, 2 * master()->device->getCurrentBufferSizeSamples());
+
+        int numScratchInputs = 0;
+        int numScratchOutputs = 0;
+        int numInputs = 0;
+        int numOutputs = 0;
+        for (size_t i = 0; i < members.size(); ++i)
+        {
+            numInputs += members[i]->numActiveInputs;
+            numOutputs += members[i]->numActiveOutputs;
+            if (i > 0)
+            {
+                numScratchInputs += members[i]->numActiveInputs;
+                numScratchOutputs += members[i]->numActiveOutputs;
+            }
+        }
+
+        inputScratch.setSize(juce::jmax(1, numScratchInputs), scratchSamples);
+        outputScratch.setSize(juce::jmax(1, numScratchOutputs), scratchSamples);
+        inputPointers.assign(static_cast<size_t>(numInputs), nullptr);
+        outputPointers.assign(static_cast<size_t>(numOutputs), nullptr);
+
+        int inputChannel = 0;
+        int outputChannel = 0;
+        for (size_t i = 1; i < members.size(); ++i)
+        {
+            auto& member = *members[i];
+            member.inputScratch.resize(static_cast<size_t>(member.numActiveInputs));
+            member.outputScratch.resize(static_cast<size_t>(member.numActiveOutputs));
+            for (auto& pointer : member.inputScratch)
+                pointer = inputScratch.getWritePointer(inputChannel++);
+            for (auto& pointer : member.outputScratch)
+                pointer = outputScratch.getWritePointer(outputChannel++);
+        }
+    }
+
+    // The master's callback
+    void audioDeviceIOCallbackWithContext(
+        const float* const* inputChannelData,
+        int numInputChannels,
+        float* const* outputChannelData,
+        int numOutputChannels,
+        int numSamples,
+        const juce::AudioIODeviceCallbackContext& context
+    ) override
+    {
+        auto* client = callback.load(std::memory_order_acquire);
+        if (client == nullptr || numSamples > scratchSamples)
+        {
+            for (int ch = 0; ch < numOutputChannels; ++ch)
+                juce::FloatVectorOperations::clear(outputChannelData[ch], numSamples);
+            return;
+        }
+
+        const double rate = master()->sampleRate;
+        size_t inputIndex = 0;
+        size_t outputIndex = 0;
+
+        for (int ch = 0; ch < numInputChannels && inputIndex < inputPointers.size(); ++ch)
+            inputPointers[inputIndex++] = inputChannelData[ch];
+        for (int ch = 0; ch < numOutputChannels && outputIndex < outputPointers.size(); ++ch)
+            outputPointers[outputIndex++] = outputChannelData[ch];
+
+        for (size_t i = 1; i < members.size(); ++i)
+        {
+            auto& member = *members[i];
+            const int numMemberInputs = static_cast<int>(member.inputScratch.size());
+            if (numMemberInputs > 0
+                && !member.inputSync.read(member.inputScratch.data(), numMemberInputs, numSamples, rate))
+            {
+                for (auto* channel : member.inputScratch)
+                    juce::FloatVectorOperations::clear(channel, numSamples);
+            }
+
+            for (auto* channel : member.inputScratch)
+                inputPointers[inputIndex++] = channel;
+            for (auto* channel : member.outputScratch)
+            {
+                juce::FloatVectorOperations::clear(channel, numSamples);
+                outputPointers[outputIndex++] = channel;
+            }
+        }
+
+        client->audioDeviceIOCallbackWithContext(
+            inputPointers.data(),
+            static_cast<int>(inputIndex),
+            outputPointers.data(),
+            static_cast<int>(outputIndex),
+            numSamples,
+            context
+        );
+
+        for (size_t i = 1; i < members.size(); ++i)
+        {
+            auto& member = *members[i];
+            if (!member.outputScratch.empty())
+                member.outputSync.write(
+                    member.outputScratch.data(),
+                    static_cast<int>(member.outputScratch.size()),
+                    numSamples,
+                    rate
+                );
+        }
+    }
+
+    void audioDeviceAboutToStart(juce::AudioIODevice* masterDevice) override
+    {
+        master()->sampleRate = masterDevice->getCurrentSampleRate();
+    }
+
+    void audioDeviceStopped() override
+    {
+    }
+
+    void audioDeviceError(const juce::String& errorMessage) override
+    {
+        atk::logging::error("AggregateAudioIODevice", getName() + ": " + errorMessage);
+    }
+
+    // Declared first so that the member devices go before their types
+    std::shared_ptr<AggregateMemberTypes> memberTypes;
+    std::vector<std::unique_ptr<Member>> members; // the clock master first
+
+    bool deviceOpen = false;
+    juce::String lastError;
+    std::atomic<juce::AudioIODeviceCallback*> callback{nullptr};
+
+    int scratchSamples = 0;
+    juce::AudioBuffer<float> inputScratch;
+    juce::AudioBuffer<float> outputScratch;
+    std::vector<const float*> inputPointers;
+    std::vector<float*> outputPointers;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AggregateAudioIODevice)
+};
+
+//==============================================================================
+class AggregateAudioDeviceType : public juce::AudioIODeviceType
+{
+public:
+    AggregateAudioDeviceType()
+        : juce::AudioIODeviceType(AggregateAudioDevices::TYPE_NAME)
+    {
+    }
+
+    void scanForDevices() override
+    {
+    }
+
+    juce::StringArray getDeviceNames(bool /*wantInputNames*/) const override
+    {
+        return AggregateAudioDevices::getInstance()->getDeviceNames();
+    }
+
+    int getDefaultDeviceIndex(bool /*forInput*/) const override
+    {
+        return 0;
+    }
+
+    int getIndexOfDevice(juce::AudioIODevice* device, bool asInput) const override
+    {
+        return device != nullptr ? getDeviceNames(asInput).indexOf(device->getName()) : -1;
+    }
+
+    bool hasSeparateInputsAndOutputs() const override
+    {
+        return false;
+    }
+
+    juce::AudioIODevice*
+    createDevice(const juce::String& outputDeviceName, const juce::String& inputDeviceName) override
+    {
+        const auto& deviceName = outputDeviceName.isNotEmpty() ? outputDeviceName : inputDeviceName;
+        const auto members = AggregateAudioDevices::getInstance()->getMembers(deviceName);
+        if (members.empty())
+            return nullptr;
+
+        return new AggregateAudioIODevice(deviceName, members);
+    }
+};
+
+//==============================================================================
+JUCE_IMPLEMENT_SINGLETON(AggregateAudioDevices)
+
+AggregateAudioDevices::AggregateAudioDevices()
+{
+    loadFromDisk();
+}
+
+AggregateAudioDevices::~AggregateAudioDevices()
+{
+    clearSingletonInstance();
+}
+
+void AggregateAudioDevices::setDevice(const juce::String& deviceName, const std::vector<AggregateMember>& members)
+{
+    std::vector<AggregateMember> validMembers;
+    for (const auto& member : members)
+        if (member.typeName != TYPE_NAME && member.deviceName.isNotEmpty())
+            validMembers.push_back(member);
+
+    {
+        const juce::ScopedLock sl(lock);
+        auto it = std::find_if(
+            devices.begin(),
+            devices.end(),
+            [&](const auto& device) { return device.first == deviceName; }
+        );
+        if (it != devices.end())
+            it->second = std::move(validMembers);
+        else
+            devices.emplace_back(deviceName, std::move(validMembers));
+        saveToDisk();
+    }
+    sendChangeMessage();
+}
+
+void AggregateAudioDevices::removeDevice(const juce::String& deviceName)
+{
+    {
+        const juce::ScopedLock sl(lock);
+        const auto it = std::find_if(
+            devices.begin(),
+            devices.end(),
+            [&](const auto& device) { return device.first == deviceName; }
+        );
+        if (it == devices.end())
+            return;
+        devices.erase(it);
+        saveToDisk();
+    }
+    sendChangeMessage();
+}
+
+juce::StringArray AggregateAudioDevices::getDeviceNames() const
+{
+    const juce::ScopedLock sl(lock);
+    juce::StringArray names;
+    for (const auto& device : devices)
+        if (!device.second.empty())
+            names.add(device.first);
+    return names;
+}
+
+std::vector<AggregateMember> AggregateAudioDevices::getMembers(const juce::String& deviceName) const
+{
+    const juce::ScopedLock sl(lock);
+    for (const auto& device : devices)
+        if (device.first == deviceName)
+            return device.second;
+    return {};
+}
+
+void AggregateAudioDevices::addDeviceTypes(juce::AudioDeviceManager& manager)
+{
+    // Creates the manager's own types first; it only does so while it has none
+    const auto& types = manager.getAvailableDeviceTypes();
+
+    const bool present = std::any_of(
+        types.begin(),
+        types.end(),
+        [](const juce::AudioIODeviceType* type) { return type->getTypeName() == TYPE_NAME; }
+    );
+    if (!present)
+        manager.addAudioDeviceType(std::make_unique<AggregateAudioDeviceType>());
+}
+
+void AggregateAudioDevices::setScanSnapshot(std::shared_ptr<const DeviceScanSnapshot> snapshot)
+{
+    if (snapshot == nullptr)
+        return;
+
+    // An aggregate whose members changed has other channels now
+    bool membersChanged = false;
+    {
+        const juce::ScopedLock sl(lock);
+        scanSnapshot = snapshot;
+        for (const auto& device : devices)
+            for (const auto& member : device.second)
+                membersChanged |= snapshot->changedDevices.contains(member.deviceName);
+    }
+    if (membersChanged)
+        sendChangeMessage();
+}
+
+std::shared_ptr<const DeviceScanSnapshot> AggregateAudioDevices::getScanSnapshot() const
+{
+    const juce::ScopedLock sl(lock);
+    return scanSnapshot != nullptr ? scanSnapshot : std::make_shared<const DeviceScanSnapshot>();
+}
+
+std::shared_ptr<AggregateMemberTypes> AggregateAudioDevices::getMemberTypes()
+{
+    const juce::ScopedLock sl(lock);
+    if (memberTypes == nullptr)
+        memberTypes = std::make_shared<AggregateMemberTypes>();
+    return memberTypes;
+}
+
+juce::File AggregateAudioDevices::getSettingsFile()
+{
+    return atk::getSettingsFile("atkAudio Aggregate Devices");
+}
+
+void AggregateAudioDevices::loadFromDisk()
+{
+    const auto file = getSettingsFile();
+    if (!file.existsAsFile())
+        return;
+
+    auto root = juce::XmlDocument::parse(file);
+    if (root == nullptr
+        || !root->hasTagName("AGGREGATE_DEVICES")
+        || root->getIntAttribute("version") != kSettingsVersion)
+    {
+        atk::logging::warning("AggregateAudioDevices::loadFromDisk", "ignoring unreadable " + file.getFullPathName());
+        return;
+    }
+
+    const juce::ScopedLock sl(lock);
+    for (auto* element : root->getChildWithTagNameIterator("DEVICE"))
+    {
+        std::vector<AggregateMember> members;
+        for (auto* memberElement : element->getChildWithTagNameIterator("MEMBER"))
+            members.push_back({memberElement->getStringAttribute("type"), memberElement->getStringAttribute("name")});
+
+        const auto name = element->getStringAttribute("name");
+        if (name.isNotEmpty() && !members.empty())
+            devices.emplace_back(name, std::move(members));
+    }
+}
+
+void AggregateAudioDevices::saveToDisk() const
+{
+    juce::XmlElement root("AGGREGATE_DEVICES");
+    root.setAttribute("version", kSettingsVersion);
+
+    for (const auto& [name, members] : devices)
+    {
+        auto* element = root.createNewChildElement("DEVICE");
+        element->setAttribute("name", name);
+        for (const auto& member : members)
+        {
+            auto* memberElement = element->createNewChildElement("MEMBER");
+            memberElement->setAttribute("type", member.typeName);
+            memberElement->setAttribute("name", member.deviceName);
+        }
+    }
+
+    const auto file = getSettingsFile();
+    file.getParentDirectory().createDirectory();
+    if (!root.writeTo(file))
+        atk::logging::warning("AggregateAudioDevices::saveToDisk", "could not write " + file.getFullPathName());
+}
+
+} // namespace atk
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <juce_audio_devices/juce_audio_devices.h>
+#include <juce_events/juce_events.h>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace atk
+{
+
+struct DeviceScanSnapshot;
+class AggregateMemberTypes;
+
+struct AggregateMember
+{
+    juce::String typeName;
+    juce::String deviceName;
+
+    bool operator==(const AggregateMember& other) const
+    {
+        return typeName == other.typeName && deviceName == other.deviceName;
+    }
+};
+
+// Audio devices made of several others, so that a rig of two or three interfaces is one device to
+// AudioServer: one handler, one set of converters per client and one entry in the routing UI. The
+// channels are the members' in member order, named "<member>: <channel>".
+//
+// The first member is the clock master and drives the callback. Each other member runs its own
+// callback into and out of a SyncBuffer, which the master callback reads and writes, so the drift
+// and any rate difference between a member and the master are corrected once per member rather
+// than once per client. Members without active channels are not opened, apart from the master.
+//
+// Members should not also be opened on their own by AudioServer: drivers that allow one client per
+// device will refuse the second open.
+//
+// An aggregate takes its members' channels and capabilities from the last device scan, so creating
+// one to ask what it offers touches no driver. Member devices are created when the aggregate is
+// opened, from one set of device types shared by all aggregates; a type is scanned the first time
+// a member needs it, and again, once per open(), only if a member is missing from it.
+//
+// The aggregates are listed by the device type that addDeviceTypes() adds to an AudioDeviceManager,
+// and are kept in a settings file. A ChangeBroadcaster: listeners hear on the message thread when an
+// aggregate is added, changed or removed.
+class AggregateAudioDevices
+    : public juce::ChangeBroadcaster
+    , public juce::DeletedAtShutdown
+{
+public:
+    static constexpr const char* TYPE_NAME = "Aggregate";
+
+    JUCE_DECLARE_SINGLETON(AggregateAudioDevices, false)
+    ~AggregateAudioDevices() override;
+
+    // Adds or replaces an aggregate and saves the list. Members that are aggregates themselves are
+    // dropped. An open aggregate keeps its members until it is next opened.
+    void setDevice(const juce::String& deviceName, const std::vector<AggregateMember>& members);
+    void removeDevice(const juce::String& deviceName);
+
+    juce::StringArray getDeviceNames() const;
+    // Empty if there is no such aggregate
+    std::vector<AggregateMember> getMembers(const juce::String& deviceName) const;
+
+    // Adds the Aggregate type after the manager's own, unless it has it already
+    static void addDeviceTypes(juce::AudioDeviceManager& manager);
+
+    // AudioServer passes each snapshot its scanner publishes. Never null.
+    void setScanSnapshot(std::shared_ptr<const DeviceScanSnapshot> snapshot);
+    std::shared_ptr<const DeviceScanSnapshot> getScanSnapshot() const;
+
+    // The device types members are created from, shared by all aggregates
+    std::shared_ptr<AggregateMemberTypes> getMemberTypes();
+
+private:
+    AggregateAudioDevices();
+
+    void loadFromDisk();
+    void saveToDisk() const;
+    static juce::File getSettingsFile();
+
+    mutable juce::CriticalSection lock;
+    std::vector<std::pair<juce::String, std::vector<AggregateMember>>> devices;
+    std::shared_ptr<const DeviceScanSnapshot> scanSnapshot;
+    std::shared_ptr<AggregateMemberTypes> memberTypes;
+};
+
+} // namespace atk
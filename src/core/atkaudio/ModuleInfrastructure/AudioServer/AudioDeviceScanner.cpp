@@ -0,0 +1,370 @@
+#include "AudioDeviceScanner.h"
+#include "AggregateAudioDevices.h"
+#include "VirtualAudioDevices.h"
+#include <atkaudio/atkaudio.h>
+#include <atkaudio/Logging.h>
+
+#if JUCE_WINDOWS
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <objbase.h>
+#endif
+
+namespace atk
+{
+
+namespace
+{
+constexpr int kCacheVersion = 1;
+constexpr int kStopTimeoutMs = 5000;
+
+juce::String joinNumbers(const juce::Array<double>& values)
+{
+    juce::StringArray strings;
+    for (double value : values)
+        strings.add(juce::String(value));
+    return strings.joinIntoString(",");
+}
+
+juce::String joinNumbers(const juce::Array<int>& values)
+{
+    juce::StringArray strings;
+    for (int value : values)
+        strings.add(juce::String(value));
+    return strings.joinIntoString(",");
+}
+} // namespace
+
+bool ScannedDevice::operator==(const ScannedDevice& other) const
+{
+    return typeName == other.typeName
+        && name == other.name
+        && isInput == other.isInput
+        && isOutput == other.isOutput
+        && probed == other.probed
+        && inputChannelNames == other.inputChannelNames
+        && outputChannelNames == other.outputChannelNames
+        && sampleRates == other.sampleRates
+        && bufferSizes == other.bufferSizes;
+}
+
+const ScannedDevice* DeviceScanSnapshot::find(const juce::String& deviceName, const juce::String& typeName) const
+{
+    for (const auto& device : devices)
+        if (device.name == deviceName && (typeName.isEmpty() || device.typeName == typeName))
+            return &device;
+    return nullptr;
+}
+
+juce::StringArray DeviceScanSnapshot::getDeviceNames(bool isInput) const
+{
+    juce::StringArray names;
+    for (const auto& device : devices)
+        if (isInput ? device.isInput : device.isOutput)
+            names.add(device.name);
+    names.removeDuplicates(false);
+    return names;
+}
+
+std::map<juce::String, juce::StringArray> DeviceScanSnapshot::getDevicesByType(bool isInput) const
+{
+    std::map<juce::String, juce::StringArray> devicesByType;
+    for (const auto& device : devices)
+        if (isInput ? device.isInput : device.isOutput)
+            devicesByType[device.typeName].add(device.name);
+    return devicesByType;
+}
+
+AudioDeviceScanner::AudioDeviceScanner()
+    : juce::Thread("atk AudioDeviceScanner")
+{
+}
+
+AudioDeviceScanner::~AudioDeviceScanner()
+{
+    stop();
+}
+
+void AudioDeviceScanner::start()
+{
+    if (isThreadRunning())
+        return;
+
+    loadFromDisk();
+    requestRescan();
+    startThread(juce::Thread::Priority::low);
+}
+
+void AudioDeviceScanner::stop()
+{
+    signalThreadShouldExit();
+    notify();
+    stopThread(kStopTimeoutMs);
+}
+
+void AudioDeviceScanner::requestRescan()
+{
+    {
+        std::lock_guard<std::mutex> lock(requestMutex);
+        rescanRequested = true;
+    }
+    notify();
+}
+
+void AudioDeviceScanner::forgetDevice(const juce::String& deviceName)
+{
+    std::lock_guard<std::mutex> lock(requestMutex);
+    forgottenDevices.addIfNotAlreadyThere(deviceName);
+}
+
+std::shared_ptr<const DeviceScanSnapshot> AudioDeviceScanner::getSnapshot() const
+{
+    std::lock_guard<std::mutex> lock(snapshotMutex);
+    return snapshot;
+}
+
+void AudioDeviceScanner::run()
+{
+#if JUCE_WINDOWS
+    // WASAPI and DirectSound enumerate through COM
+    const bool comInitialised = SUCCEEDED(CoInitializeEx(nullptr, COINIT_MULTITHREADED));
+#endif
+
+    while (!threadShouldExit())
+    {
+        bool requested = false;
+        {
+            std::lock_guard<std::mutex> lock(requestMutex);
+            requested = rescanRequested;
+        }
+
+        if (!requested)
+        {
+            wait(-1);
+            continue;
+        }
+
+        scan();
+    }
+
+    // The device types were created on this thread; let them go here too
+    scanManager.reset();
+
+#if JUCE_WINDOWS
+    if (comInitialised)
+        CoUninitialize();
+#endif
+}
+
+void AudioDeviceScanner::scan()
+{
+    juce::StringArray forgotten;
+    {
+        std::lock_guard<std::mutex> lock(requestMutex);
+        rescanRequested = false;
+        forgotten.swapWith(forgottenDevices);
+    }
+
+    const auto startMs = juce::Time::getMillisecondCounterHiRes();
+
+    if (!scanManager)
+    {
+        scanManager = std::make_unique<juce::AudioDeviceManager>();
+        VirtualAudioDevices::addDeviceTypes(*scanManager);
+        AggregateAudioDevices::addDeviceTypes(*scanManager);
+    }
+
+    const auto previous = getSnapshot();
+    auto next = std::make_shared<DeviceScanSnapshot>();
+    int numProbed = 0;
+
+    for (auto* type : scanManager->getAvailableDeviceTypes())
+    {
+        if (threadShouldExit())
+            return;
+
+        type->scanForDevices();
+        const auto inputs = type->getDeviceNames(true);
+        const auto outputs = type->getDeviceNames(false);
+
+        juce::StringArray names(outputs);
+        names.mergeArray(inputs);
+
+        for (const auto& name : names)
+        {
+            ScannedDevice device;
+            device.typeName = type->getTypeName();
+            device.name = name;
+            device.isInput = inputs.contains(name);
+            device.isOutput = outputs.contains(name);
+
+            // Only new and forgotten devices are opened for their capabilities
+            const auto* known = previous->find(name, device.typeName);
+            if (known != nullptr && known->probed && !forgotten.contains(name))
+            {
+                device.probed = true;
+                device.inputChannelNames = known->inputChannelNames;
+                device.outputChannelNames = known->outputChannelNames;
+                device.sampleRates = known->sampleRates;
+                device.bufferSizes = known->bufferSizes;
+            }
+            else if (shouldProbe(device.typeName))
+            {
+                probe(*type, device);
+                ++numProbed;
+            }
+
+            next->devices.push_back(std::move(device));
+        }
+    }
+
+    atk::logging::debug(
+        "AudioDeviceScanner::scan",
+        juce::String::formatted(
+            "%d devices, %d probed, %.0f ms",
+            static_cast<int>(next->devices.size()),
+            numProbed,
+            juce::Time::getMillisecondCounterHiRes() - startMs
+        )
+    );
+
+    publish(std::move(next));
+}
+
+void AudioDeviceScanner::publish(std::shared_ptr<DeviceScanSnapshot> next)
+{
+    const auto previous = getSnapshot();
+
+    for (const auto& device : next->devices)
+    {
+        const auto* old = previous->find(device.name, device.typeName);
+        if (old == nullptr || !(*old == device))
+            next->changedDevices.addIfNotAlreadyThere(device.name);
+    }
+    for (const auto& device : previous->devices)
+        if (next->find(device.name, device.typeName) == nullptr)
+            next->changedDevices.addIfNotAlreadyThere(device.name);
+
+    // A scan that only confirms the disk cache replaces it without telling anyone
+    if (next->changedDevices.isEmpty() && !previous->fromDisk)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(snapshotMutex);
+        snapshot = next;
+    }
+
+    if (next->changedDevices.isEmpty())
+        return;
+
+    saveToDisk(*next);
+    sendChangeMessage();
+}
+
+bool AudioDeviceScanner::shouldProbe(const juce::String& typeName)
+{
+    // Aggregates open their members, which may be ASIO devices too
+    return typeName != "ASIO" && typeName != AggregateAudioDevices::TYPE_NAME;
+}
+
+void AudioDeviceScanner::probe(juce::AudioIODeviceType& type, ScannedDevice& device)
+{
+    // Created but not opened, as AudioServer does for its own queries
+    std::unique_ptr<juce::AudioIODevice> audioDevice(type.createDevice(device.name, device.name));
+    if (audioDevice == nullptr)
+        return;
+
+    device.probed = true;
+    device.inputChannelNames = audioDevice->getInputChannelNames();
+    device.outputChannelNames = audioDevice->getOutputChannelNames();
+    device.sampleRates = audioDevice->getAvailableSampleRates();
+    device.bufferSizes = audioDevice->getAvailableBufferSizes();
+}
+
+juce::File AudioDeviceScanner::getCacheFile()
+{
+    return atk::getSettingsFile("atkAudio Device Cache");
+}
+
+void AudioDeviceScanner::loadFromDisk()
+{
+    const auto file = getCacheFile();
+    if (!file.existsAsFile())
+        return;
+
+    auto root = juce::XmlDocument::parse(file);
+    if (root == nullptr || !root->hasTagName("AUDIO_DEVICES") || root->getIntAttribute("version") != kCacheVersion)
+    {
+        atk::logging::warning("AudioDeviceScanner::loadFromDisk", "ignoring unreadable " + file.getFullPathName());
+        return;
+    }
+
+    auto loaded = std::make_shared<DeviceScanSnapshot>();
+    loaded->fromDisk = true;
+
+    for (auto* element : root->getChildWithTagNameIterator("DEVICE"))
+    {
+        ScannedDevice device;
+        device.typeName = element->getStringAttribute("type");
+        device.name = element->getStringAttribute("name");
+        device.isInput = element->getBoolAttribute("input");
+        device.isOutput = element->getBoolAttribute("output");
+        device.probed = element->getBoolAttribute("probed");
+
+        if (device.probed)
+        {
+            device.inputChannelNames = juce::StringArray::fromLines(element->getStringAttribute("inputChannels"));
+            device.outputChannelNames = juce::StringArray::fromLines(element->getStringAttribute("outputChannels"));
+            device.inputChannelNames.removeEmptyStrings();
+            device.outputChannelNames.removeEmptyStrings();
+
+            for (const auto& rate : juce::StringArray::fromTokens(element->getStringAttribute("sampleRates"), ",", ""))
+                device.sampleRates.add(rate.getDoubleValue());
+            for (const auto& size : juce::StringArray::fromTokens(element->getStringAttribute("bufferSizes"), ",", ""))
+                device.bufferSizes.add(size.getIntValue());
+        }
+
+        if (device.name.isNotEmpty())
+            loaded->devices.push_back(std::move(device));
+    }
+
+    atk::logging::info(
+        "AudioDeviceScanner::loadFromDisk",
+        juce::String::formatted("%d cached devices", static_cast<int>(loaded->devices.size()))
+    );
+
+    std::lock_guard<std::mutex> lock(snapshotMutex);
+    snapshot = std::move(loaded);
+}
+
+void AudioDeviceScanner::saveToDisk(const DeviceScanSnapshot& toSave) const
+{
+    juce::XmlElement root("AUDIO_DEVICES");
+    root.setAttribute("version", kCacheVersion);
+
+    for (const auto& device : toSave.devices)
+    {
+        auto* element = root.createNewChildElement("DEVICE");
+        element->setAttribute("type", device.typeName);
+        element->setAttribute("name", device.name);
+        element->setAttribute("input", device.isInput);
+        element->setAttribute("output", device.isOutput);
+        element->setAttribute("probed", device.probed);
+
+        if (device.probed)
+        {
+            element->setAttribute("inputChannels", device.inputChannelNames.joinIntoString("\n"));
+            element->setAttribute("outputChannels", device.outputChannelNames.joinIntoString("\n"));
+            element->setAttribute("sampleRates", joinNumbers(device.sampleRates));
+            element->setAttribute("bufferSizes", joinNumbers(device.bufferSizes));
+        }
+    }
+
+    const auto file = getCacheFile();
+    file.getParentDirectory().createDirectory();
+    if (!root.writeTo(file))
+        atk::logging::warning("AudioDeviceScanner::saveToDisk", "could not write " + file.getFullPathName());
+}
+
+} // namespace atk
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <juce_audio_devices/juce_audio_devices.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace atk
+{
+
+// What one scan found out about a device
+struct ScannedDevice
+{
+    juce::String typeName;
+    juce::String name;
+    bool isInput = false;
+    bool isOutput = false;
+
+    // Filled once the device has been probed; see AudioDeviceScanner
+    bool probed = false;
+    juce::StringArray inputChannelNames;
+    juce::StringArray outputChannelNames;
+    juce::Array<double> sampleRates;
+    juce::Array<int> bufferSizes;
+
+    bool operator==(const ScannedDevice& other) const;
+};
+
+struct DeviceScanSnapshot
+{
+    std::vector<ScannedDevice> devices; // grouped by type, in the order the types list them
+    bool fromDisk = false;              // loaded from the cache, not yet confirmed by a scan
+    juce::StringArray changedDevices;   // added, removed or changed since the previous snapshot
+
+    // Any type when typeName is empty
+    const ScannedDevice* find(const juce::String& deviceName, const juce::String& typeName = {}) const;
+    juce::StringArray getDeviceNames(bool isInput) const;
+    std::map<juce::String, juce::StringArray> getDevicesByType(bool isInput) const;
+};
+
+// Enumerates audio devices on a background thread so that nothing on the message thread has to wait
+// for a driver. The last result is kept on disk and loaded by start(), so the device list is
+// available at once and is then confirmed or corrected by the first scan.
+//
+// Scans are incremental: device lists are always read again, but only devices that are new, or were
+// passed to forgetDevice(), are probed for channels, sample rates and buffer sizes. ASIO devices, and
+// aggregates that may contain them, are listed but not probed here, as loading a driver another
+// client holds can take it away from them; AudioServer probes those on demand as before.
+//
+// A ChangeBroadcaster: listeners hear on the message thread whenever a scan changed the snapshot.
+class AudioDeviceScanner
+    : public juce::ChangeBroadcaster
+    , private juce::Thread
+{
+public:
+    AudioDeviceScanner();
+    ~AudioDeviceScanner() override;
+
+    // Loads the disk cache, starts the thread and requests the first scan
+    void start();
+    void stop();
+
+    // Coalesces with a scan that has not started yet
+    void requestRescan();
+
+    // The next scan probes the device again
+    void forgetDevice(const juce::String& deviceName);
+
+    // Never null; empty until the disk cache or a scan provided something
+    std::shared_ptr<const DeviceScanSnapshot> getSnapshot() const;
+
+private:
+    void run() override;
+    void scan();
+    void publish(std::shared_ptr<DeviceScanSnapshot> snapshot);
+
+    static bool shouldProbe(const juce::String& typeName);
+    static void probe(juce::AudioIODeviceType& type, ScannedDevice& device);
+
+    void loadFromDisk();
+    void saveToDisk(const DeviceScanSnapshot& snapshot) const;
+    static juce::File getCacheFile();
+
+    std::unique_ptr<juce::AudioDeviceManager> scanManager; // scan thread only
+
+    mutable std::mutex snapshotMutex;
+    std::shared_ptr<const DeviceScanSnapshot> snapshot{std::make_shared<DeviceScanSnapshot>()};
+
+    std::mutex requestMutex;
+    bool rescanRequested = false;
+    juce::StringArray forgottenDevices;
+
+    JUCE_DECLARE_NON_COPYABLE(AudioDeviceScanner)
+};
+
+} // namespace atk
@@ -1,6 +1,12 @@
 #include "AudioServer.h"
+#include "AggregateAudioDevices.h"
+#include "DeviceIdlePolicies.h"
+#include "VirtualAudioDevices.h"
+#include <atkaudio/AudioProcessorGraphMT/RealtimeThreadPool.h>
 #include <atkaudio/atkaudio.h>
+#include <atkaudio/Denormals.h>
 #include <atkaudio/Logging.h>
+#include <atkaudio/RealtimeMemory.h>
 
 namespace atk
 {
@@ -20,8 +26,11 @@ juce::AudioDeviceManager* AudioDeviceEnumerator::ensureEnumerator()
 {
     if (!enumerator) {
         std::lock_guard<std::mutex> lock(enumeratorMutex);
-        if (!enumerator)
+        if (!enumerator) {
             enumerator = std::make_unique<juce::AudioDeviceManager>();
+            VirtualAudioDevices::addDeviceTypes(*enumerator);
+            AggregateAudioDevices::addDeviceTypes(*enumerator);
+        }
     }
     return enumerator.get();
 }
@@ -270,7 +279,6 @@ AudioClient::AudioClient(int bufferSize)
 {
     // Pre-allocate temp buffers with reasonable initial size
     tempInputBuffer.setSize(8, 1024, false, false, true);
-    tempOutputBuffer.setSize(8, 1024, false, false, true);
     tempInputPointers.resize(8);
     tempOutputPointers.resize(8);
 
@@ -291,7 +299,6 @@ AudioClient::AudioClient(AudioClient&& other) noexcept
     , clientBufferSize(other.clientBufferSize)
     , bufferSnapshot(other.bufferSnapshot.exchange(std::make_shared<BufferSnapshot>()))
     , tempInputBuffer(std::move(other.tempInputBuffer))
-    , tempOutputBuffer(std::move(other.tempOutputBuffer))
     , tempInputPointers(std::move(other.tempInputPointers))
     , tempOutputPointers(std::move(other.tempOutputPointers))
 {
@@ -308,7 +315,6 @@ AudioClient& AudioClient::operator=(AudioClient&& other) noexcept
         clientBufferSize = other.clientBufferSize;
         bufferSnapshot.store(other.bufferSnapshot.exchange(std::make_shared<BufferSnapshot>()));
         tempInputBuffer = std::move(other.tempInputBuffer);
-        tempOutputBuffer = std::move(other.tempOutputBuffer);
         tempInputPointers = std::move(other.tempInputPointers);
         tempOutputPointers = std::move(other.tempOutputPointers);
 
@@ -318,109 +324,143 @@ AudioClient& AudioClient::operator=(AudioClient&& other) noexcept
 }
 
 void AudioClient::pullSubscribedInputs(
-    juce::AudioBuffer<float>& deviceBuffer,
+    float* const* dest,
+    int numChannels,
     int numSamples,
     double sampleRate
 )
 {
     auto snapshot = bufferSnapshot.load(std::memory_order_acquire);
-    if (!snapshot || snapshot->inputGroups.empty()) {
-        deviceBuffer.clear();
-        return;
-    }
-
-    int numSubs = static_cast<int>(snapshot->inputBuffers.size());
-    if (deviceBuffer.getNumChannels() < numSubs) {
-        deviceBuffer.clear();
+    if (!snapshot
+        || snapshot->inputGroups.empty()
+        || numChannels < static_cast<int>(snapshot->inputBuffers.size())) {
+        for (int ch = 0; ch < numChannels; ++ch)
+            juce::FloatVectorOperations::clear(dest[ch], numSamples);
         return;
     }
 
-    deviceBuffer.clear();
+    // The groups write every other channel
+    const int numSubs = static_cast<int>(snapshot->state.inputSubscriptions.size());
+    for (int ch = numSubs; ch < numChannels; ++ch)
+        juce::FloatVectorOperations::clear(dest[ch], numSamples);
+    for (int subIdx : snapshot->silentInputs)
+        if (subIdx < numChannels)
+            juce::FloatVectorOperations::clear(dest[subIdx], numSamples);
 
-    // Use pre-grouped buffers (no runtime allocation)
     for (const auto& group : snapshot->inputGroups) {
-        if (!group.buffer)
+        // Only the subscribed device channels, already at our rate in the device's shared input
+        int numBufCh = group.numChannels;
+        if (!group.inputTap || numBufCh <= 0)
             continue;
 
-        int numDevCh = group.maxDeviceChannel + 1;
-
-        // Use pre-allocated temp buffer (should already be sized from audioDeviceAboutToStart)
-        // Only resize if absolutely necessary (this path should rarely be hit)
-        if (tempInputBuffer.getNumChannels() < numDevCh
-            || tempInputBuffer.getNumSamples() < numSamples)
-            tempInputBuffer.setSize(numDevCh, numSamples, false, false, true);
+        if (static_cast<int>(tempInputPointers.size()) < numBufCh)
+            tempInputPointers.resize(numBufCh);
 
-        if (static_cast<int>(tempInputPointers.size()) < numDevCh)
-            tempInputPointers.resize(numDevCh);
+        // Each tap channel lands in the first subscription to it
+        std::fill_n(tempInputPointers.begin(), numBufCh, nullptr);
+        for (const auto& [subIdx, bufCh] : group.channelMap)
+            if (bufCh < numBufCh && subIdx < numChannels && tempInputPointers[bufCh] == nullptr)
+                tempInputPointers[bufCh] = dest[subIdx];
 
-        for (int ch = 0; ch < numDevCh; ++ch)
+        // A tap channel nobody here reads still needs somewhere to go; rarely, if ever, hit
+        for (int ch = 0; ch < numBufCh; ++ch) {
+            if (tempInputPointers[ch] != nullptr)
+                continue;
+            if (tempInputBuffer.getNumChannels() < numBufCh
+                || tempInputBuffer.getNumSamples() < numSamples)
+                tempInputBuffer.setSize(numBufCh, numSamples, false, false, true);
             tempInputPointers[ch] = tempInputBuffer.getWritePointer(ch);
+        }
+
+        const bool read =
+            group.inputTap->read(tempInputPointers.data(), numBufCh, numSamples, sampleRate);
 
-        if (group.buffer->read(tempInputPointers.data(), numDevCh, numSamples, sampleRate, false)) {
-            for (const auto& [subIdx, devCh] : group.channelMap)
-                if (devCh < numDevCh && subIdx < deviceBuffer.getNumChannels())
-                    deviceBuffer.copyFrom(subIdx, 0, tempInputBuffer, devCh, 0, numSamples);
+        for (const auto& [subIdx, bufCh] : group.channelMap) {
+            if (bufCh >= numBufCh || subIdx >= numChannels)
+                continue;
+            if (!read)
+                juce::FloatVectorOperations::clear(dest[subIdx], numSamples);
+            else if (tempInputPointers[bufCh] != dest[subIdx])
+                juce::FloatVectorOperations::copy(
+                    dest[subIdx], tempInputPointers[bufCh], numSamples);
         }
     }
 }
 
 void AudioClient::pushSubscribedOutputs(
-    const juce::AudioBuffer<float>& deviceBuffer,
+    const float* const* src,
+    int numChannels,
     int numSamples,
     double sampleRate
 )
 {
     auto snapshot = bufferSnapshot.load(std::memory_order_acquire);
-    if (!snapshot || snapshot->outputGroups.empty())
+    if (!snapshot
+        || snapshot->outputGroups.empty()
+        || numChannels < static_cast<int>(snapshot->outputBuffers.size()))
         return;
 
-    int numSubs = static_cast<int>(snapshot->outputBuffers.size());
-    if (deviceBuffer.getNumChannels() < numSubs)
-        return;
-
-    // Use pre-grouped buffers (no runtime allocation)
     for (const auto& group : snapshot->outputGroups) {
-        if (!group.buffer)
+        if (!group.outputTap)
             continue;
 
-        int numDevCh = group.maxDeviceChannel + 1;
-
-        // Use pre-allocated temp buffer (should already be sized)
-        if (tempOutputBuffer.getNumChannels() < numDevCh
-            || tempOutputBuffer.getNumSamples() < numSamples)
-            tempOutputBuffer.setSize(numDevCh, numSamples, false, false, true);
-
+        int numDevCh = group.numChannels;
         if (static_cast<int>(tempOutputPointers.size()) < numDevCh)
             tempOutputPointers.resize(numDevCh);
 
-        tempOutputBuffer.clear(0, numSamples);
-
+        // Device channels nobody here plays to add nothing to the mix
+        std::fill_n(tempOutputPointers.begin(), numDevCh, nullptr);
         for (const auto& [subIdx, devCh] : group.channelMap)
-            if (subIdx < deviceBuffer.getNumChannels() && devCh < numDevCh)
-                tempOutputBuffer.copyFrom(devCh, 0, deviceBuffer, subIdx, 0, numSamples);
-
-        for (int ch = 0; ch < numDevCh; ++ch)
-            tempOutputPointers[ch] = tempOutputBuffer.getReadPointer(ch);
+            if (subIdx < numChannels && devCh < numDevCh)
+                tempOutputPointers[devCh] = src[subIdx];
 
-        group.buffer->write(tempOutputPointers.data(), numDevCh, numSamples, sampleRate);
+        // Mixed with the device's other clients at our rate, resampled once for all of them
+        group.outputTap->write(tempOutputPointers.data(), numDevCh, numSamples, sampleRate);
     }
 }
 
+void AudioClient::pullSubscribedInputs(
+    juce::AudioBuffer<float>& deviceBuffer,
+    int numSamples,
+    double sampleRate
+)
+{
+    pullSubscribedInputs(
+        deviceBuffer.getArrayOfWritePointers(),
+        deviceBuffer.getNumChannels(),
+        numSamples,
+        sampleRate
+    );
+}
+
+void AudioClient::pushSubscribedOutputs(
+    const juce::AudioBuffer<float>& deviceBuffer,
+    int numSamples,
+    double sampleRate
+)
+{
+    pushSubscribedOutputs(
+        deviceBuffer.getArrayOfReadPointers(),
+        deviceBuffer.getNumChannels(),
+        numSamples,
+        sampleRate
+    );
+}
+
 void AudioClient::clearBuffers()
 {
     auto snapshot = bufferSnapshot.load(std::memory_order_acquire);
     if (!snapshot)
         return;
 
-    // Clear all input buffers
+    // Input is shared with the device's other clients, so rejoin it rather than reset it
     for (const auto& bufRef : snapshot->inputBuffers)
-        if (bufRef.buffer)
-            bufRef.buffer->reset();
+        if (bufRef.inputTap)
+            bufRef.inputTap->realign();
 
-    // Clear all output buffers
     for (const auto& bufRef : snapshot->outputBuffers)
-        if (bufRef.buffer)
-            bufRef.buffer->reset();
+        if (bufRef.outputTap)
+            bufRef.outputTap->realign();
 }
 
 void AudioClient::setSubscriptions(const AudioClientState& state)
@@ -447,6 +487,26 @@ int AudioClient::getNumOutputSubscriptions() const
     return snapshot ? static_cast<int>(snapshot->outputBuffers.size()) : 0;
 }
 
+std::vector<AudioClient::SubscriptionStats> AudioClient::getSubscriptionStats() const
+{
+    std::vector<SubscriptionStats> result;
+    auto snapshot = bufferSnapshot.load(std::memory_order_acquire);
+    if (!snapshot)
+        return result;
+
+    result.reserve(snapshot->inputBuffers.size() + snapshot->outputBuffers.size());
+    for (const auto& ref : snapshot->inputBuffers)
+        result.push_back(
+            {ref.subscription, ref.inputTap ? ref.inputTap->getStats() : SyncBufferStats{}}
+        );
+    for (const auto& ref : snapshot->outputBuffers)
+        result.push_back(
+            {ref.subscription, ref.outputTap ? ref.outputTap->getStats() : SyncBufferStats{}}
+        );
+
+    return result;
+}
+
 void AudioClient::updateBufferSnapshot(std::shared_ptr<BufferSnapshot> newSnapshot)
 {
     bufferSnapshot.store(std::move(newSnapshot), std::memory_order_release);
@@ -460,10 +520,6 @@ void AudioClient::ensureTempBufferCapacity(int numChannels, int numSamples)
         || tempInputBuffer.getNumSamples() < numSamples)
         tempInputBuffer.setSize(numChannels, numSamples, false, false, true);
 
-    if (tempOutputBuffer.getNumChannels() < numChannels
-        || tempOutputBuffer.getNumSamples() < numSamples)
-        tempOutputBuffer.setSize(numChannels, numSamples, false, false, true);
-
     if (static_cast<int>(tempInputPointers.size()) < numChannels)
         tempInputPointers.resize(numChannels);
 
@@ -482,10 +538,16 @@ AudioDeviceHandler::AudioDeviceHandler(const juce::String& name)
 AudioDeviceHandler::~AudioDeviceHandler()
 {
     closeDevice();
+
+    // No device callback runs any more; a parallel job may still
+    std::lock_guard<std::mutex> lock(directCallbackMutex);
+    for (auto& [callback, info] : directCallbacks)
+        waitForDirectCallbackJob(info);
 }
 
 bool AudioDeviceHandler::openDevice(const juce::AudioDeviceManager::AudioDeviceSetup& preferredSetup)
 {
+    std::lock_guard<std::mutex> lock(deviceOpenMutex);
     bool wasAlreadyOpen = isDeviceOpen();
 
     if (wasAlreadyOpen) {
@@ -501,6 +563,8 @@ bool AudioDeviceHandler::openDevice(const juce::AudioDeviceManager::AudioDeviceS
 
     // Initialize device manager to make device types available
     deviceManager->initialiseWithDefaultDevices(0, 0);
+    VirtualAudioDevices::addDeviceTypes(*deviceManager);
+    AggregateAudioDevices::addDeviceTypes(*deviceManager);
 
     // Find the device type
     juce::AudioIODeviceType* deviceType = nullptr;
@@ -596,6 +660,7 @@ bool AudioDeviceHandler::openDevice(const juce::AudioDeviceManager::AudioDeviceS
 
 void AudioDeviceHandler::closeDevice()
 {
+    std::lock_guard<std::mutex> lock(deviceOpenMutex);
     if (!isDeviceOpen())
         return;
 
@@ -620,6 +685,11 @@ void AudioDeviceHandler::audioDeviceIOCallbackWithContext(
     const juce::AudioIODeviceCallbackContext& context
 )
 {
+    // Covers SyncBuffer resampling and every direct callback (PluginHost2 graphs) run below
+    ScopedFlushDenormals noDenormals;
+    const int64_t callbackStartNs = steadyNowNs();
+    rtmemory::samplePageFaults();
+
     // Clear output channels first - we'll accumulate into them
     if (outputChannelData)
         for (int ch = 0; ch < numOutputChannels; ++ch)
@@ -631,70 +701,28 @@ void AudioDeviceHandler::audioDeviceIOCallbackWithContext(
         auto snapshot = activeSnapshot.load(std::memory_order_acquire);
 
         if (isRunning.load(std::memory_order_acquire) && snapshot) {
-            double deviceSampleRate = getSampleRate();
-
-            // REAL-TIME SAFE: Process each client using lock-free snapshot
-            for (const auto& [clientId, buffers] : snapshot->clients) {
-                // Handle input: device -> client (subscribers get original clean input)
-                if (inputChannelData && buffers.inputBuffer) {
-                    // Prepare multichannel write buffer
-                    int maxDevChannel = 0;
-                    for (const auto& mapping : buffers.inputMappings)
-                        maxDevChannel = std::max(maxDevChannel, mapping.deviceChannel.channelIndex);
-                    int numDeviceChannels = std::min(maxDevChannel + 1, numInputChannels);
-
-                    if (numDeviceChannels > 0
-                        && numDeviceChannels <= static_cast<int>(rtInputPointers.size())
-                        && numDeviceChannels <= numInputChannels) {
-                        // REAL-TIME SAFE: Use pre-allocated pointer array
-                        for (int ch = 0; ch < numDeviceChannels; ++ch)
-                            rtInputPointers[ch] = inputChannelData[ch];
-
-                        // Write all device channels to multichannel SyncBuffer
-                        buffers.inputBuffer->write(
-                            rtInputPointers.data(),
-                            numDeviceChannels,
-                            numSamples,
-                            deviceSampleRate
-                        );
-                    }
-                }
+            double deviceSampleRate = currentSampleRate.load(std::memory_order_relaxed);
+
+            // Handle input: device -> clients. One write serves every client; the shared input
+            // is converted to the client rate once, on the client side, so none of this grows
+            // with the number of clients
+            if (inputChannelData && snapshot->hasInputClients && sharedInput)
+                sharedInput->writeFromDevice(
+                    inputChannelData,
+                    numInputChannels,
+                    numSamples,
+                    deviceSampleRate
+                );
 
-                // Handle output: client -> device (sum into output)
-                if (outputChannelData && buffers.outputBuffer) {
-                    // Determine how many device channels we need to read
-                    int maxDevChannel = 0;
-                    for (const auto& mapping : buffers.outputMappings)
-                        maxDevChannel = std::max(maxDevChannel, mapping.deviceChannel.channelIndex);
-                    int numDeviceChannels = std::min(maxDevChannel + 1, numOutputChannels);
-
-                    if (numDeviceChannels > 0
-                        && numDeviceChannels <= rtSubscriptionTempBuffer.getNumChannels()
-                        && numDeviceChannels <= static_cast<int>(rtSubscriptionPointers.size())) {
-                        // REAL-TIME SAFE: Use pre-allocated buffer and pointer array
-                        for (int ch = 0; ch < numDeviceChannels; ++ch)
-                            rtSubscriptionPointers[ch] =
-                                rtSubscriptionTempBuffer.getWritePointer(ch);
-
-                        if (buffers.outputBuffer->read(
-                                rtSubscriptionPointers.data(),
-                                numDeviceChannels,
-                                numSamples,
-                                deviceSampleRate,
-                                false
-                            )) {
-                            // Sum each channel into device output
-                            for (int ch = 0; ch < numDeviceChannels; ++ch)
-                                if (ch < numOutputChannels)
-                                    juce::FloatVectorOperations::add(
-                                        outputChannelData[ch],
-                                        rtSubscriptionPointers[ch],
-                                        numSamples
-                                    );
-                        }
-                    }
-                }
-            }
+            // Handle output: clients -> device. The clients' mix is resampled once and summed
+            // into the device output
+            if (outputChannelData && snapshot->hasOutputClients && sharedOutput)
+                sharedOutput->readToDevice(
+                    outputChannelData,
+                    numOutputChannels,
+                    numSamples,
+                    deviceSampleRate
+                );
         }
     }
 
@@ -703,6 +731,23 @@ void AudioDeviceHandler::audioDeviceIOCallbackWithContext(
     // All outputs are then summed into the final device output
     auto directSnapshot = directCallbackSnapshot.load(std::memory_order_acquire);
     if (directSnapshot && !directSnapshot->callbacks.empty()) {
+        auto* pool = parallelDirectCallbacks.load(std::memory_order_relaxed)
+                         ? RealtimeThreadPool::getInstance()
+                         : nullptr;
+        if (pool != nullptr && pool->isReady() && directSnapshot->callbacks.size() > 1) {
+            processDirectCallbacksParallel(
+                *directSnapshot,
+                inputChannelData,
+                numInputChannels,
+                outputChannelData,
+                numOutputChannels,
+                numSamples,
+                context,
+                callbackStartNs
+            );
+            return;
+        }
+
         for (DirectCallbackInfo* info : directSnapshot->callbacks) {
             if (info == nullptr || info->callback == nullptr)
                 continue;
@@ -715,15 +760,11 @@ void AudioDeviceHandler::audioDeviceIOCallbackWithContext(
             if (numOutputChannels > static_cast<int>(info->outputPointers.size()))
                 continue;
 
-            // REAL-TIME SAFE: Use pre-allocated buffer and pointer array
-            for (int ch = 0; ch < numOutputChannels; ++ch)
-                info->outputPointers[ch] = info->tempOutputBuffer.getWritePointer(ch);
-
             // Call the direct callback with clean input and its own temp output buffer
-            info->callback->audioDeviceIOCallbackWithContext(
-                inputChannelData, // Clean input (original device input)
+            runDirectCallback(
+                *info,
+                inputChannelData,
                 numInputChannels,
-                info->outputPointers.data(), // Pre-allocated temp output buffer
                 numOutputChannels,
                 numSamples,
                 context
@@ -741,6 +782,203 @@ void AudioDeviceHandler::audioDeviceIOCallbackWithContext(
     }
 }
 
+void AudioDeviceHandler::runDirectCallback(
+    DirectCallbackInfo& info,
+    const float* const* inputChannelData,
+    int numInputChannels,
+    int numOutputChannels,
+    int numSamples,
+    const juce::AudioIODeviceCallbackContext& context
+)
+{
+    // REAL-TIME SAFE: Use pre-allocated buffer and pointer array
+    for (int ch = 0; ch < numOutputChannels; ++ch)
+        info.outputPointers[ch] = info.tempOutputBuffer.getWritePointer(ch);
+
+    info.callback->audioDeviceIOCallbackWithContext(
+        inputChannelData, // Clean input (original device input)
+        numInputChannels,
+        info.outputPointers.data(), // Pre-allocated temp output buffer
+        numOutputChannels,
+        numSamples,
+        context
+    );
+}
+
+void AudioDeviceHandler::runDirectCallbackJob(DirectCallbackInfo& info)
+{
+    juce::AudioIODeviceCallbackContext context;
+    context.hostTimeNs = info.hasHostTime ? &info.hostTimeNs : nullptr;
+
+    runDirectCallback(
+        info,
+        info.numInputChannels > 0 ? info.inputPointers.data() : nullptr,
+        info.numInputChannels,
+        info.numOutputChannels,
+        info.numSamples,
+        context
+    );
+}
+
+void AudioDeviceHandler::executeDirectCallbackTask(void* userData)
+{
+    auto* info = static_cast<DirectCallbackInfo*>(userData);
+
+    // The device thread may have taken the job back already
+    int expected = DirectJobQueued;
+    if (info->jobState
+            .compare_exchange_strong(expected, DirectJobRunning, std::memory_order_acq_rel)) {
+        ScopedFlushDenormals noDenormals;
+        runDirectCallbackJob(*info);
+        info->jobState.store(DirectJobDone, std::memory_order_release);
+    }
+
+    info->tasksInFlight.fetch_sub(1, std::memory_order_release);
+}
+
+void AudioDeviceHandler::processDirectCallbacksParallel(
+    const DirectCallbackSnapshot& snapshot,
+    const float* const* inputChannelData,
+    int numInputChannels,
+    float* const* outputChannelData,
+    int numOutputChannels,
+    int numSamples,
+    const juce::AudioIODeviceCallbackContext& context,
+    int64_t callbackStartNs
+)
+{
+    auto* pool = RealtimeThreadPool::getInstance();
+    auto& callbacks = snapshot.callbacks;
+
+    auto isSized = [&](const DirectCallbackInfo* info) {
+        return info != nullptr && info->callback != nullptr
+            && numOutputChannels <= info->tempOutputBuffer.getNumChannels()
+            && numOutputChannels <= static_cast<int>(info->outputPointers.size());
+    };
+
+    // Hand every callback but the first to the workers
+    for (size_t i = 1; i < callbacks.size(); ++i) {
+        DirectCallbackInfo* info = callbacks[i];
+        if (info == nullptr)
+            continue;
+
+        info->dispatched = false;
+        if (!isSized(info))
+            continue;
+
+        // A job that missed an earlier deadline keeps its callback until it returns; its late
+        // output is dropped
+        int state = info->jobState.load(std::memory_order_acquire);
+        if (state == DirectJobDone) {
+            info->jobState.store(DirectJobIdle, std::memory_order_relaxed);
+            state = DirectJobIdle;
+        }
+        if (state != DirectJobIdle) {
+            missedDirectCallbackBlocks.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        // Sized in audioDeviceAboutToStart, like the output; a larger block is skipped
+        const int numInputs = inputChannelData != nullptr ? numInputChannels : 0;
+        if (numInputs > info->tempInputBuffer.getNumChannels()
+            || numInputs > static_cast<int>(info->inputPointers.size())
+            || numSamples > info->tempInputBuffer.getNumSamples())
+            continue;
+
+        for (int ch = 0; ch < numInputs; ++ch) {
+            if (inputChannelData[ch] != nullptr)
+                info->tempInputBuffer.copyFrom(ch, 0, inputChannelData[ch], numSamples);
+            else
+                info->tempInputBuffer.clear(ch, 0, numSamples);
+            info->inputPointers[ch] = info->tempInputBuffer.getReadPointer(ch);
+        }
+        info->numInputChannels = numInputs;
+        info->numOutputChannels = numOutputChannels;
+        info->numSamples = numSamples;
+        info->hasHostTime = context.hostTimeNs != nullptr;
+        info->hostTimeNs = info->hasHostTime ? *context.hostTimeNs : 0;
+        info->dispatched = true;
+        info->jobState.store(DirectJobQueued, std::memory_order_release);
+
+        // A full queue leaves the job to the device thread below
+        info->tasksInFlight.fetch_add(1, std::memory_order_relaxed);
+        if (!pool->submitTask(&AudioDeviceHandler::executeDirectCallbackTask, info))
+            info->tasksInFlight.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // The first callback runs here, on the device input itself
+    DirectCallbackInfo* first = callbacks[0];
+    const bool firstRan = isSized(first);
+    if (firstRan)
+        runDirectCallback(
+            *first,
+            inputChannelData,
+            numInputChannels,
+            numOutputChannels,
+            numSamples,
+            context
+        );
+
+    // Then whatever no worker has picked up yet
+    for (size_t i = 1; i < callbacks.size(); ++i) {
+        DirectCallbackInfo* info = callbacks[i];
+        if (info == nullptr || !info->dispatched)
+            continue;
+
+        int expected = DirectJobQueued;
+        if (info->jobState.compare_exchange_strong(
+                expected,
+                DirectJobRunning,
+                std::memory_order_acq_rel
+            )) {
+            runDirectCallbackJob(*info);
+            info->jobState.store(DirectJobDone, std::memory_order_release);
+        }
+    }
+
+    // Wait for the rest, but not past the deadline
+    const double sampleRate = currentSampleRate.load(std::memory_order_relaxed);
+    const double blockNs = sampleRate > 0.0 ? numSamples * 1.0e9 / sampleRate : 0.0;
+    const int64_t deadlineNs =
+        callbackStartNs + static_cast<int64_t>(blockNs * DIRECT_CALLBACK_WAIT_FRACTION);
+
+    for (size_t i = 1; i < callbacks.size(); ++i) {
+        DirectCallbackInfo* info = callbacks[i];
+        if (info == nullptr || !info->dispatched)
+            continue;
+
+        while (info->jobState.load(std::memory_order_acquire) != DirectJobDone
+               && steadyNowNs() < deadlineNs)
+            cpuPause();
+    }
+
+    // Sum in snapshot order, as the serial path does
+    for (size_t i = 0; i < callbacks.size(); ++i) {
+        DirectCallbackInfo* info = callbacks[i];
+        if (i == 0) {
+            if (!firstRan)
+                continue;
+        } else {
+            if (info == nullptr || !info->dispatched)
+                continue;
+
+            if (info->jobState.load(std::memory_order_acquire) != DirectJobDone) {
+                missedDirectCallbackBlocks.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            info->jobState.store(DirectJobIdle, std::memory_order_relaxed);
+        }
+
+        for (int ch = 0; ch < numOutputChannels; ++ch) {
+            juce::FloatVectorOperations::add(
+                outputChannelData[ch],
+                info->tempOutputBuffer.getReadPointer(ch),
+                numSamples
+            );
+        }
+    }
+}
+
 void AudioDeviceHandler::audioDeviceAboutToStart(juce::AudioIODevice* device)
 {
     juce::ignoreUnused(device);
@@ -752,17 +990,13 @@ void AudioDeviceHandler::audioDeviceAboutToStart(juce::AudioIODevice* device)
     );
     int bufferSize = device->getCurrentBufferSizeSamples();
 
-    // Pre-allocate subscription processing buffers
-    rtSubscriptionTempBuffer.setSize(maxChannels, bufferSize, false, false, true);
-    rtSubscriptionPointers.resize(maxChannels);
-    rtInputPointers.resize(maxChannels);
-
     // Pre-allocate direct callback buffers and notify callbacks
     {
         std::lock_guard<std::mutex> lock(directCallbackMutex);
         for (auto& [callback, info] : directCallbacks) {
-            info.tempOutputBuffer.setSize(maxChannels, bufferSize, false, false, true);
-            info.outputPointers.resize(maxChannels);
+            // A job that overran the last block before the device stopped may still be running
+            waitForDirectCallbackJob(info);
+            allocateDirectCallbackBuffers(info, maxChannels, bufferSize);
 
             // Notify the callback about the device starting
             if (callback != nullptr)
@@ -774,6 +1008,17 @@ void AudioDeviceHandler::audioDeviceAboutToStart(juce::AudioIODevice* device)
     // Check if we have active subscriptions and enable processing
     {
         std::lock_guard<std::mutex> lock(clientBuffersMutex);
+
+        // A new channel count needs a new shared input or output; clients are moved over to it
+        int numInputChannels = device->getActiveInputChannels().countNumberOfSetBits();
+        if (!sharedInput || sharedInput->getNumDeviceChannels() != numInputChannels)
+            sharedInput = std::make_shared<SharedDeviceInput>(numInputChannels);
+        int numOutputChannels = device->getActiveOutputChannels().countNumberOfSetBits();
+        if (!sharedOutput || sharedOutput->getNumDeviceChannels() != numOutputChannels)
+            sharedOutput = std::make_shared<SharedDeviceOutput>(numOutputChannels);
+        currentSampleRate.store(device->getCurrentSampleRate(), std::memory_order_relaxed);
+        rebuildSnapshotLocked();
+
         if (!clientBuffers.empty())
             isRunning.store(true, std::memory_order_release);
     }
@@ -787,9 +1032,12 @@ void AudioDeviceHandler::audioDeviceStopped()
     // Notify all direct callbacks that the device has stopped
     {
         std::lock_guard<std::mutex> lock(directCallbackMutex);
-        for (auto& [callback, info] : directCallbacks)
+        for (auto& [callback, info] : directCallbacks) {
+            // Not while a parallel job that overran its block is still inside the callback
+            waitForDirectCallbackJob(info);
             if (callback != nullptr)
                 callback->audioDeviceStopped();
+        }
     }
 
     isRunning.store(false, std::memory_order_release);
@@ -874,56 +1122,27 @@ void AudioDeviceHandler::addClientSubscription(
 
     if (isInput) {
         buffers.inputMappings = mappings;
+        buffers.inputChannels = getSubscribedChannels(mappings);
 
-        // Create single multichannel SyncBuffer for all device input channels
-        if (!buffers.inputBuffer) {
-            buffers.inputBuffer = std::make_shared<SyncBuffer>();
-
-            // Use device's actual input channel count
-            int numChannels = 2; // Default fallback
-            if (auto* device = deviceManager->getCurrentAudioDevice())
-                numChannels = device->getActiveInputChannels().countNumberOfSetBits();
-
-            // Pre-configure reader side with OBS parameters (typical: 48kHz, 480 samples)
-            // This allows writer (device callback) to prepare immediately
-            juce::AudioBuffer<float> dummyBuffer(numChannels, 480);
-            dummyBuffer.clear();
-            std::vector<float*> dummyPointers(numChannels);
-            for (int ch = 0; ch < numChannels; ++ch)
-                dummyPointers[ch] = dummyBuffer.getWritePointer(ch);
-
-            buffers.inputBuffer->read(dummyPointers.data(), numChannels, 480, 48000.0, false);
+        // The tap is bound to the device's shared input by rebuildSnapshotLocked() below
+        if (!buffers.inputTap) {
+            buffers.inputTap = std::make_shared<DeviceInputTap>();
 
             atk::logging::debug(
                 "AudioDeviceHandler::addClientSubscription",
-                "created input SyncBuffer for \"" + deviceName + "\""
+                "created input tap for \"" + deviceName + "\""
             );
         }
     } else {
         buffers.outputMappings = mappings;
 
-        // Create single multichannel SyncBuffer for all device output channels
-        if (!buffers.outputBuffer) {
-            buffers.outputBuffer = std::make_shared<SyncBuffer>();
-
-            // Use device's actual output channel count
-            int numChannels = 2; // Default fallback
-            if (auto* device = deviceManager->getCurrentAudioDevice())
-                numChannels = device->getActiveOutputChannels().countNumberOfSetBits();
-
-            // Pre-configure writer side with OBS parameters (client will write at 48kHz, 480
-            // samples) This allows reader (device callback) to prepare immediately
-            juce::AudioBuffer<float> dummyBuffer(numChannels, 480);
-            dummyBuffer.clear();
-            std::vector<const float*> dummyPointers(numChannels);
-            for (int ch = 0; ch < numChannels; ++ch)
-                dummyPointers[ch] = dummyBuffer.getReadPointer(ch);
-
-            buffers.outputBuffer->write(dummyPointers.data(), numChannels, 480, 48000.0);
+        // The tap is bound to the device's shared output by rebuildSnapshotLocked() below
+        if (!buffers.outputTap) {
+            buffers.outputTap = std::make_shared<DeviceOutputTap>();
 
             atk::logging::debug(
                 "AudioDeviceHandler::addClientSubscription",
-                "created output SyncBuffer for \"" + deviceName + "\""
+                "created output tap for \"" + deviceName + "\""
             );
         }
     }
@@ -951,15 +1170,16 @@ void AudioDeviceHandler::removeClientSubscription(void* clientId, bool isInput)
         auto it = clientBuffers.find(clientId);
         if (it != clientBuffers.end()) {
             if (isInput) {
-                it->second.inputBuffer.reset();
+                it->second.inputTap.reset();
                 it->second.inputMappings.clear();
+                it->second.inputChannels.clear();
             } else {
-                it->second.outputBuffer.reset();
+                it->second.outputTap.reset();
                 it->second.outputMappings.clear();
             }
 
             // Remove client entry if no buffers left
-            if (!it->second.inputBuffer && !it->second.outputBuffer)
+            if (!it->second.inputTap && !it->second.outputTap)
                 clientBuffers.erase(it);
         }
 
@@ -1003,7 +1223,7 @@ bool AudioDeviceHandler::registerDirectCallback(juce::AudioIODeviceCallback* cal
     }
 
     // Create info with pre-allocated buffers
-    DirectCallbackInfo info;
+    DirectCallbackInfo& info = directCallbacks[callback];
     info.callback = callback;
 
     // Pre-allocate buffers if device is already open
@@ -1015,8 +1235,7 @@ bool AudioDeviceHandler::registerDirectCallback(juce::AudioIODeviceCallback* cal
         );
         int bufferSize = device->getCurrentBufferSizeSamples();
 
-        info.tempOutputBuffer.setSize(maxChannels, bufferSize, false, false, true);
-        info.outputPointers.resize(maxChannels);
+        allocateDirectCallbackBuffers(info, maxChannels, bufferSize);
 
         // If device is already playing, notify the callback immediately
         // This is important for late-registered callbacks that join after device started
@@ -1024,7 +1243,6 @@ bool AudioDeviceHandler::registerDirectCallback(juce::AudioIODeviceCallback* cal
             callback->audioDeviceAboutToStart(device);
     }
 
-    directCallbacks[callback] = std::move(info);
     rebuildDirectCallbackSnapshotLocked();
 
     return true;
@@ -1035,17 +1253,28 @@ void AudioDeviceHandler::unregisterDirectCallback(juce::AudioIODeviceCallback* c
     if (callback == nullptr)
         return;
 
-    std::lock_guard<std::mutex> lock(directCallbackMutex);
+    // Taken out of the map but kept alive until no device callback or worker can still use it
+    decltype(directCallbacks)::node_type removed;
+    {
+        std::lock_guard<std::mutex> lock(directCallbackMutex);
+
+        auto it = directCallbacks.find(callback);
+        if (it == directCallbacks.end())
+            return;
 
-    auto it = directCallbacks.find(callback);
-    if (it != directCallbacks.end()) {
         atk::logging::debug(
             "AudioDeviceHandler::unregisterDirectCallback",
             "removed direct callback for device \"" + deviceName + "\""
         );
-        directCallbacks.erase(it);
+        removed = directCallbacks.extract(it);
         rebuildDirectCallbackSnapshotLocked();
     }
+
+    // Outside directCallbackMutex: JUCE calls audioDeviceAboutToStart, which takes it, while
+    // holding its callback lock. Once a device callback that loaded the old snapshot has
+    // returned, only the job itself can be left.
+    { const juce::ScopedLock callbackLock(deviceManager->getAudioCallbackLock()); }
+    waitForDirectCallbackJob(removed.mapped());
 }
 
 bool AudioDeviceHandler::hasDirectCallback() const
@@ -1067,6 +1296,47 @@ void AudioDeviceHandler::rebuildDirectCallbackSnapshotLocked()
     directCallbackSnapshot.store(newSnapshot, std::memory_order_release);
 }
 
+void AudioDeviceHandler::allocateDirectCallbackBuffers(
+    DirectCallbackInfo& info,
+    int maxChannels,
+    int bufferSize
+)
+{
+    info.tempOutputBuffer.setSize(maxChannels, bufferSize, false, false, true);
+    info.outputPointers.resize(maxChannels);
+    info.tempInputBuffer.setSize(maxChannels, bufferSize, false, false, true);
+    info.inputPointers.resize(maxChannels);
+}
+
+void AudioDeviceHandler::waitForDirectCallbackJob(DirectCallbackInfo& info)
+{
+    // Tasks still queued after the pool shut down never run, and nothing touches them either
+    auto* pool = RealtimeThreadPool::getInstance();
+    for (;;) {
+        const int state = info.jobState.load(std::memory_order_acquire);
+        const bool jobBusy = state == DirectJobQueued || state == DirectJobRunning;
+        const bool tasksPending = info.tasksInFlight.load(std::memory_order_acquire) > 0;
+        if (!jobBusy && !(tasksPending && pool->isReady()))
+            break;
+        std::this_thread::yield();
+    }
+}
+
+void AudioDeviceHandler::setParallelDirectCallbacks(bool enabled)
+{
+    parallelDirectCallbacks.store(enabled, std::memory_order_relaxed);
+}
+
+bool AudioDeviceHandler::isParallelDirectCallbacksEnabled() const
+{
+    return parallelDirectCallbacks.load(std::memory_order_relaxed);
+}
+
+uint64_t AudioDeviceHandler::getNumMissedDirectCallbackBlocks() const
+{
+    return missedDirectCallbackBlocks.load(std::memory_order_relaxed);
+}
+
 int AudioDeviceHandler::getNumChannels() const
 {
     if (auto* device = deviceManager->getCurrentAudioDevice()) {
@@ -1096,20 +1366,70 @@ int AudioDeviceHandler::getBufferSize() const
     return 0;
 }
 
+std::vector<int>
+AudioDeviceHandler::getSubscribedChannels(const std::vector<ChannelMapping>& mappings)
+{
+    // Ascending and unique, so a channel subscribed twice is still read once
+    std::vector<int> channels;
+    channels.reserve(mappings.size());
+    for (const auto& mapping : mappings)
+        if (mapping.deviceChannel.channelIndex >= 0)
+            channels.push_back(mapping.deviceChannel.channelIndex);
+
+    std::sort(channels.begin(), channels.end());
+    channels.erase(std::unique(channels.begin(), channels.end()), channels.end());
+    return channels;
+}
+
+void AudioDeviceHandler::bindTapsLocked()
+{
+    // Must be called while holding clientBuffersMutex
+    std::vector<int> allChannels;
+    for (const auto& [clientId, buffers] : clientBuffers)
+        if (buffers.inputTap)
+            allChannels.insert(
+                allChannels.end(),
+                buffers.inputChannels.begin(),
+                buffers.inputChannels.end()
+            );
+
+    std::sort(allChannels.begin(), allChannels.end());
+    allChannels.erase(std::unique(allChannels.begin(), allChannels.end()), allChannels.end());
+
+    // Only the channels some client listens to are copied; the converter is left alone
+    if (sharedInput)
+        sharedInput->setChannels(std::move(allChannels));
+
+    // And only the output channels up to the highest one some client plays to reach the device;
+    // the converter, sized in audioDeviceAboutToStart, keeps running
+    int numOutputChannels = 0;
+    for (const auto& [clientId, buffers] : clientBuffers)
+        if (buffers.outputTap)
+            for (const auto& mapping : buffers.outputMappings)
+                numOutputChannels =
+                    std::max(numOutputChannels, mapping.deviceChannel.channelIndex + 1);
+    if (sharedOutput)
+        sharedOutput->setNumChannels(numOutputChannels);
+
+    for (auto& [clientId, buffers] : clientBuffers) {
+        if (buffers.inputTap)
+            buffers.inputTap->bind(sharedInput, buffers.inputChannels);
+        if (buffers.outputTap)
+            buffers.outputTap->bind(sharedOutput);
+    }
+}
+
 void AudioDeviceHandler::rebuildSnapshotLocked()
 {
     // Must be called while holding clientBuffersMutex
-    auto newSnapshot = std::make_shared<DeviceSnapshot>();
-    newSnapshot->clients.reserve(clientBuffers.size());
+    bindTapsLocked();
 
+    auto newSnapshot = std::make_shared<DeviceSnapshot>();
     for (const auto& [clientId, buffers] : clientBuffers) {
-        ClientBuffersSnapshot snapshot;
-        snapshot.inputBuffer = buffers.inputBuffer;
-        snapshot.outputBuffer = buffers.outputBuffer;
-        snapshot.inputMappings = buffers.inputMappings;
-        snapshot.outputMappings = buffers.outputMappings;
-
-        newSnapshot->clients.emplace(clientId, std::move(snapshot));
+        if (buffers.inputTap)
+            newSnapshot->hasInputClients = true;
+        if (buffers.outputTap)
+            newSnapshot->hasOutputClients = true;
     }
 
     // Atomic publish - audio callback can now see new snapshot
@@ -1146,6 +1466,8 @@ juce::AudioDeviceManager* AudioServer::ensureDeviceEnumerator() const
             atk::logging::debug("AudioServer::ensureDeviceEnumerator", "creating device enumerator");
             const_cast<AudioServer*>(this)->deviceEnumerator =
                 std::make_unique<juce::AudioDeviceManager>();
+            VirtualAudioDevices::addDeviceTypes(*deviceEnumerator);
+            AggregateAudioDevices::addDeviceTypes(*deviceEnumerator);
         }
     }
     return deviceEnumerator.get();
@@ -1161,8 +1483,51 @@ void AudioServer::setupDeviceEnumeratorListeners()
 
 void AudioServer::changeListenerCallback(juce::ChangeBroadcaster* source)
 {
-    if (source == deviceEnumerator.get())
+    if (source == deviceEnumerator.get()) {
+        // Hotplug: listeners hear about it once the rescan has the new list
+        if (deviceScanner)
+            deviceScanner->requestRescan();
+        else
+            listeners.call([](Listener& l) { l.audioServerDeviceListChanged(); });
+    } else if (source == VirtualAudioDevices::getInstanceWithoutCreating()) {
+        // A virtual device was added, removed or reconfigured; probe them all again
+        if (deviceScanner) {
+            auto* virtualDevices = VirtualAudioDevices::getInstance();
+            for (const char* typeName :
+                 {VirtualAudioDevices::NULL_TYPE_NAME, VirtualAudioDevices::FILE_TYPE_NAME}) {
+                juce::StringArray names = virtualDevices->getDeviceNames(typeName, true);
+                names.mergeArray(virtualDevices->getDeviceNames(typeName, false));
+                for (const auto& name : names)
+                    deviceScanner->forgetDevice(name);
+            }
+            deviceScanner->requestRescan();
+        }
+    } else if (source == AggregateAudioDevices::getInstanceWithoutCreating()) {
+        // Aggregates are probed on demand; an edited one may have other channels now
+        for (const auto& name : AggregateAudioDevices::getInstance()->getDeviceNames())
+            clearCachedDeviceInfo(name);
+        if (deviceScanner)
+            deviceScanner->requestRescan();
+        listeners.call([](Listener& l) { l.audioServerDeviceListChanged(); });
+    } else if (deviceScanner && source == deviceScanner.get()) {
+        const auto snapshot = deviceScanner->getSnapshot();
+        AggregateAudioDevices::getInstance()->setScanSnapshot(snapshot);
+
+        // Cached answers for devices that came, went or changed are out of date
+        for (const auto& deviceName : snapshot->changedDevices) {
+            clearCachedDeviceInfo(deviceName);
+            std::lock_guard<std::mutex> lock(deviceTypeCacheMutex);
+            deviceNameToTypeCache.erase(deviceName);
+        }
         listeners.call([](Listener& l) { l.audioServerDeviceListChanged(); });
+    }
+}
+
+std::shared_ptr<const DeviceScanSnapshot> AudioServer::getScanSnapshot() const
+{
+    if (deviceScanner)
+        return deviceScanner->getSnapshot();
+    return std::make_shared<DeviceScanSnapshot>();
 }
 
 void AudioServer::addListener(Listener* listener)
@@ -1184,6 +1549,14 @@ void AudioServer::initialize()
     ensureDeviceEnumerator();
     setupDeviceEnumeratorListeners();
 
+    deviceScanner = std::make_unique<AudioDeviceScanner>();
+    deviceScanner->addChangeListener(this);
+    deviceScanner->start();
+    AggregateAudioDevices::getInstance()->setScanSnapshot(deviceScanner->getSnapshot());
+    VirtualAudioDevices::getInstance()->addChangeListener(this);
+    AggregateAudioDevices::getInstance()->addChangeListener(this);
+    startTimer(CLEANUP_TIMER_INTERVAL_MS);
+
     initialized.store(true, std::memory_order_release);
 
     atk::logging::info("AudioServer::initialize", "completed");
@@ -1197,11 +1570,28 @@ void AudioServer::shutdown()
     atk::logging::info("AudioServer::shutdown", "begin");
 
     initialized.store(false, std::memory_order_release);
+    stopTimer();
+
+    if (auto* virtualDevices = VirtualAudioDevices::getInstanceWithoutCreating())
+        virtualDevices->removeChangeListener(this);
+    if (auto* aggregateDevices = AggregateAudioDevices::getInstanceWithoutCreating())
+        aggregateDevices->removeChangeListener(this);
+
+    if (deviceScanner) {
+        deviceScanner->removeChangeListener(this);
+        deviceScanner->stop();
+        deviceScanner.reset();
+    }
+
+    // Finishes the device it is opening, then sees initialized is gone
+    if (preopenThread.joinable())
+        preopenThread.join();
 
     // Close all device handlers
     {
         std::lock_guard<std::mutex> lock(devicesMutex);
         pendingDeviceCloses.clear();
+        idleClosesHeld = false;
         deviceHandlers.clear();
     }
 
@@ -1272,6 +1662,13 @@ juce::String AudioServer::findDeviceKeyByName(const juce::String& deviceName) co
             return makeDeviceKey(it->second, deviceName);
     }
 
+    // Then the last scan
+    if (const auto* scanned = getScanSnapshot()->find(deviceName)) {
+        std::lock_guard<std::mutex> lock(deviceTypeCacheMutex);
+        deviceNameToTypeCache[deviceName] = scanned->typeName;
+        return makeDeviceKey(scanned->typeName, deviceName);
+    }
+
     // Not in cache - discover device type from device enumerator (slow path)
     auto* enumerator = ensureDeviceEnumerator();
     if (enumerator) {
@@ -1298,15 +1695,28 @@ juce::String AudioServer::findDeviceKeyByName(const juce::String& deviceName) co
     return deviceName;
 }
 
+void AudioServer::timerCallback()
+{
+    // Never wait here on a device that is being opened; the next tick will do
+    std::unique_lock<std::mutex> lock(devicesMutex, std::try_to_lock);
+    if (lock.owns_lock())
+        processDeviceCleanup();
+}
+
 void AudioServer::processDeviceCleanup()
 {
-    // Called during subscription updates to process deferred device closures
     // Must be called with devicesMutex held
+    if (idleClosesHeld || pendingDeviceCloses.empty())
+        return;
+
     juce::int64 currentTime = juce::Time::currentTimeMillis();
 
     auto it = pendingDeviceCloses.begin();
     while (it != pendingDeviceCloses.end()) {
-        if (currentTime >= it->closeTime) {
+        if (currentTime >= it->closeTime && preopeningDevices.contains(it->deviceKey)) {
+            // Checked again once the preopen has it open
+            ++it;
+        } else if (currentTime >= it->closeTime) {
             // Check if device still has no connections
             auto handlerIt = deviceHandlers.find(it->deviceKey);
             if (handlerIt != deviceHandlers.end()) {
@@ -1352,21 +1762,55 @@ bool AudioServer::cancelPendingDeviceClose(const juce::String& deviceKey)
 void AudioServer::scheduleDeviceClose(const juce::String& deviceKey)
 {
     // Must be called with devicesMutex held
+    const bool alreadyPending = std::any_of(
+        pendingDeviceCloses.begin(),
+        pendingDeviceCloses.end(),
+        [&deviceKey](const PendingDeviceClose& pending) { return pending.deviceKey == deviceKey; }
+    );
+    if (alreadyPending)
+        return;
+
+    int separatorIndex = deviceKey.indexOf("|");
+    juce::String deviceName =
+        (separatorIndex >= 0) ? deviceKey.substring(separatorIndex + 1) : deviceKey;
+    const auto setting = DeviceIdlePolicies::getInstance()->getSetting(deviceName);
+
+    if (setting.policy == DeviceIdlePolicy::KeepWarm) {
+        atk::logging::debug(
+            "AudioServer::scheduleDeviceClose",
+            juce::String::formatted("keeping idle \"%s\" open", deviceKey.toRawUTF8())
+        );
+        return;
+    }
+
+    const int delayMs =
+        setting.policy == DeviceIdlePolicy::CloseImmediately ? 0 : setting.closeDelayMs;
+
     PendingDeviceClose pending;
     pending.deviceKey = deviceKey;
-    pending.closeTime = juce::Time::currentTimeMillis() + DEVICE_CLOSE_DELAY_MS;
+    pending.closeTime = juce::Time::currentTimeMillis() + delayMs;
 
     pendingDeviceCloses.push_back(pending);
     atk::logging::debug(
         "AudioServer::scheduleDeviceClose",
         juce::String::formatted(
-            "scheduled close for \"%s\" in %lld ms",
+            "scheduled close for \"%s\" in %d ms",
             deviceKey.toRawUTF8(),
-            (long long)DEVICE_CLOSE_DELAY_MS
+            delayMs
         )
     );
 }
 
+void AudioServer::rescheduleIdleDeviceCloses()
+{
+    // Must be called with devicesMutex held; the delays count from now
+    pendingDeviceCloses.clear();
+    for (auto& [key, handler] : deviceHandlers)
+        if (!handler->hasActiveSubscriptions() && !handler->hasDirectCallback())
+            scheduleDeviceClose(key);
+    processDeviceCleanup();
+}
+
 void AudioServer::registerClient(void* clientId, const AudioClientState& state, int bufferSize)
 {
     if (!initialized.load(std::memory_order_acquire))
@@ -1412,6 +1856,8 @@ void AudioServer::unregisterClient(void* clientId)
         for (auto& [name, handler] : deviceHandlers)
             if (!handler->hasActiveSubscriptions() && !handler->hasDirectCallback())
                 scheduleDeviceClose(name);
+
+        processDeviceCleanup();
     }
 
     // Remove client info
@@ -1528,10 +1974,11 @@ void AudioServer::updateClientSubscriptions(void* clientId, const AudioClientSta
             if (bufferIt != handler->clientBuffers.end()) {
                 // If no new subscriptions for this device, remove client entry entirely
                 if (newInput.empty() && newOutput.empty()) {
-                    bufferIt->second.inputBuffer.reset();
-                    bufferIt->second.outputBuffer.reset();
+                    bufferIt->second.inputTap.reset();
+                    bufferIt->second.outputTap.reset();
                     bufferIt->second.inputMappings.clear();
                     bufferIt->second.outputMappings.clear();
+                    bufferIt->second.inputChannels.clear();
                     handler->clientBuffers.erase(bufferIt);
                     handler->rebuildSnapshotLocked();
                     continue;
@@ -1541,14 +1988,15 @@ void AudioServer::updateClientSubscriptions(void* clientId, const AudioClientSta
                 // This prevents audio discontinuity when adding/removing channels
                 bufferIt->second.inputMappings.clear();
                 bufferIt->second.outputMappings.clear();
+                bufferIt->second.inputChannels.clear();
 
                 // Only reset buffers if subscription type is being removed entirely
-                if (newInput.empty() && bufferIt->second.inputBuffer) {
-                    bufferIt->second.inputBuffer.reset();
+                if (newInput.empty() && bufferIt->second.inputTap) {
+                    bufferIt->second.inputTap.reset();
                     snapshotDirty = true;
                 }
-                if (newOutput.empty() && bufferIt->second.outputBuffer) {
-                    bufferIt->second.outputBuffer.reset();
+                if (newOutput.empty() && bufferIt->second.outputTap) {
+                    bufferIt->second.outputTap.reset();
                     snapshotDirty = true;
                 }
             } else if (newInput.empty() && newOutput.empty()) {
@@ -1584,23 +2032,12 @@ void AudioServer::updateClientSubscriptions(void* clientId, const AudioClientSta
                     inputMappings.push_back(mapping);
                 }
                 buffers.inputMappings = inputMappings;
+                buffers.inputChannels = AudioDeviceHandler::getSubscribedChannels(inputMappings);
 
-                if (!buffers.inputBuffer) {
-                    buffers.inputBuffer = std::make_shared<SyncBuffer>();
-
-                    int numChannels = 2;
-                    if (auto* device = handler->deviceManager->getCurrentAudioDevice())
-                        numChannels = device->getActiveInputChannels().countNumberOfSetBits();
-
-                    juce::AudioBuffer<float> dummyBuffer(numChannels, 480);
-                    dummyBuffer.clear();
-                    std::vector<float*> dummyPointers(numChannels);
-                    for (int ch = 0; ch < numChannels; ++ch)
-                        dummyPointers[ch] = dummyBuffer.getWritePointer(ch);
-
-                    buffers.inputBuffer
-                        ->read(dummyPointers.data(), numChannels, 480, 48000.0, false);
-                }
+                // Bound by rebuildSnapshotLocked(); keeps its read position when only the
+                // channel set changed
+                if (!buffers.inputTap)
+                    buffers.inputTap = std::make_shared<DeviceInputTap>();
 
                 snapshotDirty = true;
 
@@ -1637,21 +2074,9 @@ void AudioServer::updateClientSubscriptions(void* clientId, const AudioClientSta
                 }
                 buffers.outputMappings = outputMappings;
 
-                if (!buffers.outputBuffer) {
-                    buffers.outputBuffer = std::make_shared<SyncBuffer>();
-
-                    int numChannels = 2;
-                    if (auto* device = handler->deviceManager->getCurrentAudioDevice())
-                        numChannels = device->getActiveOutputChannels().countNumberOfSetBits();
-
-                    juce::AudioBuffer<float> dummyBuffer(numChannels, 480);
-                    dummyBuffer.clear();
-                    std::vector<const float*> dummyPointers(numChannels);
-                    for (int ch = 0; ch < numChannels; ++ch)
-                        dummyPointers[ch] = dummyBuffer.getReadPointer(ch);
-
-                    buffers.outputBuffer->write(dummyPointers.data(), numChannels, 480, 48000.0);
-                }
+                // Bound by rebuildSnapshotLocked()
+                if (!buffers.outputTap)
+                    buffers.outputTap = std::make_shared<DeviceOutputTap>();
 
                 snapshotDirty = true;
 
@@ -1662,16 +2087,14 @@ void AudioServer::updateClientSubscriptions(void* clientId, const AudioClientSta
             if (snapshotDirty)
                 handler->rebuildSnapshotLocked();
         }
-
-        // Close device if no more subscriptions
-        if (!handler->hasActiveSubscriptions() && handler->isDeviceOpen())
-            handler->closeDevice();
     }
 
-    // Step 4: Clean up unused device handlers (schedule for deferred close)
+    // Step 4: Schedule unused device handlers for closing by their idle setting; the device
+    // stays open until then, so a client that comes back does not wait for it to start
     for (auto& [key, handler] : deviceHandlers)
         if (!handler->hasActiveSubscriptions() && !handler->hasDirectCallback())
             scheduleDeviceClose(key);
+    processDeviceCleanup();
 
     // Step 5: Rebuild client's buffer snapshot for lock-free audio access
     rebuildClientBufferSnapshot(clientId);
@@ -1706,8 +2129,8 @@ void AudioServer::rebuildClientBufferSnapshot(void* clientId)
     auto newSnapshot = std::make_shared<AudioClient::BufferSnapshot>();
     newSnapshot->state = currentState;
 
-    // Build input buffer refs and group by SyncBuffer for realtime-safe access
-    std::unordered_map<SyncBuffer*, AudioClient::BufferGroup> inputGroupMap;
+    // Build input buffer refs and group by tap for realtime-safe access
+    std::unordered_map<DeviceInputTap*, AudioClient::BufferGroup> inputGroupMap;
     for (size_t i = 0; i < currentState.inputSubscriptions.size(); ++i) {
         const auto& sub = currentState.inputSubscriptions[i];
         juce::String deviceKey = makeDeviceKey(sub);
@@ -1718,30 +2141,46 @@ void AudioServer::rebuildClientBufferSnapshot(void* clientId)
             std::lock_guard<std::mutex> handlerLock(handler->clientBuffersMutex);
 
             auto clientIt = handler->clientBuffers.find(clientId);
-            if (clientIt != handler->clientBuffers.end() && clientIt->second.inputBuffer) {
+            if (clientIt != handler->clientBuffers.end() && clientIt->second.inputTap) {
                 AudioClient::ChannelBufferRef ref;
                 ref.subscription = sub;
-                ref.buffer = clientIt->second.inputBuffer;
+                ref.inputTap = clientIt->second.inputTap;
                 ref.deviceChannelIndex = sub.channelIndex;
                 newSnapshot->inputBuffers.push_back(std::move(ref));
 
-                // Build group for realtime-safe access
-                auto* syncBuf = clientIt->second.inputBuffer.get();
-                auto& group = inputGroupMap[syncBuf];
-                group.buffer = syncBuf;
-                group.maxDeviceChannel = std::max(group.maxDeviceChannel, sub.channelIndex);
-                group.channelMap.push_back({static_cast<int>(i), sub.channelIndex});
+                // Build group for realtime-safe access; the tap reads only the subscribed
+                // channels, so map each to its position in that list
+                const auto& channels = clientIt->second.inputChannels;
+                auto channelIt =
+                    std::lower_bound(channels.begin(), channels.end(), sub.channelIndex);
+                if (channelIt == channels.end() || *channelIt != sub.channelIndex)
+                    continue;
+
+                auto* tap = clientIt->second.inputTap.get();
+                auto& group = inputGroupMap[tap];
+                group.inputTap = tap;
+                group.numChannels = static_cast<int>(channels.size());
+                group.channelMap.push_back(
+                    {static_cast<int>(i), static_cast<int>(channelIt - channels.begin())}
+                );
             }
         }
     }
 
     // Convert input group map to vector
+    std::vector<bool> readByGroup(currentState.inputSubscriptions.size(), false);
     newSnapshot->inputGroups.reserve(inputGroupMap.size());
-    for (auto& [ptr, group] : inputGroupMap)
+    for (auto& [ptr, group] : inputGroupMap) {
+        for (const auto& [subIdx, bufCh] : group.channelMap)
+            readByGroup[static_cast<size_t>(subIdx)] = true;
         newSnapshot->inputGroups.push_back(std::move(group));
+    }
+    for (size_t i = 0; i < readByGroup.size(); ++i)
+        if (!readByGroup[i])
+            newSnapshot->silentInputs.push_back(static_cast<int>(i));
 
-    // Build output buffer refs and group by SyncBuffer
-    std::unordered_map<SyncBuffer*, AudioClient::BufferGroup> outputGroupMap;
+    // Build output buffer refs and group by tap
+    std::unordered_map<DeviceOutputTap*, AudioClient::BufferGroup> outputGroupMap;
     for (size_t i = 0; i < currentState.outputSubscriptions.size(); ++i) {
         const auto& sub = currentState.outputSubscriptions[i];
         juce::String deviceKey = makeDeviceKey(sub);
@@ -1752,18 +2191,18 @@ void AudioServer::rebuildClientBufferSnapshot(void* clientId)
             std::lock_guard<std::mutex> handlerLock(handler->clientBuffersMutex);
 
             auto clientIt = handler->clientBuffers.find(clientId);
-            if (clientIt != handler->clientBuffers.end() && clientIt->second.outputBuffer) {
+            if (clientIt != handler->clientBuffers.end() && clientIt->second.outputTap) {
                 AudioClient::ChannelBufferRef ref;
                 ref.subscription = sub;
-                ref.buffer = clientIt->second.outputBuffer;
+                ref.outputTap = clientIt->second.outputTap;
                 ref.deviceChannelIndex = sub.channelIndex;
                 newSnapshot->outputBuffers.push_back(std::move(ref));
 
                 // Build group for realtime-safe access
-                auto* syncBuf = clientIt->second.outputBuffer.get();
-                auto& group = outputGroupMap[syncBuf];
-                group.buffer = syncBuf;
-                group.maxDeviceChannel = std::max(group.maxDeviceChannel, sub.channelIndex);
+                auto* tap = clientIt->second.outputTap.get();
+                auto& group = outputGroupMap[tap];
+                group.outputTap = tap;
+                group.numChannels = std::max(group.numChannels, sub.channelIndex + 1);
                 group.channelMap.push_back({static_cast<int>(i), sub.channelIndex});
             }
         }
@@ -1812,6 +2251,9 @@ AudioClientState AudioServer::getClientState(void* clientId) const
 
 juce::StringArray AudioServer::getAvailableInputDevices() const
 {
+    if (auto snapshot = getScanSnapshot(); !snapshot->devices.empty())
+        return snapshot->getDeviceNames(true);
+
     // Lazily initialize device enumerator with thread safety
     auto* enumerator = ensureDeviceEnumerator();
     if (!enumerator)
@@ -1829,6 +2271,9 @@ juce::StringArray AudioServer::getAvailableInputDevices() const
 
 juce::StringArray AudioServer::getAvailableOutputDevices() const
 {
+    if (auto snapshot = getScanSnapshot(); !snapshot->devices.empty())
+        return snapshot->getDeviceNames(false);
+
     // Lazily initialize device enumerator with thread safety
     auto* enumerator = ensureDeviceEnumerator();
     if (!enumerator)
@@ -1844,8 +2289,24 @@ juce::StringArray AudioServer::getAvailableOutputDevices() const
     return devices;
 }
 
+void AudioServer::listCurrentAggregates(std::map<juce::String, juce::StringArray>& devicesByType)
+{
+    // The registry is current the moment an aggregate is saved; the scan catches up later
+    const auto names = AggregateAudioDevices::getInstance()->getDeviceNames();
+    if (names.isEmpty())
+        devicesByType.erase(AggregateAudioDevices::TYPE_NAME);
+    else
+        devicesByType[AggregateAudioDevices::TYPE_NAME] = names;
+}
+
 std::map<juce::String, juce::StringArray> AudioServer::getInputDevicesByType() const
 {
+    if (auto snapshot = getScanSnapshot(); !snapshot->devices.empty()) {
+        auto devicesByType = snapshot->getDevicesByType(true);
+        listCurrentAggregates(devicesByType);
+        return devicesByType;
+    }
+
     // Lazily initialize device enumerator with thread safety
     auto* enumerator = ensureDeviceEnumerator();
     if (!enumerator)
@@ -1866,6 +2327,12 @@ std::map<juce::String, juce::StringArray> AudioServer::getInputDevicesByType() c
 
 std::map<juce::String, juce::StringArray> AudioServer::getOutputDevicesByType() const
 {
+    if (auto snapshot = getScanSnapshot(); !snapshot->devices.empty()) {
+        auto devicesByType = snapshot->getDevicesByType(false);
+        listCurrentAggregates(devicesByType);
+        return devicesByType;
+    }
+
     // Lazily initialize device enumerator with thread safety
     auto* enumerator = ensureDeviceEnumerator();
     if (!enumerator)
@@ -1925,6 +2392,20 @@ int AudioServer::getDeviceNumChannels(const juce::String& deviceName, bool isInp
         }
     }
 
+    // Then what the last scan probed
+    if (const auto* scanned = getScanSnapshot()->find(deviceName); scanned && scanned->probed) {
+        std::lock_guard<std::mutex> lock(deviceChannelCacheMutex);
+        auto* server = const_cast<AudioServer*>(this);
+
+        server->inputDeviceChannelCache[deviceName] = scanned->inputChannelNames.size();
+        server->inputDeviceChannelNamesCache[deviceName] = scanned->inputChannelNames;
+
+        server->outputDeviceChannelCache[deviceName] = scanned->outputChannelNames.size();
+        server->outputDeviceChannelNamesCache[deviceName] = scanned->outputChannelNames;
+
+        return isInput ? scanned->inputChannelNames.size() : scanned->outputChannelNames.size();
+    }
+
     // Lazily initialize device enumerator with thread safety (only for devices that aren't already
     // open)
     auto* enumerator = ensureDeviceEnumerator();
@@ -1935,7 +2416,14 @@ int AudioServer::getDeviceNumChannels(const juce::String& deviceName, bool isInp
     // NOTE: We create the temp device but DON'T open it - just query its capabilities
     int numChannels = 0;
     juce::StringArray channelNames;
+    // The scanner lists aggregates without probing them, so they all end up here; they take their
+    // members from the scan, and rescanning every other driver first would only stall the caller
+    const bool isAggregate =
+        AggregateAudioDevices::getInstance()->getDeviceNames().contains(deviceName);
     for (auto& type : enumerator->getAvailableDeviceTypes()) {
+        if (isAggregate && type->getTypeName() != AggregateAudioDevices::TYPE_NAME)
+            continue;
+
         type->scanForDevices();
 
         // Check BOTH input and output device lists to find the device
@@ -2022,8 +2510,13 @@ juce::Array<double> AudioServer::getAvailableSampleRates(const juce::String& dev
             return it->second;
     }
 
-    // Not in cache - query device capabilities
+    // Not in cache - take it from the last scan or query device capabilities
     juce::Array<double> rates;
+    if (const auto* scanned = getScanSnapshot()->find(deviceName); scanned && scanned->probed) {
+        std::lock_guard<std::mutex> lock(deviceCapabilitiesCacheMutex);
+        deviceSampleRatesCache[deviceName] = scanned->sampleRates;
+        return scanned->sampleRates;
+    }
 
     // Lazily initialize device enumerator with thread safety
     auto* enumerator = ensureDeviceEnumerator();
@@ -2067,8 +2560,13 @@ juce::Array<int> AudioServer::getAvailableBufferSizes(const juce::String& device
             return it->second;
     }
 
-    // Not in cache - query device capabilities
+    // Not in cache - take it from the last scan or query device capabilities
     juce::Array<int> sizes;
+    if (const auto* scanned = getScanSnapshot()->find(deviceName); scanned && scanned->probed) {
+        std::lock_guard<std::mutex> lock(deviceCapabilitiesCacheMutex);
+        deviceBufferSizesCache[deviceName] = scanned->bufferSizes;
+        return scanned->bufferSizes;
+    }
 
     // Lazily initialize device enumerator with thread safety
     auto* enumerator = ensureDeviceEnumerator();
@@ -2138,6 +2636,15 @@ void AudioServer::invalidateDeviceCache(const juce::String& deviceName)
         "AudioServer::invalidateDeviceCache",
         "invalidating cache for \"" + deviceName + "\""
     );
+    clearCachedDeviceInfo(deviceName);
+
+    // So that the scan doesn't hand back what it probed before
+    if (deviceScanner)
+        deviceScanner->forgetDevice(deviceName);
+}
+
+void AudioServer::clearCachedDeviceInfo(const juce::String& deviceName)
+{
     // Clear channel counts and names
     {
         std::lock_guard<std::mutex> lock(deviceChannelCacheMutex);
@@ -2201,6 +2708,7 @@ AudioDeviceHandler* AudioServer::getOrCreateDeviceHandler(const juce::String& de
 
     // Create new handler (does NOT open the device yet - will open on first subscription)
     auto handler = std::make_unique<AudioDeviceHandler>(actualDeviceName);
+    handler->setParallelDirectCallbacks(parallelDirectCallbacks.load(std::memory_order_relaxed));
     auto* ptr = handler.get();
     deviceHandlers[deviceKey] = std::move(handler);
 
@@ -2210,7 +2718,10 @@ AudioDeviceHandler* AudioServer::getOrCreateDeviceHandler(const juce::String& de
 void AudioServer::removeDeviceHandlerIfUnused(const juce::String& deviceKey)
 {
     auto it = deviceHandlers.find(deviceKey);
-    if (it != deviceHandlers.end() && !it->second->hasActiveSubscriptions()) {
+    if (it != deviceHandlers.end()
+        && !it->second->hasActiveSubscriptions()
+        && !it->second->hasDirectCallback()
+        && !preopeningDevices.contains(deviceKey)) {
         atk::logging::debug(
             "AudioServer::removeDeviceHandlerIfUnused",
             juce::String::formatted("removing unused handler \"%s\"", deviceKey.toRawUTF8())
@@ -2253,19 +2764,9 @@ bool AudioServer::registerDirectCallback(
         return false;
     }
 
-    // Check if there was a pending close - this indicates device went away and came back
-    // In that case, we need to force a full reopen to get a fresh connection
+    // A device that was idle is reused while still open; the checks below reopen it if it went
+    // away in the meantime
     bool hadPendingClose = cancelPendingDeviceClose(deviceKey);
-    if (hadPendingClose) {
-        atk::logging::debug(
-            "AudioServer::registerDirectCallback",
-            juce::String::formatted(
-                "reopening handler after pending close \"%s\"",
-                deviceKey.toRawUTF8()
-            )
-        );
-        handler->closeDevice();
-    }
 
     // Try to register the direct callback
     if (!handler->registerDirectCallback(callback))
@@ -2291,7 +2792,7 @@ bool AudioServer::registerDirectCallback(
             );
             needsReopen = true;
         } else if (hadPendingClose && !device->isPlaying()) {
-            // Only check isPlaying after actual hotplug (hadPendingClose)
+            // Only check isPlaying for a device that was idle (it may have been unplugged)
             // During normal config changes, not playing is expected
             atk::logging::debug(
                 "AudioServer::registerDirectCallback",
@@ -2349,8 +2850,10 @@ void AudioServer::unregisterDirectCallback(
         it->second->unregisterDirectCallback(callback);
 
         // Schedule deferred close if no longer needed
-        if (!it->second->hasDirectCallback() && !it->second->hasActiveSubscriptions())
+        if (!it->second->hasDirectCallback() && !it->second->hasActiveSubscriptions()) {
             scheduleDeviceClose(deviceKey);
+            processDeviceCleanup();
+        }
     }
 }
 
@@ -2366,6 +2869,28 @@ bool AudioServer::hasDirectCallback(const juce::String& deviceName) const
     return false;
 }
 
+void AudioServer::setParallelDirectCallbacks(bool enabled)
+{
+    if (enabled)
+        if (auto* pool = RealtimeThreadPool::getInstance(); pool && !pool->isReady())
+            pool->initialize();
+
+    std::lock_guard<std::mutex> lock(devicesMutex);
+    parallelDirectCallbacks.store(enabled, std::memory_order_relaxed);
+    for (auto& [key, handler] : deviceHandlers)
+        handler->setParallelDirectCallbacks(enabled);
+
+    atk::logging::info(
+        "AudioServer::setParallelDirectCallbacks",
+        enabled ? "direct callbacks run in parallel" : "direct callbacks run serially"
+    );
+}
+
+bool AudioServer::isParallelDirectCallbacksEnabled() const
+{
+    return parallelDirectCallbacks.load(std::memory_order_relaxed);
+}
+
 bool AudioServer::setDeviceSampleRate(const juce::String& deviceName, double newSampleRate)
 {
     std::lock_guard<std::mutex> lock(devicesMutex);
@@ -2552,4 +3077,156 @@ AudioDeviceHandler* AudioServer::getDeviceHandler(const juce::String& deviceName
     return nullptr;
 }
 
+DeviceIdleSetting AudioServer::getDeviceIdleSetting(const juce::String& deviceName) const
+{
+    return DeviceIdlePolicies::getInstance()->getSetting(deviceName);
+}
+
+void AudioServer::setDeviceIdleSetting(
+    const juce::String& deviceName,
+    const DeviceIdleSetting& setting
+)
+{
+    DeviceIdlePolicies::getInstance()->setSetting(deviceName, setting);
+
+    std::lock_guard<std::mutex> lock(devicesMutex);
+    rescheduleIdleDeviceCloses();
+}
+
+void AudioServer::clearDeviceIdleSetting(const juce::String& deviceName)
+{
+    DeviceIdlePolicies::getInstance()->clearSetting(deviceName);
+
+    std::lock_guard<std::mutex> lock(devicesMutex);
+    rescheduleIdleDeviceCloses();
+}
+
+void AudioServer::setDefaultDeviceIdleSetting(const DeviceIdleSetting& setting)
+{
+    DeviceIdlePolicies::getInstance()->setDefaultSetting(setting);
+
+    std::lock_guard<std::mutex> lock(devicesMutex);
+    rescheduleIdleDeviceCloses();
+}
+
+void AudioServer::beginSceneCollectionSwitch(const juce::String& outgoingCollection)
+{
+    if (!initialized.load(std::memory_order_acquire))
+        return;
+
+    std::lock_guard<std::mutex> lock(devicesMutex);
+
+    // Clients and direct callbacks (PluginHost2 devices) alike, with the rate and block size the
+    // device runs at: a direct callback that asks for them would reopen a device opened otherwise
+    std::vector<CollectionDevice> usedDevices;
+    for (const auto& [key, handler] : deviceHandlers) {
+        if (!handler->hasActiveSubscriptions() && !handler->hasDirectCallback())
+            continue;
+
+        CollectionDevice used;
+        used.deviceKey = key;
+        if (auto* device = handler->deviceManager->getCurrentAudioDevice()) {
+            used.sampleRate = device->getCurrentSampleRate();
+            used.bufferSize = device->getCurrentBufferSizeSamples();
+        }
+        usedDevices.push_back(used);
+    }
+    std::sort(
+        usedDevices.begin(),
+        usedDevices.end(),
+        [](const CollectionDevice& a, const CollectionDevice& b) {
+            return a.deviceKey < b.deviceKey;
+        }
+    );
+    DeviceIdlePolicies::getInstance()->setCollectionDevices(outgoingCollection, usedDevices);
+
+    idleClosesHeld = true;
+    atk::logging::debug(
+        "AudioServer::beginSceneCollectionSwitch",
+        juce::String::formatted(
+            "holding devices; \"%s\" uses %d",
+            outgoingCollection.toRawUTF8(),
+            static_cast<int>(usedDevices.size())
+        )
+    );
+}
+
+void AudioServer::preopenSceneCollectionDevices(const juce::String& incomingCollection)
+{
+    if (!initialized.load(std::memory_order_acquire))
+        return;
+
+    auto devices = DeviceIdlePolicies::getInstance()->getCollectionDevices(incomingCollection);
+    if (devices.empty())
+        return;
+
+    // A switch straight after another; the earlier preopen has little left to do
+    if (preopenThread.joinable())
+        preopenThread.join();
+
+    // Opening takes up to seconds per device, which neither the frontend nor the other users of
+    // devicesMutex should wait for; the incoming collection's sources find the devices open, or
+    // wait in openDevice() for the one being opened
+    preopenThread = std::thread([this, incomingCollection, devices = std::move(devices)] {
+        for (const auto& used : devices) {
+            if (!initialized.load(std::memory_order_acquire))
+                break;
+
+            const auto& deviceKey = used.deviceKey;
+            AudioDeviceHandler* handler = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(devicesMutex);
+                handler = getOrCreateDeviceHandler(deviceKey);
+                if (handler == nullptr)
+                    continue;
+                preopeningDevices.insert(deviceKey);
+            }
+
+            bool opened = true;
+            if (!handler->isDeviceOpen()) {
+                // As the collection last ran it, so that its direct callbacks find the device as
+                // they want it; a first subscription takes whatever is open
+                juce::AudioDeviceManager::AudioDeviceSetup setup;
+                setup.sampleRate = used.sampleRate;
+                setup.bufferSize = used.bufferSize;
+
+                opened = handler->openDevice(setup);
+                if (opened) {
+                    atk::logging::debug(
+                        "AudioServer::preopenSceneCollectionDevices",
+                        juce::String::formatted(
+                            "opened \"%s\" for \"%s\"",
+                            deviceKey.toRawUTF8(),
+                            incomingCollection.toRawUTF8()
+                        )
+                    );
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(devicesMutex);
+            preopeningDevices.erase(deviceKey);
+            if (!opened)
+                removeDeviceHandlerIfUnused(deviceKey);
+            // Closes by its idle setting if the collection no longer uses it
+            else if (!handler->hasActiveSubscriptions() && !handler->hasDirectCallback())
+                scheduleDeviceClose(deviceKey);
+        }
+
+        std::lock_guard<std::mutex> lock(devicesMutex);
+        processDeviceCleanup();
+    });
+}
+
+void AudioServer::endSceneCollectionSwitch()
+{
+    std::lock_guard<std::mutex> lock(devicesMutex);
+
+    if (!idleClosesHeld)
+        return;
+
+    idleClosesHeld = false;
+    rescheduleIdleDeviceCloses();
+    atk::logging::debug("AudioServer::endSceneCollectionSwitch", "released devices");
+}
+
 } // namespace atk
@@ -1,11 +1,16 @@
 #pragma once
 
+#include "AudioDeviceScanner.h"
+#include "DeviceIdlePolicies.h"
+#include "SharedDeviceStreams.h"
+
 #include <atkaudio/AtomicSharedPtr.h>
 #include <atkaudio/FifoBuffer2.h>
 #include <juce_audio_devices/juce_audio_devices.h>
 #include <juce_audio_utils/juce_audio_utils.h>
 #include <memory>
 #include <set>
+#include <thread>
 #include <unordered_map>
 
 namespace atk
@@ -144,6 +149,15 @@ public:
     AudioClient(AudioClient&&) noexcept;
     AudioClient& operator=(AudioClient&&) noexcept;
 
+    // Channel i is input subscription i. Each device's input is read straight into the caller's
+    // channels; only a device channel subscribed more than once is copied. Channels without a
+    // subscription or a device are silent, and everything is silent if there are fewer channels
+    // than subscriptions.
+    void pullSubscribedInputs(float* const* dest, int numChannels, int numSamples, double sampleRate);
+    // Channel i is output subscription i. The caller's channels are handed to each device's mix as
+    // they are, without a copy; with a device channel subscribed more than once, the last wins.
+    void pushSubscribedOutputs(const float* const* src, int numChannels, int numSamples, double sampleRate);
+
     void pullSubscribedInputs(juce::AudioBuffer<float>& deviceBuffer, int numSamples, double sampleRate);
     void pushSubscribedOutputs(const juce::AudioBuffer<float>& deviceBuffer, int numSamples, double sampleRate);
     void clearBuffers();
@@ -158,23 +172,40 @@ public:
     int getNumInputSubscriptions() const;
     int getNumOutputSubscriptions() const;
 
+    struct SubscriptionStats
+    {
+        ChannelSubscription subscription;
+        SyncBufferStats stats;
+    };
+
+    // One entry per subscribed channel, inputs first. All channels of a device in one direction
+    // share the device's converter SyncBuffer and so report the same stats. Lock-free; safe from
+    // the UI thread.
+    std::vector<SubscriptionStats> getSubscriptionStats() const;
+
 private:
     friend class AudioServer;
 
     void* clientId;
     int clientBufferSize;
 
+    // Inputs have an input tap, outputs an output tap
     struct ChannelBufferRef
     {
         ChannelSubscription subscription;
-        std::shared_ptr<SyncBuffer> buffer;
+        std::shared_ptr<DeviceInputTap> inputTap;
+        std::shared_ptr<DeviceOutputTap> outputTap;
         int deviceChannelIndex = 0;
     };
 
+    // channelMap pairs are (subscription index, tap channel). An input tap carries only the
+    // subscribed device channels, in ascending order; an output tap carries device channels
+    // 0..numChannels-1.
     struct BufferGroup
     {
-        SyncBuffer* buffer = nullptr;
-        int maxDeviceChannel = 0;
+        DeviceInputTap* inputTap = nullptr;
+        DeviceOutputTap* outputTap = nullptr;
+        int numChannels = 0;
         std::vector<std::pair<int, int>> channelMap;
     };
 
@@ -184,12 +215,13 @@ private:
         std::vector<ChannelBufferRef> outputBuffers;
         std::vector<BufferGroup> inputGroups;
         std::vector<BufferGroup> outputGroups;
+        std::vector<int> silentInputs; // input subscriptions no group reads
         AudioClientState state;
     };
 
     AtomicSharedPtr<BufferSnapshot> bufferSnapshot{std::make_shared<BufferSnapshot>()};
+    // Scratch for tap channels no subscription reads, and the per-group pointer lists
     juce::AudioBuffer<float> tempInputBuffer;
-    juce::AudioBuffer<float> tempOutputBuffer;
     std::vector<float*> tempInputPointers;
     std::vector<const float*> tempOutputPointers;
 
@@ -231,6 +263,15 @@ public:
     void unregisterDirectCallback(juce::AudioIODeviceCallback* callback);
     bool hasDirectCallback() const;
 
+    // With several direct callbacks, runs all but the first on RealtimeThreadPool workers while the
+    // device thread runs the first. Outputs are summed in the same order as when run serially; a
+    // callback still busy DIRECT_CALLBACK_WAIT_FRACTION into the block is left out of this block's
+    // sum and skipped until it finishes. Falls back to serial while the pool isn't ready.
+    void setParallelDirectCallbacks(bool enabled);
+    bool isParallelDirectCallbacksEnabled() const;
+    // Blocks a parallel direct callback missed its deadline or was skipped for being late
+    uint64_t getNumMissedDirectCallbackBlocks() const;
+
     juce::String getDeviceName() const
     {
         return deviceName;
@@ -243,30 +284,47 @@ public:
 private:
     struct ClientBuffers
     {
-        std::shared_ptr<SyncBuffer> inputBuffer;
-        std::shared_ptr<SyncBuffer> outputBuffer;
+        std::shared_ptr<DeviceInputTap> inputTap; // reads inputChannels from sharedInput
+        std::shared_ptr<DeviceOutputTap> outputTap; // adds into sharedOutput
         std::vector<ChannelMapping> inputMappings;
         std::vector<ChannelMapping> outputMappings;
+        std::vector<int> inputChannels;
     };
 
-    struct ClientBuffersSnapshot
+    struct DeviceSnapshot
     {
-        std::shared_ptr<SyncBuffer> inputBuffer;
-        std::shared_ptr<SyncBuffer> outputBuffer;
-        std::vector<ChannelMapping> inputMappings;
-        std::vector<ChannelMapping> outputMappings;
+        bool hasInputClients = false;
+        bool hasOutputClients = false;
     };
 
-    struct DeviceSnapshot
+    // Parallel mode job states: Idle -> Queued -> Running -> Done -> Idle. Only the device thread
+    // queues a job or takes Done back to Idle; whoever moves it from Queued to Running runs it.
+    enum DirectJobState
     {
-        std::unordered_map<void*, ClientBuffersSnapshot> clients;
+        DirectJobIdle,
+        DirectJobQueued,
+        DirectJobRunning,
+        DirectJobDone
     };
 
     struct DirectCallbackInfo
     {
-        juce::AudioIODeviceCallback* callback;
+        juce::AudioIODeviceCallback* callback = nullptr;
         juce::AudioBuffer<float> tempOutputBuffer;
         std::vector<float*> outputPointers;
+
+        // Parallel mode. A worker runs the block from this copy of the device input, since a late
+        // worker may still be reading it after the device callback has returned.
+        juce::AudioBuffer<float> tempInputBuffer;
+        std::vector<const float*> inputPointers;
+        int numInputChannels = 0;
+        int numOutputChannels = 0;
+        int numSamples = 0;
+        uint64_t hostTimeNs = 0;
+        bool hasHostTime = false;
+        bool dispatched = false; // device thread only: queued in the current callback
+        std::atomic<int> jobState{DirectJobIdle};
+        std::atomic<int> tasksInFlight{0}; // pool tasks that may still dereference this
     };
 
     struct DirectCallbackSnapshot
@@ -276,29 +334,73 @@ private:
 
     juce::String deviceName;
     std::unique_ptr<juce::AudioDeviceManager> deviceManager;
+    // Serializes openDevice() and closeDevice(); the scene collection preopen opens outside
+    // AudioServer::devicesMutex
+    std::mutex deviceOpenMutex;
 
     std::unordered_map<void*, ClientBuffers> clientBuffers;
     mutable std::mutex clientBuffersMutex;
+
+    // Device input, written once per callback and converted to the client rate once for all
+    // clients, and the clients' output mix, resampled once and read once per callback. Clients
+    // reach them through their taps. Replaced only in audioDeviceAboutToStart, while no callback
+    // runs.
+    std::shared_ptr<SharedDeviceInput> sharedInput;
+    std::shared_ptr<SharedDeviceOutput> sharedOutput;
     AtomicSharedPtr<DeviceSnapshot> activeSnapshot{std::make_shared<DeviceSnapshot>()};
 
     std::unordered_map<juce::AudioIODeviceCallback*, DirectCallbackInfo> directCallbacks;
     mutable std::mutex directCallbackMutex;
     AtomicSharedPtr<DirectCallbackSnapshot> directCallbackSnapshot{std::make_shared<DirectCallbackSnapshot>()};
 
-    juce::AudioBuffer<float> rtSubscriptionTempBuffer;
-    std::vector<float*> rtSubscriptionPointers;
-    std::vector<const float*> rtInputPointers;
-
+    static std::vector<int> getSubscribedChannels(const std::vector<ChannelMapping>& mappings);
+    // Binds the client taps and publishes the channels the callback copies. Holding
+    // clientBuffersMutex; called by rebuildSnapshotLocked().
+    void bindTapsLocked();
     void rebuildSnapshotLocked();
     std::shared_ptr<DeviceSnapshot> getSnapshot() const;
     void rebuildDirectCallbackSnapshotLocked();
+    void allocateDirectCallbackBuffers(DirectCallbackInfo& info, int maxChannels, int bufferSize);
+    // Returns once no worker is running or about to run the job. Only when no device callback
+    // can queue it again.
+    static void waitForDirectCallbackJob(DirectCallbackInfo& info);
+
+    static void runDirectCallback(
+        DirectCallbackInfo& info,
+        const float* const* inputChannelData,
+        int numInputChannels,
+        int numOutputChannels,
+        int numSamples,
+        const juce::AudioIODeviceCallbackContext& context
+    );
+    static void runDirectCallbackJob(DirectCallbackInfo& info);
+    static void executeDirectCallbackTask(void* userData);
+    void processDirectCallbacksParallel(
+        const DirectCallbackSnapshot& snapshot,
+        const float* const* inputChannelData,
+        int numInputChannels,
+        float* const* outputChannelData,
+        int numOutputChannels,
+        int numSamples,
+        const juce::AudioIODeviceCallbackContext& context,
+        int64_t callbackStartNs
+    );
+
+    // Share of the block period the device thread waits for parallel direct callbacks, leaving
+    // the rest for the sum and the driver
+    static constexpr double DIRECT_CALLBACK_WAIT_FRACTION = 0.8;
+
+    std::atomic<bool> parallelDirectCallbacks{false};
+    std::atomic<uint64_t> missedDirectCallbackBlocks{0};
 
     std::atomic<bool> isRunning{false};
+    std::atomic<double> currentSampleRate{0.0}; // cached for the callback in audioDeviceAboutToStart
 };
 
 class AudioServer
     : public juce::DeletedAtShutdown
     , private juce::ChangeListener
+    , private juce::Timer
 {
 public:
     JUCE_DECLARE_SINGLETON(AudioServer, false)
@@ -323,6 +425,8 @@ public:
     void updateClientSubscriptions(void* clientId, const AudioClientState& state);
     AudioClientState getClientState(void* clientId) const;
 
+    // Device lists and capabilities come from the last background scan (or its disk cache) when it
+    // knows the device, and are only queried synchronously when it doesn't
     juce::StringArray getAvailableInputDevices() const;
     juce::StringArray getAvailableOutputDevices() const;
     // Does not call scanForDevices(); safe to call on the OBS main thread.
@@ -359,20 +463,49 @@ public:
     void unregisterDirectCallback(const juce::String& deviceName, juce::AudioIODeviceCallback* callback);
     bool hasDirectCallback(const juce::String& deviceName) const;
 
+    // Applies to every open device and to devices opened later; see
+    // AudioDeviceHandler::setParallelDirectCallbacks(). Enabling starts the RealtimeThreadPool.
+    void setParallelDirectCallbacks(bool enabled);
+    bool isParallelDirectCallbacksEnabled() const;
+
     AudioDeviceHandler* getDeviceHandler(const juce::String& deviceName) const;
 
+    // What happens to a device once nothing uses it; see DeviceIdlePolicies. Saved, and applied to
+    // devices that are idle already as well as to later ones.
+    DeviceIdleSetting getDeviceIdleSetting(const juce::String& deviceName) const;
+    void setDeviceIdleSetting(const juce::String& deviceName, const DeviceIdleSetting& setting);
+    void clearDeviceIdleSetting(const juce::String& deviceName);
+    void setDefaultDeviceIdleSetting(const DeviceIdleSetting& setting);
+
+    // OBS destroys the outgoing scene collection's sources before it creates the incoming one's,
+    // which would close every device the two share and start it again. Begin records the devices
+    // the outgoing collection uses and holds every idle close; preopen starts opening the devices
+    // the incoming collection used last time on a thread of its own and returns; end releases the
+    // hold, after which the devices nothing uses close by their idle setting, counted from then.
+    // Preopen and shutdown() are called from the same thread.
+    void beginSceneCollectionSwitch(const juce::String& outgoingCollection);
+    void preopenSceneCollectionDevices(const juce::String& incomingCollection);
+    void endSceneCollectionSwitch();
+
 private:
     AudioServer();
 
     void changeListenerCallback(juce::ChangeBroadcaster* source) override;
+    // Closes idle devices whose delay has run out
+    void timerCallback() override;
     void setupDeviceEnumeratorListeners();
 
+    // Must be called with devicesMutex held. scheduleDeviceClose() only records the close, by the
+    // device's idle setting; processDeviceCleanup() removes the handlers that are due.
     void processDeviceCleanup();
     void scheduleDeviceClose(const juce::String& deviceKey);
     bool cancelPendingDeviceClose(const juce::String& deviceKey);
+    void rescheduleIdleDeviceCloses();
     static juce::String makeDeviceKey(const juce::String& deviceType, const juce::String& deviceName);
     static juce::String makeDeviceKey(const ChannelSubscription& sub);
     juce::String findDeviceKeyByName(const juce::String& deviceName) const;
+    // Replaces the scan's aggregate list with the registry's
+    static void listCurrentAggregates(std::map<juce::String, juce::StringArray>& devicesByType);
     void rebuildClientBufferSnapshot(void* clientId);
     AudioDeviceHandler* getOrCreateDeviceHandler(const juce::String& deviceKey);
     void removeDeviceHandlerIfUnused(const juce::String& deviceKey);
@@ -425,11 +558,21 @@ private:
     mutable std::mutex devicesMutex;
     std::unordered_map<juce::String, std::unique_ptr<AudioDeviceHandler>> deviceHandlers;
     std::vector<PendingDeviceClose> pendingDeviceCloses;
-    static constexpr juce::int64 DEVICE_CLOSE_DELAY_MS = 5000;
+    bool idleClosesHeld = false; // during a scene collection switch
+    // Handlers preopenThread is opening without devicesMutex; never removed meanwhile
+    std::set<juce::String> preopeningDevices;
+    std::thread preopenThread;
+    static constexpr int CLEANUP_TIMER_INTERVAL_MS = 250;
 
     mutable std::mutex deviceEnumeratorMutex;
     mutable std::unique_ptr<juce::AudioDeviceManager> deviceEnumerator;
 
+    // Created in initialize(); the enumerator's hotplug notifications trigger its rescans
+    std::unique_ptr<AudioDeviceScanner> deviceScanner;
+    std::shared_ptr<const DeviceScanSnapshot> getScanSnapshot() const;
+    // Channel and capability caches only; invalidateDeviceCache() also has the scanner re-probe
+    void clearCachedDeviceInfo(const juce::String& deviceName);
+
     mutable std::mutex deviceChannelCacheMutex;
     mutable std::unordered_map<juce::String, int> inputDeviceChannelCache;
     mutable std::unordered_map<juce::String, int> outputDeviceChannelCache;
@@ -445,6 +588,7 @@ private:
 
     juce::ListenerList<Listener> listeners;
 
+    std::atomic<bool> parallelDirectCallbacks{false};
     std::atomic<bool> initialized{false};
 };
 
@@ -645,6 +645,12 @@ AudioServerSettingsComponent::AudioServerSettingsComponent(AudioClient* audioCli
     deviceButton.addListener(this);
     addAndMakeVisible(deviceButton);
 
+    aggregateButton.addListener(this);
+    addAndMakeVisible(aggregateButton);
+
+    virtualButton.addListener(this);
+    addAndMakeVisible(virtualButton);
+
     // Build device trees immediately
     // Note: Device enumeration can be slow with some audio drivers, but deferring
     // causes timing issues with state restoration. Build synchronously.
@@ -670,6 +676,10 @@ AudioServerSettingsComponent::~AudioServerSettingsComponent()
     // Close device settings dialog if open
     if (deviceSettingsDialog != nullptr)
         deviceSettingsDialog->exitModalState(0);
+    if (aggregateEditorDialog != nullptr)
+        aggregateEditorDialog->exitModalState(0);
+    if (virtualEditorDialog != nullptr)
+        virtualEditorDialog->exitModalState(0);
 
     applyButton.removeListener(this);
     restoreButton.removeListener(this);
@@ -688,7 +698,7 @@ void AudioServerSettingsComponent::resized()
 {
     auto bounds = getLocalBounds().reduced(10);
 
-    // Bottom buttons (right to left: Reset, Restore, Apply, Device...)
+    // Bottom buttons (right to left: Reset, Restore, Apply, Device..., Aggregate..., Virtual...)
     auto buttonArea = bounds.removeFromBottom(30);
     buttonArea.removeFromTop(5); // Gap
     applyButton.setBounds(buttonArea.removeFromRight(80));
@@ -698,6 +708,10 @@ void AudioServerSettingsComponent::resized()
     cancelButton.setBounds(buttonArea.removeFromRight(80));
     buttonArea.removeFromRight(5); // Gap
     deviceButton.setBounds(buttonArea.removeFromRight(80));
+    buttonArea.removeFromRight(5); // Gap
+    aggregateButton.setBounds(buttonArea.removeFromRight(90));
+    buttonArea.removeFromRight(5); // Gap
+    virtualButton.setBounds(buttonArea.removeFromRight(80));
 
     bounds.removeFromBottom(10); // Gap
 
@@ -1233,6 +1247,14 @@ void AudioServerSettingsComponent::buttonClicked(juce::Button* button)
     {
         showDeviceSettings();
     }
+    else if (button == &aggregateButton)
+    {
+        showAggregateEditor();
+    }
+    else if (button == &virtualButton)
+    {
+        showVirtualEditor();
+    }
 }
 
 void AudioServerSettingsComponent::showDeviceSettings()
@@ -1278,6 +1300,516 @@ void AudioServerSettingsComponent::showDeviceSettings()
     deviceSettingsDialog = o.launchAsync();
 }
 
+AudioServerSettingsComponent::AggregateDeviceEditor::AggregateDeviceEditor(AudioServer* server)
+{
+    // Every input or output device except the aggregates themselves, input and output listed once
+    if (server)
+    {
+        for (const auto& devicesByType : {server->getInputDevicesByType(), server->getOutputDevicesByType()})
+        {
+            for (const auto& [typeName, deviceNames] : devicesByType)
+            {
+                if (typeName == AggregateAudioDevices::TYPE_NAME)
+                    continue;
+
+                for (const auto& deviceName : deviceNames)
+                {
+                    const AggregateMember candidate{typeName, deviceName};
+                    if (std::find(candidates.begin(), candidates.end(), candidate) == candidates.end())
+                        candidates.push_back(candidate);
+                }
+            }
+        }
+    }
+
+    aggregateBox.addListener(this);
+    addAndMakeVisible(aggregateBox);
+
+    nameLabel.setText("Name", juce::dontSendNotification);
+    addAndMakeVisible(nameLabel);
+    addAndMakeVisible(nameEditor);
+
+    masterLabel.setText("Clock master", juce::dontSendNotification);
+    addAndMakeVisible(masterLabel);
+    for (size_t i = 0; i < candidates.size(); ++i)
+        masterBox.addItem(candidates[i].typeName + ": " + candidates[i].deviceName, static_cast<int>(i) + 1);
+    addAndMakeVisible(masterBox);
+
+    membersLabel.setText("Members", juce::dontSendNotification);
+    addAndMakeVisible(membersLabel);
+    for (const auto& candidate : candidates)
+        membersContent.addAndMakeVisible(memberToggles.add(
+            new juce::ToggleButton(candidate.typeName + ": " + candidate.deviceName)
+        ));
+    membersViewport.setViewedComponent(&membersContent, false);
+    membersViewport.setScrollBarsShown(true, false);
+    addAndMakeVisible(membersViewport);
+
+    saveButton.addListener(this);
+    addAndMakeVisible(saveButton);
+    removeButton.addListener(this);
+    addAndMakeVisible(removeButton);
+
+    refreshAggregateList({});
+}
+
+AudioServerSettingsComponent::AggregateDeviceEditor::~AggregateDeviceEditor()
+{
+    aggregateBox.removeListener(this);
+    saveButton.removeListener(this);
+    removeButton.removeListener(this);
+}
+
+void AudioServerSettingsComponent::AggregateDeviceEditor::resized()
+{
+    auto bounds = getLocalBounds().reduced(10);
+
+    aggregateBox.setBounds(bounds.removeFromTop(26));
+    bounds.removeFromTop(8); // Gap
+
+    auto nameRow = bounds.removeFromTop(26);
+    nameLabel.setBounds(nameRow.removeFromLeft(100));
+    nameEditor.setBounds(nameRow);
+    bounds.removeFromTop(5); // Gap
+
+    auto masterRow = bounds.removeFromTop(26);
+    masterLabel.setBounds(masterRow.removeFromLeft(100));
+    masterBox.setBounds(masterRow);
+    bounds.removeFromTop(5); // Gap
+
+    auto buttonArea = bounds.removeFromBottom(30);
+    buttonArea.removeFromTop(5); // Gap
+    saveButton.setBounds(buttonArea.removeFromRight(80));
+    buttonArea.removeFromRight(5); // Gap
+    removeButton.setBounds(buttonArea.removeFromRight(80));
+
+    membersLabel.setBounds(bounds.removeFromTop(24));
+    membersViewport.setBounds(bounds);
+
+    const int rowHeight = 24;
+    const int contentWidth = membersViewport.getMaximumVisibleWidth();
+    membersContent.setSize(contentWidth, rowHeight * memberToggles.size());
+    for (int i = 0; i < memberToggles.size(); ++i)
+        memberToggles[i]->setBounds(0, i * rowHeight, contentWidth, rowHeight);
+}
+
+void AudioServerSettingsComponent::AggregateDeviceEditor::refreshAggregateList(const juce::String& selectedName)
+{
+    const auto names = AggregateAudioDevices::getInstance()->getDeviceNames();
+
+    aggregateBox.clear(juce::dontSendNotification);
+    aggregateBox.addItem("New aggregate", 1);
+    for (int i = 0; i < names.size(); ++i)
+        aggregateBox.addItem(names[i], i + 2);
+
+    const int selectedIndex = names.indexOf(selectedName);
+    aggregateBox.setSelectedId(selectedIndex >= 0 ? selectedIndex + 2 : 1, juce::dontSendNotification);
+    showAggregate(selectedIndex >= 0 ? selectedName : juce::String());
+}
+
+void AudioServerSettingsComponent::AggregateDeviceEditor::showAggregate(const juce::String& name)
+{
+    const auto members = name.isNotEmpty() ? AggregateAudioDevices::getInstance()->getMembers(name)
+                                           : std::vector<AggregateMember>();
+
+    nameEditor.setText(name, juce::dontSendNotification);
+    removeButton.setEnabled(name.isNotEmpty());
+
+    masterBox.setSelectedId(0, juce::dontSendNotification);
+    for (size_t i = 0; i < candidates.size(); ++i)
+    {
+        const auto it = std::find(members.begin(), members.end(), candidates[i]);
+        memberToggles[static_cast<int>(i)]->setToggleState(it != members.end(), juce::dontSendNotification);
+        if (it == members.begin() && !members.empty())
+            masterBox.setSelectedId(static_cast<int>(i) + 1, juce::dontSendNotification);
+    }
+}
+
+void AudioServerSettingsComponent::AggregateDeviceEditor::comboBoxChanged(juce::ComboBox* comboBox)
+{
+    if (comboBox == &aggregateBox)
+        showAggregate(aggregateBox.getSelectedId() > 1 ? aggregateBox.getText() : juce::String());
+}
+
+void AudioServerSettingsComponent::AggregateDeviceEditor::buttonClicked(juce::Button* button)
+{
+    auto* aggregates = AggregateAudioDevices::getInstance();
+    const auto previousName = aggregateBox.getSelectedId() > 1 ? aggregateBox.getText() : juce::String();
+
+    if (button == &removeButton)
+    {
+        if (previousName.isNotEmpty())
+            aggregates->removeDevice(previousName);
+        refreshAggregateList({});
+    }
+    else if (button == &saveButton)
+    {
+        const auto name = nameEditor.getText().trim();
+        const int masterIndex = masterBox.getSelectedId() - 1;
+        if (name.isEmpty() || masterIndex < 0)
+        {
+            juce::AlertWindow::showMessageBoxAsync(
+                juce::MessageBoxIconType::WarningIcon,
+                "Aggregate Devices",
+                "Enter a name and choose the clock master.",
+                "OK"
+            );
+            return;
+        }
+
+        // The master is always a member, and always the first
+        std::vector<AggregateMember> members{candidates[static_cast<size_t>(masterIndex)]};
+        for (size_t i = 0; i < candidates.size(); ++i)
+            if (static_cast<int>(i) != masterIndex && memberToggles[static_cast<int>(i)]->getToggleState())
+                members.push_back(candidates[i]);
+
+        if (previousName.isNotEmpty() && previousName != name)
+            aggregates->removeDevice(previousName);
+        aggregates->setDevice(name, members);
+        refreshAggregateList(name);
+    }
+    else
+    {
+        return;
+    }
+
+    if (onAggregatesChanged)
+        onAggregatesChanged();
+}
+
+void AudioServerSettingsComponent::showAggregateEditor()
+{
+    if (aggregateEditorDialog != nullptr)
+    {
+        aggregateEditorDialog->toFront(true);
+        return;
+    }
+
+    auto* editor = new AggregateDeviceEditor(server);
+    editor->setSize(420, 400);
+    editor->onAggregatesChanged = [safeThis = juce::Component::SafePointer<AudioServerSettingsComponent>(this)]
+    {
+        if (safeThis != nullptr)
+            safeThis->updateDeviceTrees();
+    };
+
+    juce::DialogWindow::LaunchOptions o;
+    o.content.setOwned(editor);
+    o.dialogTitle = "Aggregate Devices";
+    o.componentToCentreAround = this;
+    o.dialogBackgroundColour = getLookAndFeel().findColour(juce::ResizableWindow::backgroundColourId);
+    o.escapeKeyTriggersCloseButton = true;
+    o.useNativeTitleBar = false;
+    o.resizable = false;
+
+    aggregateEditorDialog = o.launchAsync();
+}
+
+AudioServerSettingsComponent::VirtualDeviceEditor::VirtualDeviceEditor()
+{
+    deviceBox.addListener(this);
+    addAndMakeVisible(deviceBox);
+
+    typeLabel.setText("Type", juce::dontSendNotification);
+    addAndMakeVisible(typeLabel);
+    typeBox.addItem(VirtualAudioDevices::NULL_TYPE_NAME, 1);
+    typeBox.addItem(VirtualAudioDevices::FILE_TYPE_NAME, 2);
+    typeBox.addListener(this);
+    addAndMakeVisible(typeBox);
+
+    const auto addRow = [this](juce::Label& label, const juce::String& text, juce::TextEditor& editor)
+    {
+        label.setText(text, juce::dontSendNotification);
+        addAndMakeVisible(label);
+        addAndMakeVisible(editor);
+    };
+    addRow(nameLabel, "Name", nameEditor);
+    addRow(sampleRateLabel, "Sample rate", sampleRateEditor);
+    addRow(blockSizeLabel, "Block size", blockSizeEditor);
+    addRow(inputsLabel, "Inputs", inputsEditor);
+    addRow(outputsLabel, "Outputs", outputsEditor);
+    addRow(driftLabel, "Drift (ppm)", driftEditor);
+    addRow(playFileLabel, "Play file", playFileEditor);
+    addRow(recordFileLabel, "Record file", recordFileEditor);
+
+    sampleRateEditor.setInputRestrictions(0, "0123456789.");
+    blockSizeEditor.setInputRestrictions(0, "0123456789");
+    inputsEditor.setInputRestrictions(0, "0123456789");
+    outputsEditor.setInputRestrictions(0, "0123456789");
+    driftEditor.setInputRestrictions(0, "-0123456789.");
+
+    addAndMakeVisible(loopbackToggle);
+
+    for (auto* button : {&playFileButton, &recordFileButton, &saveButton, &removeButton})
+    {
+        button->addListener(this);
+        addAndMakeVisible(button);
+    }
+
+    refreshDeviceList({}, {});
+}
+
+AudioServerSettingsComponent::VirtualDeviceEditor::~VirtualDeviceEditor()
+{
+    deviceBox.removeListener(this);
+    typeBox.removeListener(this);
+    for (auto* button : {&playFileButton, &recordFileButton, &saveButton, &removeButton})
+        button->removeListener(this);
+}
+
+void AudioServerSettingsComponent::VirtualDeviceEditor::resized()
+{
+    auto bounds = getLocalBounds().reduced(10);
+
+    deviceBox.setBounds(bounds.removeFromTop(26));
+    bounds.removeFromTop(8); // Gap
+
+    const auto layoutRow = [&bounds](juce::Label& label, juce::Component& field, juce::Button* button)
+    {
+        auto row = bounds.removeFromTop(26);
+        label.setBounds(row.removeFromLeft(100));
+        if (button != nullptr)
+        {
+            button->setBounds(row.removeFromRight(30));
+            row.removeFromRight(5); // Gap
+        }
+        field.setBounds(row);
+        bounds.removeFromTop(5); // Gap
+    };
+    layoutRow(typeLabel, typeBox, nullptr);
+    layoutRow(nameLabel, nameEditor, nullptr);
+    layoutRow(sampleRateLabel, sampleRateEditor, nullptr);
+    layoutRow(blockSizeLabel, blockSizeEditor, nullptr);
+    layoutRow(inputsLabel, inputsEditor, nullptr);
+    layoutRow(outputsLabel, outputsEditor, nullptr);
+    layoutRow(driftLabel, driftEditor, nullptr);
+
+    // Null devices show the loopback row, File devices the two file rows in its place
+    const auto typeArea = bounds;
+    loopbackToggle.setBounds(bounds.removeFromTop(26).withTrimmedLeft(100));
+    bounds = typeArea;
+    layoutRow(playFileLabel, playFileEditor, &playFileButton);
+    layoutRow(recordFileLabel, recordFileEditor, &recordFileButton);
+
+    auto buttonArea = getLocalBounds().reduced(10).removeFromBottom(30);
+    buttonArea.removeFromTop(5); // Gap
+    saveButton.setBounds(buttonArea.removeFromRight(80));
+    buttonArea.removeFromRight(5); // Gap
+    removeButton.setBounds(buttonArea.removeFromRight(80));
+}
+
+void AudioServerSettingsComponent::VirtualDeviceEditor::refreshDeviceList(
+    const juce::String& selectedType,
+    const juce::String& selectedName
+)
+{
+    auto* devices = VirtualAudioDevices::getInstance();
+    listed.clear();
+    for (const char* typeName : {VirtualAudioDevices::NULL_TYPE_NAME, VirtualAudioDevices::FILE_TYPE_NAME})
+        for (const auto& deviceName : devices->getAllDeviceNames(typeName))
+            listed.push_back({typeName, deviceName});
+
+    deviceBox.clear(juce::dontSendNotification);
+    deviceBox.addItem("New virtual device", 1);
+    int selectedId = 1;
+    for (size_t i = 0; i < listed.size(); ++i)
+    {
+        const int id = static_cast<int>(i) + 2;
+        deviceBox.addItem(listed[i].typeName + ": " + listed[i].deviceName, id);
+        if (listed[i].typeName == selectedType && listed[i].deviceName == selectedName)
+            selectedId = id;
+    }
+
+    deviceBox.setSelectedId(selectedId, juce::dontSendNotification);
+    if (selectedId > 1)
+        showDevice(selectedType, selectedName);
+    else
+        showDevice({}, {});
+}
+
+void AudioServerSettingsComponent::VirtualDeviceEditor::showDevice(
+    const juce::String& typeName,
+    const juce::String& deviceName
+)
+{
+    VirtualDeviceConfig config;
+    const bool exists =
+        deviceName.isNotEmpty() && VirtualAudioDevices::getInstance()->getConfig(typeName, deviceName, config);
+
+    typeBox.setSelectedId(typeName == VirtualAudioDevices::FILE_TYPE_NAME ? 2 : 1, juce::dontSendNotification);
+    nameEditor.setText(exists ? deviceName : juce::String(), juce::dontSendNotification);
+    sampleRateEditor.setText(juce::String(config.sampleRate, 0), juce::dontSendNotification);
+    blockSizeEditor.setText(juce::String(config.blockSize), juce::dontSendNotification);
+    inputsEditor.setText(juce::String(config.numInputChannels), juce::dontSendNotification);
+    outputsEditor.setText(juce::String(config.numOutputChannels), juce::dontSendNotification);
+    driftEditor.setText(juce::String(config.driftPpm), juce::dontSendNotification);
+    loopbackToggle.setToggleState(config.loopback, juce::dontSendNotification);
+    playFileEditor.setText(config.playFile.getFullPathName(), juce::dontSendNotification);
+    recordFileEditor.setText(config.recordFile.getFullPathName(), juce::dontSendNotification);
+    removeButton.setEnabled(exists);
+    updateTypeControls();
+}
+
+void AudioServerSettingsComponent::VirtualDeviceEditor::updateTypeControls()
+{
+    const bool isFile = typeBox.getSelectedId() == 2;
+    loopbackToggle.setVisible(!isFile);
+    for (auto* component : std::initializer_list<juce::Component*>{
+             &playFileLabel,
+             &playFileEditor,
+             &playFileButton,
+             &recordFileLabel,
+             &recordFileEditor,
+             &recordFileButton
+         })
+        component->setVisible(isFile);
+}
+
+void AudioServerSettingsComponent::VirtualDeviceEditor::browseForFile(juce::TextEditor& editor, bool forRecording)
+{
+    const auto path = editor.getText().trim();
+    fileChooser = std::make_unique<juce::FileChooser>(
+        forRecording ? "Record the outputs to" : "Play into the inputs",
+        juce::File::isAbsolutePath(path) ? juce::File(path) : juce::File(),
+        "*.wav"
+    );
+
+    const auto flags = (forRecording ? juce::FileBrowserComponent::saveMode : juce::FileBrowserComponent::openMode)
+                     | juce::FileBrowserComponent::canSelectFiles;
+    fileChooser->launchAsync(
+        flags,
+        [safeEditor = juce::Component::SafePointer<juce::TextEditor>(&editor)](const juce::FileChooser& chooser)
+        {
+            const auto result = chooser.getResult();
+            if (safeEditor != nullptr && result != juce::File())
+                safeEditor->setText(result.getFullPathName(), juce::dontSendNotification);
+        }
+    );
+}
+
+void AudioServerSettingsComponent::VirtualDeviceEditor::comboBoxChanged(juce::ComboBox* comboBox)
+{
+    if (comboBox == &deviceBox)
+    {
+        const int index = deviceBox.getSelectedId() - 2;
+        if (index >= 0 && static_cast<size_t>(index) < listed.size())
+            showDevice(listed[static_cast<size_t>(index)].typeName, listed[static_cast<size_t>(index)].deviceName);
+        else
+            showDevice({}, {});
+    }
+    else if (comboBox == &typeBox)
+    {
+        updateTypeControls();
+    }
+}
+
+void AudioServerSettingsComponent::VirtualDeviceEditor::buttonClicked(juce::Button* button)
+{
+    if (button == &playFileButton || button == &recordFileButton)
+    {
+        browseForFile(button == &playFileButton ? playFileEditor : recordFileEditor, button == &recordFileButton);
+        return;
+    }
+
+    auto* devices = VirtualAudioDevices::getInstance();
+    const int index = deviceBox.getSelectedId() - 2;
+    const auto previous =
+        index >= 0 && static_cast<size_t>(index) < listed.size() ? listed[static_cast<size_t>(index)] : ListedDevice{};
+
+    if (button == &removeButton)
+    {
+        if (previous.deviceName.isNotEmpty())
+            devices->removeDevice(previous.typeName, previous.deviceName);
+        refreshDeviceList({}, {});
+    }
+    else if (button == &saveButton)
+    {
+        const juce::String typeName =
+            typeBox.getSelectedId() == 2 ? VirtualAudioDevices::FILE_TYPE_NAME : VirtualAudioDevices::NULL_TYPE_NAME;
+        const auto name = nameEditor.getText().trim();
+
+        VirtualDeviceConfig config;
+        config.sampleRate = sampleRateEditor.getText().getDoubleValue();
+        config.blockSize = blockSizeEditor.getText().getIntValue();
+        config.numInputChannels = inputsEditor.getText().getIntValue();
+        config.numOutputChannels = outputsEditor.getText().getIntValue();
+        config.driftPpm = driftEditor.getText().getDoubleValue();
+        if (typeName == VirtualAudioDevices::NULL_TYPE_NAME)
+        {
+            config.loopback = loopbackToggle.getToggleState();
+        }
+        else
+        {
+            const auto playPath = playFileEditor.getText().trim();
+            const auto recordPath = recordFileEditor.getText().trim();
+            if (juce::File::isAbsolutePath(playPath))
+                config.playFile = juce::File(playPath);
+            if (juce::File::isAbsolutePath(recordPath))
+                config.recordFile = juce::File(recordPath);
+        }
+
+        if (name.isEmpty()
+            || config.sampleRate < 8000.0
+            || config.sampleRate > 768000.0
+            || config.blockSize < 16
+            || config.blockSize > 8192
+            || config.numInputChannels < 0
+            || config.numOutputChannels < 0
+            || config.numInputChannels + config.numOutputChannels == 0
+            || std::abs(config.driftPpm) > 10000.0)
+        {
+            juce::AlertWindow::showMessageBoxAsync(
+                juce::MessageBoxIconType::WarningIcon,
+                "Virtual Devices",
+                "Enter a name, a sample rate from 8000 to 768000 Hz, a block size from 16 to 8192 samples, "
+                "at least one input or output, and a drift within 10000 ppm.",
+                "OK"
+            );
+            return;
+        }
+
+        if (previous.deviceName.isNotEmpty() && (previous.typeName != typeName || previous.deviceName != name))
+            devices->removeDevice(previous.typeName, previous.deviceName);
+        devices->setDevice(typeName, name, config);
+        refreshDeviceList(typeName, name);
+    }
+    else
+    {
+        return;
+    }
+
+    if (onDevicesChanged)
+        onDevicesChanged();
+}
+
+void AudioServerSettingsComponent::showVirtualEditor()
+{
+    if (virtualEditorDialog != nullptr)
+    {
+        virtualEditorDialog->toFront(true);
+        return;
+    }
+
+    auto* editor = new VirtualDeviceEditor();
+    editor->setSize(420, 400);
+    editor->onDevicesChanged = [safeThis = juce::Component::SafePointer<AudioServerSettingsComponent>(this)]
+    {
+        if (safeThis != nullptr)
+            safeThis->updateDeviceTrees();
+    };
+
+    juce::DialogWindow::LaunchOptions o;
+    o.content.setOwned(editor);
+    o.dialogTitle = "Virtual Devices";
+    o.componentToCentreAround = this;
+    o.dialogBackgroundColour = getLookAndFeel().findColour(juce::ResizableWindow::backgroundColourId);
+    o.escapeKeyTriggersCloseButton = true;
+    o.useNativeTitleBar = false;
+    o.resizable = false;
+
+    virtualEditorDialog = o.launchAsync();
+}
+
 void AudioServerSettingsComponent::clearAllDeviceSubscriptions(DeviceChannelTreeItem* root)
 {
     if (!root)
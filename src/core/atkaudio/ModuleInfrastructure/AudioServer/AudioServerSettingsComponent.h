@@ -1,6 +1,8 @@
 #pragma once
 
+#include "AggregateAudioDevices.h"
 #include "AudioServer.h"
+#include "VirtualAudioDevices.h"
 
 #include <juce_audio_utils/juce_audio_utils.h>
 #include <juce_gui_basics/juce_gui_basics.h>
@@ -209,6 +211,100 @@ private:
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ChannelMappingMatrix)
     };
 
+    // Creates, edits and removes aggregate devices; see AggregateAudioDevices
+    class AggregateDeviceEditor
+        : public juce::Component
+        , private juce::Button::Listener
+        , private juce::ComboBox::Listener
+    {
+    public:
+        explicit AggregateDeviceEditor(AudioServer* server);
+        ~AggregateDeviceEditor() override;
+
+        void resized() override;
+
+        std::function<void()> onAggregatesChanged;
+
+    private:
+        void buttonClicked(juce::Button* button) override;
+        void comboBoxChanged(juce::ComboBox* comboBox) override;
+        void refreshAggregateList(const juce::String& selectedName);
+        void showAggregate(const juce::String& name);
+
+        std::vector<AggregateMember> candidates; // every device that can be a member
+        juce::ComboBox aggregateBox;             // "New aggregate" first, then the existing ones
+        juce::Label nameLabel;
+        juce::TextEditor nameEditor;
+        juce::Label masterLabel;
+        juce::ComboBox masterBox; // item IDs are candidate indices + 1
+        juce::Label membersLabel;
+        juce::Viewport membersViewport;
+        juce::Component membersContent;
+        juce::OwnedArray<juce::ToggleButton> memberToggles; // one per candidate
+        juce::TextButton saveButton{"Save"};
+        juce::TextButton removeButton{"Remove"};
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AggregateDeviceEditor)
+    };
+
+    // Creates, edits and removes Null and File devices; see VirtualAudioDevices
+    class VirtualDeviceEditor
+        : public juce::Component
+        , private juce::Button::Listener
+        , private juce::ComboBox::Listener
+    {
+    public:
+        VirtualDeviceEditor();
+        ~VirtualDeviceEditor() override;
+
+        void resized() override;
+
+        std::function<void()> onDevicesChanged;
+
+    private:
+        struct ListedDevice
+        {
+            juce::String typeName;
+            juce::String deviceName;
+        };
+
+        void buttonClicked(juce::Button* button) override;
+        void comboBoxChanged(juce::ComboBox* comboBox) override;
+        void refreshDeviceList(const juce::String& selectedType, const juce::String& selectedName);
+        void showDevice(const juce::String& typeName, const juce::String& deviceName);
+        void updateTypeControls();
+        void browseForFile(juce::TextEditor& editor, bool forRecording);
+
+        std::vector<ListedDevice> listed; // in deviceBox order, after "New virtual device"
+        juce::ComboBox deviceBox;
+        juce::Label typeLabel;
+        juce::ComboBox typeBox; // 1 Null, 2 File
+        juce::Label nameLabel;
+        juce::TextEditor nameEditor;
+        juce::Label sampleRateLabel;
+        juce::TextEditor sampleRateEditor;
+        juce::Label blockSizeLabel;
+        juce::TextEditor blockSizeEditor;
+        juce::Label inputsLabel;
+        juce::TextEditor inputsEditor;
+        juce::Label outputsLabel;
+        juce::TextEditor outputsEditor;
+        juce::Label driftLabel;
+        juce::TextEditor driftEditor;
+        juce::ToggleButton loopbackToggle{"Outputs loop back into the inputs"};
+        juce::Label playFileLabel;
+        juce::TextEditor playFileEditor;
+        juce::TextButton playFileButton{"..."};
+        juce::Label recordFileLabel;
+        juce::TextEditor recordFileEditor;
+        juce::TextButton recordFileButton{"..."};
+        juce::TextButton saveButton{"Save"};
+        juce::TextButton removeButton{"Remove"};
+        std::unique_ptr<juce::FileChooser> fileChooser;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(VirtualDeviceEditor)
+    };
+
     void updateDeviceTrees();
     void updateMappingMatrix();
     void onTreeSelectionChanged();
@@ -237,14 +333,20 @@ private:
     juce::TextButton restoreButton{"Discard"};
     juce::TextButton cancelButton{"Reset"};
     juce::TextButton deviceButton{"Device..."};
+    juce::TextButton aggregateButton{"Aggregate..."};
+    juce::TextButton virtualButton{"Virtual..."};
 
     juce::AudioDeviceManager* externalDeviceManager = nullptr;
     juce::Component::SafePointer<juce::DialogWindow> deviceSettingsDialog;
+    juce::Component::SafePointer<juce::DialogWindow> aggregateEditorDialog;
+    juce::Component::SafePointer<juce::DialogWindow> virtualEditorDialog;
 
     juce::String currentDeviceName; // Track which device we're showing settings for
 
     void updateDeviceSettings(const juce::String& deviceName);
     void showDeviceSettings();
+    void showAggregateEditor();
+    void showVirtualEditor();
 
 public:
     void setDeviceManager(juce::AudioDeviceManager* manager)
@@ -0,0 +1,223 @@
+#include "DeviceIdlePolicies.h"
+#include <atkaudio/atkaudio.h>
+#include <atkaudio/Logging.h>
+
+namespace atk
+{
+
+namespace
+{
+constexpr int kSettingsVersion = 1;
+// A day; anything longer is what KeepWarm is for
+constexpr int kMaxCloseDelayMs = 24 * 60 * 60 * 1000;
+
+const char* policyToString(DeviceIdlePolicy policy)
+{
+    switch (policy)
+    {
+    case DeviceIdlePolicy::KeepWarm:
+        return "keepWarm";
+    case DeviceIdlePolicy::CloseImmediately:
+        return "closeImmediately";
+    case DeviceIdlePolicy::CloseAfterDelay:
+        break;
+    }
+    return "closeAfterDelay";
+}
+
+DeviceIdlePolicy policyFromString(const juce::String& text)
+{
+    if (text == "keepWarm")
+        return DeviceIdlePolicy::KeepWarm;
+    if (text == "closeImmediately")
+        return DeviceIdlePolicy::CloseImmediately;
+    return DeviceIdlePolicy::CloseAfterDelay;
+}
+
+DeviceIdleSetting sanitized(DeviceIdleSetting setting)
+{
+    setting.closeDelayMs = juce::jlimit(0, kMaxCloseDelayMs, setting.closeDelayMs);
+    return setting;
+}
+
+DeviceIdleSetting readSetting(const juce::XmlElement& element)
+{
+    DeviceIdleSetting setting;
+    setting.policy = policyFromString(element.getStringAttribute("policy"));
+    setting.closeDelayMs = element.getIntAttribute("delayMs", DeviceIdleSetting::DEFAULT_CLOSE_DELAY_MS);
+    return sanitized(setting);
+}
+
+void writeSetting(juce::XmlElement& element, const DeviceIdleSetting& setting)
+{
+    element.setAttribute("policy", policyToString(setting.policy));
+    element.setAttribute("delayMs", setting.closeDelayMs);
+}
+} // namespace
+
+JUCE_IMPLEMENT_SINGLETON(DeviceIdlePolicies)
+
+DeviceIdlePolicies::DeviceIdlePolicies()
+{
+    loadFromDisk();
+}
+
+DeviceIdlePolicies::~DeviceIdlePolicies()
+{
+    clearSingletonInstance();
+}
+
+DeviceIdleSetting DeviceIdlePolicies::getDefaultSetting() const
+{
+    const juce::ScopedLock sl(lock);
+    return defaultSetting;
+}
+
+void DeviceIdlePolicies::setDefaultSetting(const DeviceIdleSetting& setting)
+{
+    const juce::ScopedLock sl(lock);
+    defaultSetting = sanitized(setting);
+    saveToDisk();
+}
+
+DeviceIdleSetting DeviceIdlePolicies::getSetting(const juce::String& deviceName) const
+{
+    const juce::ScopedLock sl(lock);
+    const auto it = deviceSettings.find(deviceName);
+    return it != deviceSettings.end() ? it->second : defaultSetting;
+}
+
+bool DeviceIdlePolicies::hasOwnSetting(const juce::String& deviceName) const
+{
+    const juce::ScopedLock sl(lock);
+    return deviceSettings.find(deviceName) != deviceSettings.end();
+}
+
+void DeviceIdlePolicies::setSetting(const juce::String& deviceName, const DeviceIdleSetting& setting)
+{
+    if (deviceName.isEmpty())
+        return;
+
+    const juce::ScopedLock sl(lock);
+    deviceSettings[deviceName] = sanitized(setting);
+    saveToDisk();
+}
+
+void DeviceIdlePolicies::clearSetting(const juce::String& deviceName)
+{
+    const juce::ScopedLock sl(lock);
+    if (deviceSettings.erase(deviceName) > 0)
+        saveToDisk();
+}
+
+std::vector<CollectionDevice> DeviceIdlePolicies::getCollectionDevices(const juce::String& collectionName) const
+{
+    const juce::ScopedLock sl(lock);
+    const auto it = collectionDevices.find(collectionName);
+    return it != collectionDevices.end() ? it->second : std::vector<CollectionDevice>();
+}
+
+void DeviceIdlePolicies::setCollectionDevices(
+    const juce::String& collectionName,
+    const std::vector<CollectionDevice>& devices
+)
+{
+    if (collectionName.isEmpty())
+        return;
+
+    const juce::ScopedLock sl(lock);
+    auto it = collectionDevices.find(collectionName);
+    if (it != collectionDevices.end() && it->second == devices)
+        return;
+
+    if (devices.empty())
+        collectionDevices.erase(collectionName);
+    else
+        collectionDevices[collectionName] = devices;
+    saveToDisk();
+}
+
+juce::File DeviceIdlePolicies::getSettingsFile()
+{
+    return atk::getSettingsFile("atkAudio Device Idle Policies");
+}
+
+void DeviceIdlePolicies::loadFromDisk()
+{
+    const auto file = getSettingsFile();
+    if (!file.existsAsFile())
+        return;
+
+    auto root = juce::XmlDocument::parse(file);
+    if (root == nullptr
+        || !root->hasTagName("DEVICE_IDLE_POLICIES")
+        || root->getIntAttribute("version") != kSettingsVersion)
+    {
+        atk::logging::warning("DeviceIdlePolicies::loadFromDisk", "ignoring unreadable " + file.getFullPathName());
+        return;
+    }
+
+    const juce::ScopedLock sl(lock);
+    if (auto* element = root->getChildByName("DEFAULT"))
+        defaultSetting = readSetting(*element);
+
+    for (auto* element : root->getChildWithTagNameIterator("DEVICE"))
+    {
+        const auto name = element->getStringAttribute("name");
+        if (name.isNotEmpty())
+            deviceSettings[name] = readSetting(*element);
+    }
+
+    for (auto* element : root->getChildWithTagNameIterator("COLLECTION"))
+    {
+        std::vector<CollectionDevice> devices;
+        for (auto* deviceElement : element->getChildWithTagNameIterator("DEVICE"))
+        {
+            CollectionDevice device;
+            device.deviceKey = deviceElement->getStringAttribute("key");
+            device.sampleRate = juce::jmax(0.0, deviceElement->getDoubleAttribute("sampleRate"));
+            device.bufferSize = juce::jmax(0, deviceElement->getIntAttribute("bufferSize"));
+            if (device.deviceKey.isNotEmpty())
+                devices.push_back(device);
+        }
+
+        const auto name = element->getStringAttribute("name");
+        if (name.isNotEmpty() && !devices.empty())
+            collectionDevices[name] = std::move(devices);
+    }
+}
+
+void DeviceIdlePolicies::saveToDisk() const
+{
+    juce::XmlElement root("DEVICE_IDLE_POLICIES");
+    root.setAttribute("version", kSettingsVersion);
+
+    writeSetting(*root.createNewChildElement("DEFAULT"), defaultSetting);
+
+    for (const auto& [name, setting] : deviceSettings)
+    {
+        auto* element = root.createNewChildElement("DEVICE");
+        element->setAttribute("name", name);
+        writeSetting(*element, setting);
+    }
+
+    for (const auto& [name, devices] : collectionDevices)
+    {
+        auto* element = root.createNewChildElement("COLLECTION");
+        element->setAttribute("name", name);
+        for (const auto& device : devices)
+        {
+            auto* deviceElement = element->createNewChildElement("DEVICE");
+            deviceElement->setAttribute("key", device.deviceKey);
+            deviceElement->setAttribute("sampleRate", device.sampleRate);
+            deviceElement->setAttribute("bufferSize", device.bufferSize);
+        }
+    }
+
+    const auto file = getSettingsFile();
+    file.getParentDirectory().createDirectory();
+    if (!root.writeTo(file))
+        atk::logging::warning("DeviceIdlePolicies::saveToDisk", "could not write " + file.getFullPathName());
+}
+
+} // namespace atk
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_events/juce_events.h>
+
+#include <map>
+#include <vector>
+
+namespace atk
+{
+
+// What AudioServer does with a device once no client or direct callback uses it
+enum class DeviceIdlePolicy
+{
+    KeepWarm,         // leave it open until AudioServer shuts down
+    CloseAfterDelay,  // close it after closeDelayMs unless something uses it again
+    CloseImmediately, // close it as soon as it is idle
+};
+
+struct DeviceIdleSetting
+{
+    static constexpr int DEFAULT_CLOSE_DELAY_MS = 5000;
+
+    DeviceIdlePolicy policy = DeviceIdlePolicy::CloseAfterDelay;
+    int closeDelayMs = DEFAULT_CLOSE_DELAY_MS;
+
+    bool operator==(const DeviceIdleSetting& other) const
+    {
+        return policy == other.policy && closeDelayMs == other.closeDelayMs;
+    }
+};
+
+// A device a scene collection used, with the rate and block size it ran at, so that opening it
+// ahead of the collection's sources does not make a direct callback that asks for them reopen it
+struct CollectionDevice
+{
+    juce::String deviceKey; // AudioServer device key ("type|name")
+    double sampleRate = 0.0;
+    int bufferSize = 0;
+
+    bool operator==(const CollectionDevice& other) const
+    {
+        return deviceKey == other.deviceKey
+            && juce::exactlyEqual(sampleRate, other.sampleRate)
+            && bufferSize == other.bufferSize;
+    }
+};
+
+// The idle settings of AudioServer's devices, per device name with a default for the rest, and the
+// devices each OBS scene collection used the last time it was switched away from, so that they can
+// be opened before the collection's sources ask for them. Kept in a settings file.
+//
+// Thread safe. AudioServer reads the setting each time a device goes idle; use AudioServer's
+// setters, which also apply a change to the devices that are idle already.
+class DeviceIdlePolicies : public juce::DeletedAtShutdown
+{
+public:
+    JUCE_DECLARE_SINGLETON(DeviceIdlePolicies, false)
+    ~DeviceIdlePolicies() override;
+
+    DeviceIdleSetting getDefaultSetting() const;
+    void setDefaultSetting(const DeviceIdleSetting& setting);
+
+    // The device's own setting if it has one, otherwise the default
+    DeviceIdleSetting getSetting(const juce::String& deviceName) const;
+    bool hasOwnSetting(const juce::String& deviceName) const;
+    void setSetting(const juce::String& deviceName, const DeviceIdleSetting& setting);
+    void clearSetting(const juce::String& deviceName);
+
+    std::vector<CollectionDevice> getCollectionDevices(const juce::String& collectionName) const;
+    void setCollectionDevices(const juce::String& collectionName, const std::vector<CollectionDevice>& devices);
+
+private:
+    DeviceIdlePolicies();
+
+    void loadFromDisk();
+    void saveToDisk() const;
+    static juce::File getSettingsFile();
+
+    mutable juce::CriticalSection lock;
+    DeviceIdleSetting defaultSetting;
+    std::map<juce::String, DeviceIdleSetting> deviceSettings;
+    std::map<juce::String, std::vector<CollectionDevice>> collectionDevices;
+};
+
+} // namespace atk
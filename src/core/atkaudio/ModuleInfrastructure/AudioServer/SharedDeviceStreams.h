@@ -0,0 +1,595 @@
+#pragma once
+
+#include <atkaudio/AtomicSharedPtr.h>
+#include <atkaudio/BroadcastFifo.h>
+#include <atkaudio/FifoBuffer2.h>
+#include <atkaudio/RealtimeMemory.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace atk
+{
+
+// A device's input, drift-corrected and resampled to the client rate once for all of its clients.
+// The device callback copies the union of the channels the clients subscribe to into a device-rate
+// ring that has every device channel, and writes silence to the rest; the copy list is precomputed
+// by setChannels() and swapped atomically, so the callback does nothing but those copies. A single
+// SyncBuffer, the converter, reads that ring and writes every channel into a second ring at the
+// client rate. That makes one drift estimate and one resampler per device whatever the number of
+// clients, and a client subscribing or leaving a channel changes only the copy list, never the
+// converter; each client only copies its channels out through a DeviceInputTap.
+// Conversion is on demand: the first client of a block to find too little converted audio converts
+// the shortfall, and the others copy the same samples. A client that arrives while the conversion
+// runs waits for it, for up to half a block, rather than play silence; one that gives up rejoins
+// the others at the end of that block on its next read. Clients joining mid-stream line up with the
+// most recently converted block, so all of them hear the device with the same phase.
+class SharedDeviceInput
+{
+public:
+    // Client-rate audio kept for clients running late, ~340 ms at 48 kHz
+    static constexpr int CONVERTED_CAPACITY = 16384;
+
+    // One client's read position; its audio thread only
+    struct ReadPosition
+    {
+        BroadcastFifo::Cursor cursor;
+        // Where the block another client was converting ends, when this one stopped waiting for it
+        std::optional<uint64_t> rejoinAt;
+    };
+
+    explicit SharedDeviceInput(int numDeviceChannels)
+        : numDeviceChannels(std::max(0, numDeviceChannels))
+        , deviceRing(std::make_shared<BroadcastFifo>(this->numDeviceChannels, FIXED_BUFFER_SIZE))
+        , devicePointers(static_cast<size_t>(this->numDeviceChannels), nullptr)
+        , converter(std::make_shared<SyncBuffer>("shared device input"))
+        , convertedRing(numDeviceChannels, CONVERTED_CAPACITY)
+        , temp(static_cast<size_t>(this->numDeviceChannels) * kTempCapacity, 0.0f)
+        , tempPointers(static_cast<size_t>(this->numDeviceChannels))
+    {
+        // Both rings carry the channels at their device index
+        std::vector<int> ringChannels(static_cast<size_t>(this->numDeviceChannels));
+        for (size_t i = 0; i < ringChannels.size(); ++i)
+            ringChannels[i] = static_cast<int>(i);
+        converter->setSource(deviceRing, std::move(ringChannels));
+
+        if (!temp.empty())
+            lockedTemp.lock(temp.data(), temp.size() * sizeof(float));
+        for (size_t i = 0; i < tempPointers.size(); ++i)
+            tempPointers[i] = temp.data() + i * static_cast<size_t>(kTempCapacity);
+        convertedPointers.assign(tempPointers.begin(), tempPointers.end());
+    }
+
+    int getNumDeviceChannels() const
+    {
+        return numDeviceChannels;
+    }
+
+    // Not on the audio thread. deviceChannels ascending; the others are written as silence. Only the
+    // device callback's copy list changes, so the converter keeps its drift estimate and position.
+    void setChannels(std::vector<int> deviceChannels)
+    {
+        const auto current = copiedChannels.load();
+        if (current && *current == deviceChannels)
+            return;
+
+        copiedChannels.store(std::make_shared<const std::vector<int>>(std::move(deviceChannels)));
+    }
+
+    // Device callback only
+    void writeFromDevice(const float* const* data, int numChannels, int numSamples, double sampleRate)
+    {
+        std::fill(devicePointers.begin(), devicePointers.end(), nullptr);
+        if (const auto copied = copiedChannels.load())
+            for (const int channel : *copied)
+                if (channel >= 0 && channel < numChannels && channel < numDeviceChannels)
+                    devicePointers[static_cast<size_t>(channel)] = data[channel];
+
+        deviceRing->write(devicePointers.data(), numDeviceChannels, numSamples, sampleRate);
+    }
+
+    // Client audio thread. Fills dest[i] with device channel deviceChannels[i]; returns false, with
+    // dest silent, if nothing could be read.
+    bool read(
+        ReadPosition& position,
+        bool align,
+        float* const* dest,
+        const int* deviceChannels,
+        int numChannels,
+        int numSamples,
+        double sampleRate
+    )
+    {
+        auto& cursor = position.cursor;
+        if (position.rejoinAt && !align)
+        {
+            // Skip what the other clients played while this one was silent
+            const BroadcastFifo::Cursor rejoin{*position.rejoinAt};
+            if (convertedRing.getNumReady(rejoin) >= 0)
+                cursor = rejoin;
+            else
+                align = true;
+        }
+        position.rejoinAt.reset();
+
+        if (align || convertedRing.getNumReady(cursor) < 0)
+            alignCursor(cursor);
+
+        bool converted = true;
+        const int ready = convertedRing.getNumReady(cursor);
+        if (ready >= 0 && ready < numSamples)
+            converted = convert(cursor, numSamples, sampleRate);
+
+        int numRead = convertedRing.peek(cursor, dest, deviceChannels, numChannels, numSamples);
+        if (numRead < 0)
+        {
+            // Lapped while copying; start over from the current block next time
+            alignCursor(cursor);
+            numRead = 0;
+        }
+
+        for (int i = 0; i < numChannels; ++i)
+            std::memset(dest[i] + numRead, 0, static_cast<size_t>(numSamples - numRead) * sizeof(float));
+
+        convertedRing.advance(cursor, numRead);
+
+        if (!converted)
+        {
+            const uint64_t end = convertingEnd.load(std::memory_order_acquire);
+            if (end > cursor.position)
+                position.rejoinAt = end;
+        }
+        return numRead > 0;
+    }
+
+    // Lock-free; drift and jitter of the one converter every client shares
+    SyncBufferStats getStats() const
+    {
+        return converter->getStats();
+    }
+
+    // Timestamps for the device and converter timing, as SyncBuffer::setClock(). Not while running.
+    void setClock(SyncBuffer::Clock newClock, void* context)
+    {
+        std::lock_guard<std::mutex> lock(converterLock);
+        deviceRing->setClock(newClock, context);
+        converter->setClock(newClock, context);
+    }
+
+private:
+    static constexpr int kTempCapacity = 4096;
+    // Longest a client waits for another's conversion, whatever the block size
+    static constexpr double kMaxConverterWaitSeconds = 0.005;
+
+    // Also covers a cursor the writer lapped
+    void alignCursor(BroadcastFifo::Cursor& cursor) const
+    {
+        cursor.position = lastBlockStart.load(std::memory_order_acquire);
+        if (convertedRing.getNumReady(cursor) < 0)
+            convertedRing.resync(cursor);
+    }
+
+    // Converts what cursor lacks of numSamples. Whoever loses the race for the converter waits for
+    // the winner, whose block is then usually all it needs, for up to half of its own block.
+    // Returns false if it gave up waiting.
+    bool convert(const BroadcastFifo::Cursor& cursor, int numSamples, double sampleRate)
+    {
+        std::unique_lock<std::mutex> lock(converterLock, std::try_to_lock);
+        if (!lock.owns_lock())
+        {
+            const double waitSeconds =
+                sampleRate > 0.0 ? std::min(kMaxConverterWaitSeconds, 0.5 * numSamples / sampleRate) : 0.0;
+            const auto deadline = std::chrono::steady_clock::now()
+                                + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                      std::chrono::duration<double>(waitSeconds)
+                                );
+            while (!lock.try_lock())
+            {
+                if (std::chrono::steady_clock::now() >= deadline)
+                    return false;
+                std::this_thread::yield();
+            }
+        }
+
+        // What the previous holder converted may already cover this block
+        const int ready = convertedRing.getNumReady(cursor);
+        if (ready < 0 || ready >= numSamples)
+            return true;
+        numSamples -= ready;
+
+        const int numChannels = numDeviceChannels;
+
+        // OBS blocks fit in one go; anything larger is converted in chunks
+        BroadcastFifo::Cursor start;
+        convertedRing.resync(start);
+        convertingEnd.store(start.position + static_cast<uint64_t>(numSamples), std::memory_order_release);
+        for (int done = 0; done < numSamples;)
+        {
+            const int chunk = std::min(numSamples - done, kTempCapacity);
+            if (numChannels > 0 && !converter->read(tempPointers.data(), numChannels, chunk, sampleRate, false))
+                for (auto* channel : tempPointers)
+                    std::memset(channel, 0, static_cast<size_t>(chunk) * sizeof(float));
+
+            convertedRing.write(convertedPointers.data(), numDeviceChannels, chunk, sampleRate);
+            done += chunk;
+        }
+        lastBlockStart.store(start.position, std::memory_order_release);
+        return true;
+    }
+
+    const int numDeviceChannels;
+    AtomicSharedPtr<const std::vector<int>> copiedChannels; // what the device callback copies
+    std::shared_ptr<BroadcastFifo> deviceRing;
+    std::vector<const float*> devicePointers; // device callback scratch
+    std::shared_ptr<SyncBuffer> converter;
+    BroadcastFifo convertedRing;
+
+    // Guards the converter and everything below; try-locked on the audio threads
+    std::mutex converterLock;
+    std::vector<float> temp;
+    std::vector<float*> tempPointers;
+    std::vector<const float*> convertedPointers; // by device channel
+    rtmemory::LockedRegion lockedTemp;
+
+    std::atomic<uint64_t> lastBlockStart{0};
+    std::atomic<uint64_t> convertingEnd{0}; // ring position the current or last conversion ends at
+};
+
+// A device's output, mixed at the client rate and then drift-corrected and resampled once for all
+// of its clients. Each client adds its blocks into a shared mix through a DeviceOutputTap, and the
+// mix goes to a single SyncBuffer, the converter, which the device callback reads. The device
+// callback costs one resample whatever the number of clients.
+// The mix advances in ticks, one per OBS audio tick: every client writing within half a block of
+// the tick's first write, and not twice, adds into the same block, so all clients stay in phase. A
+// tick is handed on as soon as every client still taking part has written it, or otherwise when
+// the next tick starts. A client that misses a tick (bypassed, or its source went inactive) drops
+// out until it writes again, so it holds the others back by at most one block, once.
+// The converter spans every active device channel and lives as long as the device runs;
+// setNumChannels() only limits which channels clients mix into and the device callback receives.
+// The mix lock is taken by client threads only, never by the device callback.
+class SharedDeviceOutput
+{
+public:
+    // Longest block a client can add in one tick, and the device block read at once
+    static constexpr int PENDING_CAPACITY = 8192;
+
+    // A client's place in the mix, owned by its DeviceOutputTap and guarded by the mix lock
+    struct Writer
+    {
+        std::atomic<const SharedDeviceOutput*> owner{nullptr};
+        uint64_t lastTick = 0;
+        bool active = false;
+    };
+
+    explicit SharedDeviceOutput(int numDeviceChannels)
+        : numDeviceChannels(std::max(0, numDeviceChannels))
+        , pending(static_cast<size_t>(this->numDeviceChannels) * PENDING_CAPACITY, 0.0f)
+        , pendingPointers(static_cast<size_t>(this->numDeviceChannels))
+        , converted(static_cast<size_t>(this->numDeviceChannels) * PENDING_CAPACITY, 0.0f)
+        , convertedPointers(static_cast<size_t>(this->numDeviceChannels))
+        , numChannels(this->numDeviceChannels)
+    {
+        for (int ch = 0; ch < this->numDeviceChannels; ++ch)
+        {
+            pendingPointers[static_cast<size_t>(ch)] = getPending(ch);
+            convertedPointers[static_cast<size_t>(ch)] = converted.data() + static_cast<size_t>(ch) * PENDING_CAPACITY;
+        }
+        if (!pending.empty())
+        {
+            lockedPending.lock(pending.data(), pending.size() * sizeof(float));
+            lockedConverted.lock(converted.data(), converted.size() * sizeof(float));
+        }
+    }
+
+    int getNumDeviceChannels() const
+    {
+        return numDeviceChannels;
+    }
+
+    // Not on the audio thread. Channels from numChannels on are left silent. The converter keeps
+    // running, so the channels both spans share carry on without a gap.
+    void setNumChannels(int newNumChannels)
+    {
+        newNumChannels = std::clamp(newNumChannels, 0, numDeviceChannels);
+
+        std::lock_guard<std::mutex> lock(mixLock);
+        numChannels.store(newNumChannels, std::memory_order_relaxed);
+    }
+
+    // Not on the audio thread
+    void attach(Writer& writer)
+    {
+        std::lock_guard<std::mutex> lock(mixLock);
+        if (writer.owner.load(std::memory_order_relaxed) == this)
+            return;
+
+        writer.owner.store(this, std::memory_order_relaxed);
+        writer.active = false;
+        writers.push_back(&writer);
+    }
+
+    void detach(Writer& writer)
+    {
+        std::lock_guard<std::mutex> lock(mixLock);
+        writers.erase(std::remove(writers.begin(), writers.end(), &writer), writers.end());
+        if (writer.owner.load(std::memory_order_relaxed) == this)
+            writer.owner.store(nullptr, std::memory_order_relaxed);
+    }
+
+    // Client audio thread. src[ch] is device channel ch; nullptr channels add nothing. With
+    // rejoin, the writer is treated as new to the mix. Returns false if it isn't attached here.
+    bool add(
+        Writer& writer,
+        bool rejoin,
+        const float* const* src,
+        int numSrcChannels,
+        int numSamples,
+        double sampleRate
+    )
+    {
+        std::lock_guard<std::mutex> lock(mixLock);
+        if (writer.owner.load(std::memory_order_relaxed) != this)
+            return false;
+
+        numSamples = std::min(numSamples, PENDING_CAPACITY);
+        if (numSamples <= 0 || sampleRate <= 0.0)
+            return true;
+
+        if (rejoin)
+            writer.active = false;
+
+        const double now = nowSeconds();
+        if (writer.lastTick == tick || tickLength == 0 || now - tickTime > 0.5 * tickLength / tickSampleRate)
+            startTick(now, sampleRate);
+
+        writer.active = true;
+        writer.lastTick = tick;
+
+        // Came in after everyone it knew of had written and the block was gone; from the next tick
+        if (tickFlushed)
+            return true;
+
+        const int numMixed = std::min(numSrcChannels, numChannels.load(std::memory_order_relaxed));
+        for (int ch = 0; ch < numMixed; ++ch)
+            if (src[ch] != nullptr)
+                for (int i = 0; i < numSamples; ++i)
+                    getPending(ch)[i] += src[ch][i];
+        tickLength = std::max(tickLength, numSamples);
+
+        const bool everyoneWrote = std::all_of(
+            writers.begin(),
+            writers.end(),
+            [this](const Writer* other) { return !other->active || other->lastTick == tick; }
+        );
+        if (everyoneWrote)
+            flush();
+        return true;
+    }
+
+    // Device callback only. Adds the mix into dest's first numChannels channels and leaves the
+    // rest alone.
+    bool readToDevice(float* const* dest, int numDestChannels, int numSamples, double sampleRate)
+    {
+        const int numRouted = numChannels.load(std::memory_order_relaxed);
+        if (numRouted <= 0 || numDestChannels < numRouted || numSamples > PENDING_CAPACITY)
+            return false;
+
+        // Always all of them; a read narrower than the writes folds the rest in
+        if (!converter.read(convertedPointers.data(), numDeviceChannels, numSamples, sampleRate))
+            return false;
+
+        for (int ch = 0; ch < numRouted; ++ch)
+        {
+            const float* src = convertedPointers[static_cast<size_t>(ch)];
+            for (int i = 0; i < numSamples; ++i)
+                dest[ch][i] += src[i];
+        }
+        return true;
+    }
+
+    // Lock-free; drift and jitter of the one converter every client shares
+    SyncBufferStats getStats() const
+    {
+        return converter.getStats();
+    }
+
+    // Timestamps for the tick boundaries and the converter timing, as SyncBuffer::setClock(). Not
+    // while running.
+    void setClock(SyncBuffer::Clock newClock, void* context)
+    {
+        std::lock_guard<std::mutex> lock(mixLock);
+        clock = newClock;
+        clockContext = context;
+        converter.setClock(clock, clockContext);
+    }
+
+private:
+    float* getPending(int channel)
+    {
+        return pending.data() + static_cast<size_t>(channel) * PENDING_CAPACITY;
+    }
+
+    double nowSeconds() const
+    {
+        if (clock != nullptr)
+            return clock(clockContext);
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Hands on the tick still pending, if anyone wrote it, and drops whoever didn't
+    void startTick(double now, double sampleRate)
+    {
+        if (!tickFlushed)
+            flush();
+
+        for (auto* writer : writers)
+            if (writer->lastTick != tick)
+                writer->active = false;
+
+        ++tick;
+        tickTime = now;
+        tickSampleRate = sampleRate;
+        tickLength = 0;
+        tickFlushed = false;
+    }
+
+    void flush()
+    {
+        // Every device channel, so a change of span never re-prepares the converter
+        if (numDeviceChannels > 0 && tickLength > 0)
+        {
+            converter.write(pendingPointers.data(), numDeviceChannels, tickLength, tickSampleRate);
+            for (int ch = 0; ch < numDeviceChannels; ++ch)
+                std::memset(getPending(ch), 0, static_cast<size_t>(tickLength) * sizeof(float));
+        }
+        tickFlushed = true;
+    }
+
+    const int numDeviceChannels;
+    SyncBuffer converter{"shared device output"};
+
+    // Device callback only
+    std::vector<float> converted; // PENDING_CAPACITY per device channel
+    std::vector<float*> convertedPointers;
+    rtmemory::LockedRegion lockedConverted;
+
+    std::atomic<int> numChannels; // written under the mix lock
+
+    // Guards everything below
+    std::mutex mixLock;
+    SyncBuffer::Clock clock{nullptr};
+    void* clockContext{nullptr};
+    std::vector<Writer*> writers;
+    std::vector<float> pending; // the current tick, PENDING_CAPACITY per channel
+    std::vector<const float*> pendingPointers;
+    rtmemory::LockedRegion lockedPending;
+    uint64_t tick = 0;
+    double tickTime = 0.0;
+    double tickSampleRate = 48000.0;
+    int tickLength = 0;
+    bool tickFlushed = true;
+};
+
+// One client's view of a device's SharedDeviceInput. bind() may swap the input and channel list
+// while the client reads; read() picks the new ones up at its next call, wait-free.
+class DeviceInputTap
+{
+public:
+    // Not on the audio thread. A new input realigns the read position; new channels alone don't.
+    void bind(std::shared_ptr<SharedDeviceInput> input, std::vector<int> deviceChannels)
+    {
+        auto current = binding.load();
+        if (current && current->input == input && current->channels == deviceChannels)
+            return;
+
+        if (!current || current->input != input)
+            needsAlign.store(true, std::memory_order_release);
+
+        binding.store(std::make_shared<const Binding>(Binding{std::move(input), std::move(deviceChannels)}));
+    }
+
+    // Client audio thread. dest[i] receives the i-th bound channel; returns false, leaving dest
+    // untouched, if unbound.
+    bool read(float* const* dest, int numChannels, int numSamples, double sampleRate)
+    {
+        const auto current = binding.load();
+        if (!current || !current->input)
+            return false;
+
+        numChannels = std::min(numChannels, static_cast<int>(current->channels.size()));
+        const bool align = needsAlign.exchange(false, std::memory_order_acq_rel);
+        return current->input
+            ->read(position, align, dest, current->channels.data(), numChannels, numSamples, sampleRate);
+    }
+
+    // Drops whatever is queued for this client and rejoins the other clients at the current block
+    void realign()
+    {
+        needsAlign.store(true, std::memory_order_release);
+    }
+
+    SyncBufferStats getStats() const
+    {
+        const auto current = binding.load();
+        return current && current->input ? current->input->getStats() : SyncBufferStats{};
+    }
+
+private:
+    struct Binding
+    {
+        std::shared_ptr<SharedDeviceInput> input;
+        std::vector<int> channels;
+    };
+
+    AtomicSharedPtr<const Binding> binding;
+    std::atomic<bool> needsAlign{true};
+    SharedDeviceInput::ReadPosition position; // client audio thread only
+};
+
+// One client's view of a device's SharedDeviceOutput. Rebinding takes the mix lock the writes
+// take, so a write never lands in a mix its client has left.
+class DeviceOutputTap
+{
+public:
+    DeviceOutputTap() = default;
+
+    ~DeviceOutputTap()
+    {
+        bind(nullptr);
+    }
+
+    DeviceOutputTap(const DeviceOutputTap&) = delete;
+    DeviceOutputTap& operator=(const DeviceOutputTap&) = delete;
+
+    // Not on the audio thread
+    void bind(std::shared_ptr<SharedDeviceOutput> output)
+    {
+        auto current = binding.load();
+        if (current == output)
+            return;
+
+        if (current)
+            current->detach(writer);
+        if (output)
+            output->attach(writer);
+        binding.store(std::move(output));
+    }
+
+    // Client audio thread. src[ch] is device channel ch; returns false if unbound.
+    bool write(const float* const* src, int numChannels, int numSamples, double sampleRate)
+    {
+        const auto current = binding.load();
+        if (!current)
+            return false;
+
+        const bool rejoin = needsRejoin.exchange(false, std::memory_order_acq_rel);
+        return current->add(writer, rejoin, src, numChannels, numSamples, sampleRate);
+    }
+
+    // The next write joins the mix as if new to it
+    void realign()
+    {
+        needsRejoin.store(true, std::memory_order_release);
+    }
+
+    SyncBufferStats getStats() const
+    {
+        const auto current = binding.load();
+        return current ? current->getStats() : SyncBufferStats{};
+    }
+
+private:
+    AtomicSharedPtr<SharedDeviceOutput> binding;
+    std::atomic<bool> needsRejoin{false};
+    SharedDeviceOutput::Writer writer;
+};
+
+} // namespace atk
@@ -0,0 +1,692 @@
+#include "VirtualAudioDevices.h"
+#include <atkaudio/atkaudio.h>
+#include <atkaudio/Logging.h>
+
+#include <juce_audio_formats/juce_audio_formats.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <utility>
+
+namespace atk
+{
+
+namespace
+{
+constexpr int kSettingsVersion = 1;
+constexpr int kStopTimeoutMs = 2000;
+constexpr int kRecordBufferSamples = 1 << 16;
+// Falling further behind than this restarts the schedule instead of catching up with a burst
+constexpr int kMaxLateBlocks = 4;
+
+int64_t steadyNowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+juce::StringArray makeChannelNames(const juce::String& prefix, int numChannels)
+{
+    juce::StringArray names;
+    for (int ch = 0; ch < numChannels; ++ch)
+        names.add(prefix + " " + juce::String(ch + 1));
+    return names;
+}
+
+juce::BigInteger limitChannels(const juce::BigInteger& requested, int numChannels)
+{
+    juce::BigInteger active = requested;
+    active.setRange(numChannels, juce::jmax(0, active.getHighestBit() + 1 - numChannels), false);
+    return active;
+}
+} // namespace
+
+//==============================================================================
+class VirtualAudioIODevice
+    : public juce::AudioIODevice
+    , private juce::Thread
+{
+public:
+    VirtualAudioIODevice(
+        const juce::String& deviceName,
+        const juce::String& typeName,
+        const VirtualDeviceConfig& deviceConfig,
+        std::shared_ptr<std::atomic<double>> deviceDriftPpm
+    )
+        : juce::AudioIODevice(deviceName, typeName)
+        , juce::Thread("atk VirtualAudioIODevice")
+        , config(deviceConfig)
+        , driftPpm(std::move(deviceDriftPpm))
+    {
+        config.numInputChannels = juce::jmax(0, config.numInputChannels);
+        config.numOutputChannels = juce::jmax(0, config.numOutputChannels);
+        config.blockSize = juce::jmax(1, config.blockSize);
+        if (config.sampleRate <= 0.0)
+            config.sampleRate = 48000.0;
+        currentSampleRate = config.sampleRate;
+        currentBufferSize = config.blockSize;
+    }
+
+    ~VirtualAudioIODevice() override
+    {
+        close();
+    }
+
+    juce::StringArray getOutputChannelNames() override
+    {
+        return makeChannelNames("Output", config.numOutputChannels);
+    }
+
+    juce::StringArray getInputChannelNames() override
+    {
+        return makeChannelNames("Input", config.numInputChannels);
+    }
+
+    juce::Array<double> getAvailableSampleRates() override
+    {
+        juce::Array<double> rates{44100.0, 48000.0, 88200.0, 96000.0};
+        rates.addIfNotAlreadyThere(config.sampleRate);
+        std::sort(rates.begin(), rates.end());
+        return rates;
+    }
+
+    juce::Array<int> getAvailableBufferSizes() override
+    {
+        juce::Array<int> sizes{32, 64, 128, 256, 480, 512, 1024, 2048};
+        sizes.addIfNotAlreadyThere(config.blockSize);
+        std::sort(sizes.begin(), sizes.end());
+        return sizes;
+    }
+
+    int getDefaultBufferSize() override
+    {
+        return config.blockSize;
+    }
+
+    juce::String open(
+        const juce::BigInteger& inputChannels,
+        const juce::BigInteger& outputChannels,
+        double sampleRate,
+        int bufferSizeSamples
+    ) override
+    {
+        close();
+
+        currentSampleRate = sampleRate > 0.0 ? sampleRate : config.sampleRate;
+        currentBufferSize = bufferSizeSamples > 0 ? bufferSizeSamples : config.blockSize;
+        activeInputs = limitChannels(inputChannels, config.numInputChannels);
+        activeOutputs = limitChannels(outputChannels, config.numOutputChannels);
+
+        const int numInputs = activeInputs.countNumberOfSetBits();
+        const int numOutputs = activeOutputs.countNumberOfSetBits();
+        inputBuffer.setSize(juce::jmax(1, numInputs), currentBufferSize);
+        outputBuffer.setSize(juce::jmax(1, numOutputs), currentBufferSize);
+        loopbackBuffer.setSize(juce::jmax(1, numOutputs), currentBufferSize);
+        loopbackBuffer.clear();
+        inputPointers.resize(static_cast<size_t>(numInputs));
+        outputPointers.resize(static_cast<size_t>(numOutputs));
+
+        if (auto error = openFiles(numOutputs); error.isNotEmpty())
+        {
+            lastError = error;
+            return error;
+        }
+
+        lastError.clear();
+        deviceOpen = true;
+        return {};
+    }
+
+    void close() override
+    {
+        stop();
+
+        if (recordWriter != nullptr)
+        {
+            recordWriter.reset();
+            writerThread.stopThread(kStopTimeoutMs);
+        }
+        playBuffer.setSize(0, 0);
+        deviceOpen = false;
+    }
+
+    bool isOpen() override
+    {
+        return deviceOpen;
+    }
+
+    void start(juce::AudioIODeviceCallback* newCallback) override
+    {
+        if (!deviceOpen || newCallback == nullptr)
+            return;
+
+        stop();
+        newCallback->audioDeviceAboutToStart(this);
+        {
+            const juce::ScopedLock sl(callbackLock);
+            callback = newCallback;
+        }
+        startThread(juce::Thread::Priority::highest);
+    }
+
+    void stop() override
+    {
+        juce::AudioIODeviceCallback* oldCallback = nullptr;
+        {
+            const juce::ScopedLock sl(callbackLock);
+            oldCallback = std::exchange(callback, nullptr);
+        }
+
+        signalThreadShouldExit();
+        notify();
+        stopThread(kStopTimeoutMs);
+
+        if (oldCallback != nullptr)
+            oldCallback->audioDeviceStopped();
+    }
+
+    bool isPlaying() override
+    {
+        return isThreadRunning();
+    }
+
+    juce::String getLastError() override
+    {
+        return lastError;
+    }
+
+    int getCurrentBufferSizeSamples() override
+    {
+        return currentBufferSize;
+    }
+
+    double getCurrentSampleRate() override
+    {
+        return currentSampleRate;
+    }
+
+    int getCurrentBitDepth() override
+    {
+        return 32;
+    }
+
+    juce::BigInteger getActiveOutputChannels() const override
+    {
+        return activeOutputs;
+    }
+
+    juce::BigInteger getActiveInputChannels() const override
+    {
+        return activeInputs;
+    }
+
+    int getOutputLatencyInSamples() override
+    {
+        return 0;
+    }
+
+    int getInputLatencyInSamples() override
+    {
+        // Loopback hands the outputs back one block later
+        return config.loopback ? currentBufferSize : 0;
+    }
+
+private:
+    juce::String openFiles(int numOutputs)
+    {
+        if (config.playFile != juce::File())
+        {
+            juce::AudioFormatManager formatManager;
+            formatManager.registerBasicFormats();
+            std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(config.playFile));
+            if (reader == nullptr)
+                return "cannot read " + config.playFile.getFullPathName();
+
+            if (!juce::approximatelyEqual(reader->sampleRate, currentSampleRate))
+                atk::logging::warning(
+                    "VirtualAudioIODevice::open",
+                    config.playFile.getFileName() + " is played at the device rate, not its own"
+                );
+
+            const auto length = static_cast<int>(juce::jmin<juce::int64>(reader->lengthInSamples, 1 << 28));
+            playBuffer.setSize(static_cast<int>(reader->numChannels), length);
+            reader->read(&playBuffer, 0, length, 0, true, true);
+            playPosition = 0;
+        }
+
+        if (config.recordFile != juce::File() && numOutputs > 0)
+        {
+            config.recordFile.deleteFile();
+            auto stream = std::make_unique<juce::FileOutputStream>(config.recordFile);
+            if (stream->failedToOpen())
+                return "cannot write " + config.recordFile.getFullPathName();
+
+            juce::WavAudioFormat wav;
+            std::unique_ptr<juce::AudioFormatWriter> writer(
+                wav.createWriterFor(stream.get(), currentSampleRate, static_cast<unsigned int>(numOutputs), 32, {}, 0)
+            );
+            if (writer == nullptr)
+                return "cannot record to " + config.recordFile.getFullPathName();
+
+            stream.release(); // owned by the writer now
+            writerThread.startThread();
+            recordWriter =
+                std::make_unique<juce::AudioFormatWriter::ThreadedWriter>(writer.release(), writerThread, kRecordBufferSamples);
+        }
+
+        return {};
+    }
+
+    void fillInputs(int numSamples)
+    {
+        const int numInputs = static_cast<int>(inputPointers.size());
+        for (int ch = 0; ch < numInputs; ++ch)
+        {
+            float* dest = inputBuffer.getWritePointer(ch);
+            inputPointers[static_cast<size_t>(ch)] = dest;
+
+            if (config.loopback && ch < static_cast<int>(outputPointers.size()))
+            {
+                juce::FloatVectorOperations::copy(dest, loopbackBuffer.getReadPointer(ch), numSamples);
+            }
+            else if (playBuffer.getNumSamples() > 0 && playBuffer.getNumChannels() > 0)
+            {
+                // Files with fewer channels repeat theirs across the inputs
+                const float* src = playBuffer.getReadPointer(ch % playBuffer.getNumChannels());
+                int position = playPosition;
+                for (int done = 0; done < numSamples;)
+                {
+                    const int chunk = juce::jmin(numSamples - done, playBuffer.getNumSamples() - position);
+                    juce::FloatVectorOperations::copy(dest + done, src + position, chunk);
+                    done += chunk;
+                    position = (position + chunk) % playBuffer.getNumSamples();
+                }
+            }
+            else
+            {
+                juce::FloatVectorOperations::clear(dest, numSamples);
+            }
+        }
+
+        if (playBuffer.getNumSamples() > 0)
+            playPosition = (playPosition + numSamples) % playBuffer.getNumSamples();
+    }
+
+    void processBlock(int64_t hostTimeNs)
+    {
+        const int numSamples = currentBufferSize;
+        fillInputs(numSamples);
+
+        for (size_t ch = 0; ch < outputPointers.size(); ++ch)
+            outputPointers[ch] = outputBuffer.getWritePointer(static_cast<int>(ch));
+
+        {
+            const juce::ScopedLock sl(callbackLock);
+            if (callback == nullptr)
+                return;
+
+            const auto hostTime = static_cast<uint64_t>(hostTimeNs);
+            juce::AudioIODeviceCallbackContext context;
+            context.hostTimeNs = &hostTime;
+            callback->audioDeviceIOCallbackWithContext(
+                inputPointers.data(),
+                static_cast<int>(inputPointers.size()),
+                outputPointers.data(),
+                static_cast<int>(outputPointers.size()),
+                numSamples,
+                context
+            );
+        }
+
+        if (config.loopback)
+            for (size_t ch = 0; ch < outputPointers.size(); ++ch)
+                loopbackBuffer.copyFrom(static_cast<int>(ch), 0, outputBuffer, static_cast<int>(ch), 0, numSamples);
+
+        // Dropped rather than waited for if the disk falls behind
+        if (recordWriter != nullptr)
+            recordWriter->write(outputBuffer.getArrayOfReadPointers(), numSamples);
+    }
+
+    // Sleeps in the kernel until shortly before the target, then yields the rest for accuracy
+    void waitUntil(int64_t targetNs)
+    {
+        for (;;)
+        {
+            const int64_t remaining = targetNs - steadyNowNs();
+            if (remaining <= 0 || threadShouldExit())
+                return;
+
+            if (remaining > 2'000'000)
+                wait(static_cast<double>(remaining - 1'000'000) / 1.0e6);
+            else
+                std::this_thread::yield();
+        }
+    }
+
+    void run() override
+    {
+        int64_t nextBlockNs = steadyNowNs();
+
+        while (!threadShouldExit())
+        {
+            const double drift = driftPpm != nullptr ? driftPpm->load(std::memory_order_relaxed) : 0.0;
+            const double actualRate = currentSampleRate * (1.0 + drift * 1.0e-6);
+            const auto periodNs = static_cast<int64_t>(currentBufferSize * 1.0e9 / actualRate);
+
+            if (!config.freeRunning)
+            {
+                waitUntil(nextBlockNs);
+                if (threadShouldExit())
+                    break;
+            }
+
+            const int64_t now = steadyNowNs();
+            processBlock(now);
+
+            nextBlockNs += periodNs;
+            if (now - nextBlockNs > kMaxLateBlocks * periodNs)
+                nextBlockNs = now + periodNs;
+        }
+    }
+
+    VirtualDeviceConfig config;
+    std::shared_ptr<std::atomic<double>> driftPpm;
+
+    double currentSampleRate = 48000.0;
+    int currentBufferSize = 512;
+    juce::BigInteger activeInputs;
+    juce::BigInteger activeOutputs;
+    bool deviceOpen = false;
+    juce::String lastError;
+
+    juce::CriticalSection callbackLock;
+    juce::AudioIODeviceCallback* callback = nullptr;
+
+    juce::AudioBuffer<float> inputBuffer;
+    juce::AudioBuffer<float> outputBuffer;
+    juce::AudioBuffer<float> loopbackBuffer;
+    std::vector<const float*> inputPointers;
+    std::vector<float*> outputPointers;
+
+    juce::AudioBuffer<float> playBuffer;
+    int playPosition = 0;
+    juce::TimeSliceThread writerThread{"atk VirtualAudioIODevice writer"};
+    std::unique_ptr<juce::AudioFormatWriter::ThreadedWriter> recordWriter;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(VirtualAudioIODevice)
+};
+
+//==============================================================================
+class VirtualAudioDeviceType : public juce::AudioIODeviceType
+{
+public:
+    explicit VirtualAudioDeviceType(const juce::String& typeName)
+        : juce::AudioIODeviceType(typeName)
+    {
+    }
+
+    void scanForDevices() override
+    {
+    }
+
+    juce::StringArray getDeviceNames(bool wantInputNames) const override
+    {
+        return VirtualAudioDevices::getInstance()->getDeviceNames(getTypeName(), wantInputNames);
+    }
+
+    int getDefaultDeviceIndex(bool /*forInput*/) const override
+    {
+        return 0;
+    }
+
+    int getIndexOfDevice(juce::AudioIODevice* device, bool asInput) const override
+    {
+        return device != nullptr ? getDeviceNames(asInput).indexOf(device->getName()) : -1;
+    }
+
+    bool hasSeparateInputsAndOutputs() const override
+    {
+        return false;
+    }
+
+    juce::AudioIODevice*
+    createDevice(const juce::String& outputDeviceName, const juce::String& inputDeviceName) override
+    {
+        const auto& deviceName = outputDeviceName.isNotEmpty() ? outputDeviceName : inputDeviceName;
+
+        VirtualDeviceConfig config;
+        std::shared_ptr<std::atomic<double>> driftPpm;
+        if (!VirtualAudioDevices::getInstance()->getDevice(getTypeName(), deviceName, config, driftPpm))
+            return nullptr;
+
+        return new VirtualAudioIODevice(deviceName, getTypeName(), config, std::move(driftPpm));
+    }
+};
+
+//==============================================================================
+JUCE_IMPLEMENT_SINGLETON(VirtualAudioDevices)
+
+VirtualAudioDevices::VirtualAudioDevices()
+{
+    loadFromDisk();
+
+    // Back after a restart even if it was removed; saved only once it is changed
+    const juce::ScopedLock sl(lock);
+    const bool hasDefault = std::any_of(
+        entries.begin(),
+        entries.end(),
+        [](const Entry& entry)
+        { return entry.typeName == NULL_TYPE_NAME && entry.deviceName == DEFAULT_NULL_DEVICE_NAME; }
+    );
+    if (!hasDefault)
+        entries.push_back({NULL_TYPE_NAME, DEFAULT_NULL_DEVICE_NAME, {}, std::make_shared<std::atomic<double>>(0.0)});
+}
+
+VirtualAudioDevices::~VirtualAudioDevices()
+{
+    clearSingletonInstance();
+}
+
+void VirtualAudioDevices::setDevice(
+    const juce::String& typeName,
+    const juce::String& deviceName,
+    const VirtualDeviceConfig& config
+)
+{
+    jassert(typeName == NULL_TYPE_NAME || typeName == FILE_TYPE_NAME);
+    {
+        const juce::ScopedLock sl(lock);
+        bool found = false;
+        for (auto& entry : entries)
+        {
+            if (entry.typeName == typeName && entry.deviceName == deviceName)
+            {
+                found = true;
+                entry.config = config;
+                entry.driftPpm->store(config.driftPpm, std::memory_order_relaxed);
+                break;
+            }
+        }
+
+        if (!found)
+            entries.push_back({typeName, deviceName, config, std::make_shared<std::atomic<double>>(config.driftPpm)});
+        saveToDisk();
+    }
+    sendChangeMessage();
+}
+
+void VirtualAudioDevices::removeDevice(const juce::String& typeName, const juce::String& deviceName)
+{
+    {
+        const juce::ScopedLock sl(lock);
+        const auto it = std::find_if(
+            entries.begin(),
+            entries.end(),
+            [&](const Entry& entry) { return entry.typeName == typeName && entry.deviceName == deviceName; }
+        );
+        if (it == entries.end())
+            return;
+        entries.erase(it);
+        saveToDisk();
+    }
+    sendChangeMessage();
+}
+
+void VirtualAudioDevices::setDrift(const juce::String& typeName, const juce::String& deviceName, double driftPpm)
+{
+    const juce::ScopedLock sl(lock);
+    for (auto& entry : entries)
+    {
+        if (entry.typeName == typeName && entry.deviceName == deviceName)
+        {
+            entry.config.driftPpm = driftPpm;
+            entry.driftPpm->store(driftPpm, std::memory_order_relaxed);
+            saveToDisk();
+        }
+    }
+}
+
+juce::StringArray VirtualAudioDevices::getDeviceNames(const juce::String& typeName, bool isInput) const
+{
+    const juce::ScopedLock sl(lock);
+    juce::StringArray names;
+    for (const auto& entry : entries)
+        if (entry.typeName == typeName && (isInput ? entry.config.numInputChannels : entry.config.numOutputChannels) > 0)
+            names.add(entry.deviceName);
+    return names;
+}
+
+juce::StringArray VirtualAudioDevices::getAllDeviceNames(const juce::String& typeName) const
+{
+    const juce::ScopedLock sl(lock);
+    juce::StringArray names;
+    for (const auto& entry : entries)
+        if (entry.typeName == typeName)
+            names.add(entry.deviceName);
+    return names;
+}
+
+bool VirtualAudioDevices::getConfig(
+    const juce::String& typeName,
+    const juce::String& deviceName,
+    VirtualDeviceConfig& config
+) const
+{
+    std::shared_ptr<std::atomic<double>> driftPpm;
+    return getDevice(typeName, deviceName, config, driftPpm);
+}
+
+bool VirtualAudioDevices::getDevice(
+    const juce::String& typeName,
+    const juce::String& deviceName,
+    VirtualDeviceConfig& config,
+    std::shared_ptr<std::atomic<double>>& driftPpm
+) const
+{
+    const juce::ScopedLock sl(lock);
+    for (const auto& entry : entries)
+    {
+        if (entry.typeName == typeName && entry.deviceName == deviceName)
+        {
+            config = entry.config;
+            driftPpm = entry.driftPpm;
+            return true;
+        }
+    }
+    return false;
+}
+
+void VirtualAudioDevices::addDeviceTypes(juce::AudioDeviceManager& manager)
+{
+    // Creates the manager's own types first; it only does so while it has none
+    const auto& types = manager.getAvailableDeviceTypes();
+
+    for (const char* typeName : {NULL_TYPE_NAME, FILE_TYPE_NAME})
+    {
+        const bool present = std::any_of(
+            types.begin(),
+            types.end(),
+            [typeName](const juce::AudioIODeviceType* type) { return type->getTypeName() == typeName; }
+        );
+        if (!present)
+            manager.addAudioDeviceType(std::make_unique<VirtualAudioDeviceType>(typeName));
+    }
+}
+
+juce::File VirtualAudioDevices::getSettingsFile()
+{
+    return atk::getSettingsFile("atkAudio Virtual Devices");
+}
+
+void VirtualAudioDevices::loadFromDisk()
+{
+    const auto file = getSettingsFile();
+    if (!file.existsAsFile())
+        return;
+
+    auto root = juce::XmlDocument::parse(file);
+    if (root == nullptr
+        || !root->hasTagName("VIRTUAL_DEVICES")
+        || root->getIntAttribute("version") != kSettingsVersion)
+    {
+        atk::logging::warning("VirtualAudioDevices::loadFromDisk", "ignoring unreadable " + file.getFullPathName());
+        return;
+    }
+
+    const VirtualDeviceConfig defaults;
+    const juce::ScopedLock sl(lock);
+    for (auto* element : root->getChildWithTagNameIterator("DEVICE"))
+    {
+        const auto typeName = element->getStringAttribute("type");
+        const auto deviceName = element->getStringAttribute("name");
+        if ((typeName != NULL_TYPE_NAME && typeName != FILE_TYPE_NAME) || deviceName.isEmpty())
+            continue;
+
+        VirtualDeviceConfig config;
+        config.sampleRate = element->getDoubleAttribute("sampleRate", defaults.sampleRate);
+        config.blockSize = element->getIntAttribute("blockSize", defaults.blockSize);
+        config.numInputChannels = element->getIntAttribute("inputs", defaults.numInputChannels);
+        config.numOutputChannels = element->getIntAttribute("outputs", defaults.numOutputChannels);
+        config.driftPpm = element->getDoubleAttribute("driftPpm", defaults.driftPpm);
+        config.freeRunning = element->getBoolAttribute("freeRunning", defaults.freeRunning);
+        config.loopback = element->getBoolAttribute("loopback", defaults.loopback);
+        if (const auto path = element->getStringAttribute("playFile"); juce::File::isAbsolutePath(path))
+            config.playFile = juce::File(path);
+        if (const auto path = element->getStringAttribute("recordFile"); juce::File::isAbsolutePath(path))
+            config.recordFile = juce::File(path);
+        if (config.sampleRate <= 0.0 || config.blockSize <= 0)
+            continue;
+
+        entries.push_back({typeName, deviceName, config, std::make_shared<std::atomic<double>>(config.driftPpm)});
+    }
+}
+
+void VirtualAudioDevices::saveToDisk() const
+{
+    juce::XmlElement root("VIRTUAL_DEVICES");
+    root.setAttribute("version", kSettingsVersion);
+
+    for (const auto& entry : entries)
+    {
+        auto* element = root.createNewChildElement("DEVICE");
+        element->setAttribute("type", entry.typeName);
+        element->setAttribute("name", entry.deviceName);
+        element->setAttribute("sampleRate", entry.config.sampleRate);
+        element->setAttribute("blockSize", entry.config.blockSize);
+        element->setAttribute("inputs", entry.config.numInputChannels);
+        element->setAttribute("outputs", entry.config.numOutputChannels);
+        element->setAttribute("driftPpm", entry.config.driftPpm);
+        element->setAttribute("freeRunning", entry.config.freeRunning);
+        element->setAttribute("loopback", entry.config.loopback);
+        element->setAttribute("playFile", entry.config.playFile.getFullPathName());
+        element->setAttribute("recordFile", entry.config.recordFile.getFullPathName());
+    }
+
+    const auto file = getSettingsFile();
+    file.getParentDirectory().createDirectory();
+    if (!root.writeTo(file))
+        atk::logging::warning("VirtualAudioDevices::saveToDisk", "could not write " + file.getFullPathName());
+}
+
+} // namespace atk
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <juce_audio_devices/juce_audio_devices.h>
+#include <juce_events/juce_events.h>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace atk
+{
+
+struct VirtualDeviceConfig
+{
+    double sampleRate = 48000.0;
+    int blockSize = 512;
+    int numInputChannels = 2;
+    int numOutputChannels = 2;
+
+    // How much faster (positive) or slower than sampleRate the device clock runs. Can be changed
+    // while the device is open.
+    double driftPpm = 0.0;
+
+    // Run callbacks back to back instead of in real time, for throughput tests
+    bool freeRunning = false;
+
+    // Null devices: inputs receive the outputs one block later
+    bool loopback = false;
+
+    // File devices: WAV looped into the inputs (read into memory when opened and played at the device rate),
+    // and a 32-bit float WAV the outputs are recorded to. Either may be left empty.
+    juce::File playFile;
+    juce::File recordFile;
+};
+
+// Audio devices without hardware behind them, so that AudioServer, its clients and the routing UI
+// can run on a machine without a sound card. A "Null" device runs its callback from a timer thread
+// at the configured rate, block size and channel count; a "File" device does the same while
+// playing a WAV file into its inputs and recording its outputs to another.
+//
+// The devices live here and are listed by the two device types that addDeviceTypes() adds to an
+// AudioDeviceManager. AudioServer adds them to every manager it creates, so they are scanned,
+// opened and routed like any other device. One Null device is there from the start.
+//
+// The devices are kept in a settings file and edited in the AudioServer settings. A
+// ChangeBroadcaster: listeners hear on the message thread when devices are added or removed.
+class VirtualAudioDevices
+    : public juce::ChangeBroadcaster
+    , public juce::DeletedAtShutdown
+{
+public:
+    static constexpr const char* NULL_TYPE_NAME = "Null";
+    static constexpr const char* FILE_TYPE_NAME = "File";
+    static constexpr const char* DEFAULT_NULL_DEVICE_NAME = "Null Device";
+
+    JUCE_DECLARE_SINGLETON(VirtualAudioDevices, false)
+    ~VirtualAudioDevices() override;
+
+    // Adds or replaces a device and saves the list. An open device keeps its settings apart from
+    // driftPpm, which it picks up at once; the rest applies when it is next opened.
+    void setDevice(const juce::String& typeName, const juce::String& deviceName, const VirtualDeviceConfig& config);
+    void removeDevice(const juce::String& typeName, const juce::String& deviceName);
+    void setDrift(const juce::String& typeName, const juce::String& deviceName, double driftPpm);
+
+    juce::StringArray getDeviceNames(const juce::String& typeName, bool isInput) const;
+    // Every device of the type, with or without channels in either direction
+    juce::StringArray getAllDeviceNames(const juce::String& typeName) const;
+    // False if there is no such device
+    bool getConfig(const juce::String& typeName, const juce::String& deviceName, VirtualDeviceConfig& config) const;
+
+    // Adds the Null and File types after the manager's own, unless it has them already
+    static void addDeviceTypes(juce::AudioDeviceManager& manager);
+
+private:
+    VirtualAudioDevices();
+
+    friend class VirtualAudioDeviceType;
+
+    struct Entry
+    {
+        juce::String typeName;
+        juce::String deviceName;
+        VirtualDeviceConfig config;
+        std::shared_ptr<std::atomic<double>> driftPpm; // shared with the device while it is open
+    };
+
+    // False if there is no such device
+    bool getDevice(
+        const juce::String& typeName,
+        const juce::String& deviceName,
+        VirtualDeviceConfig& config,
+        std::shared_ptr<std::atomic<double>>& driftPpm
+    ) const;
+
+    void loadFromDisk();
+    void saveToDisk() const;
+    static juce::File getSettingsFile();
+
+    mutable juce::CriticalSection lock;
+    std::vector<Entry> entries;
+};
+
+} // namespace atk
@@ -8,6 +8,9 @@
 
 #include <atkaudio/ModuleInfrastructure/MidiServer/MidiServerSettingsComponent.h>
 
+// Worker caps offered in Options > Thread Pool Worker Limit, besides "Unlimited"
+static constexpr int workerLimitChoices[] = {1, 2, 4, 8};
+
 class MainHostWindow::PluginListWindow final : public juce::DocumentWindow
 {
 public:
@@ -167,6 +170,9 @@ MainHostWindow::MainHostWindow(juce::AudioDeviceManager& deviceManagerIn)
         KnownPluginList::sortByManufacturer
     );
 
+    if (audioServer)
+        audioServer->setParallelDirectCallbacks(getAppProperties().getBoolValue("parallelDirectCallbacks", false));
+
     knownPluginList.addChangeListener(this);
 
     addKeyListener(getCommandManager().getKeyMappings());
@@ -415,6 +421,40 @@ PopupMenu MainHostWindow::getMenuForIndex(int topLevelMenuIndex, const String& /
         );
         menu.addSubMenu("Plug-in Menu Type", sortTypeMenu);
 
+        if (graphHolder != nullptr && graphHolder->graph != nullptr)
+        {
+            const auto& graph = graphHolder->graph->graph;
+
+            // Decides how this host competes with other plugin hosts for the shared thread pool
+            const auto priority = graph.getSchedulingPriority();
+            PopupMenu priorityMenu;
+            priorityMenu.addItem(210, "Critical", true, priority == atk::TaskGraphPriority::Critical);
+            priorityMenu.addItem(211, "Normal", true, priority == atk::TaskGraphPriority::Normal);
+            priorityMenu.addItem(212, "Background", true, priority == atk::TaskGraphPriority::Background);
+            menu.addSubMenu("Thread Pool Priority", priorityMenu);
+
+            const int maxWorkers = graph.getMaxWorkers();
+            PopupMenu workerLimitMenu;
+            workerLimitMenu.addItem(220, "Unlimited", true, maxWorkers == 0);
+            for (int i = 0; i < numElementsInArray(workerLimitChoices); ++i)
+                workerLimitMenu.addItem(
+                    221 + i,
+                    String(workerLimitChoices[i]),
+                    true,
+                    maxWorkers == workerLimitChoices[i]
+                );
+            menu.addSubMenu("Thread Pool Worker Limit", workerLimitMenu);
+        }
+
+        // Lets several hosts on one Audio Server device process at the same time
+        if (audioServer)
+            menu.addItem(
+                230,
+                "Run Audio Server Hosts in Parallel",
+                true,
+                audioServer->isParallelDirectCallbacksEnabled()
+            );
+
         menu.addSeparator();
         menu.addCommandItem(&getCommandManager(), CommandIDs::showAudioSettings);
         menu.addCommandItem(&getCommandManager(), CommandIDs::showMidiSettings);
@@ -481,6 +521,37 @@ void MainHostWindow::menuItemSelected(int menuItemID, int /*topLevelMenuIndex*/)
 
         menuItemsChanged();
     }
+    else if (menuItemID >= 210 && menuItemID < 230)
+    {
+        if (graphHolder == nullptr || graphHolder->graph == nullptr)
+            return;
+
+        auto& graph = graphHolder->graph->graph;
+
+        if (menuItemID == 210)
+            graph.setSchedulingPriority(atk::TaskGraphPriority::Critical);
+        else if (menuItemID == 211)
+            graph.setSchedulingPriority(atk::TaskGraphPriority::Normal);
+        else if (menuItemID == 212)
+            graph.setSchedulingPriority(atk::TaskGraphPriority::Background);
+        else if (menuItemID == 220)
+            graph.setMaxWorkers(0);
+        else if (menuItemID - 221 < numElementsInArray(workerLimitChoices))
+            graph.setMaxWorkers(workerLimitChoices[menuItemID - 221]);
+
+        menuItemsChanged();
+    }
+    else if (menuItemID == 230)
+    {
+        if (audioServer == nullptr)
+            return;
+
+        const bool enabled = !audioServer->isParallelDirectCallbacksEnabled();
+        audioServer->setParallelDirectCallbacks(enabled);
+        getAppProperties().setValue("parallelDirectCallbacks", enabled);
+
+        menuItemsChanged();
+    }
     else
     {
         if (const auto chosen = getChosenType(menuItemID))
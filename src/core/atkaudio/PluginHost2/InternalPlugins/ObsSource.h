@@ -298,6 +298,12 @@ public:
         return currentObsSource;
     }
 
+    // Health of the OBS source -> graph bridge; lock-free
+    atk::SyncBufferStats getSyncBufferStats() const
+    {
+        return syncBuffer.getStats();
+    }
+
 private:
     static void frontendEventCallback(enum obs_frontend_event event, void* private_data)
     {
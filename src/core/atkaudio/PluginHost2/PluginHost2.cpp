@@ -186,6 +186,28 @@ private:
     mutable float peakCpuLoad = 0.0f;
     mutable double peakCpuTime = 0.0;
 };
+
+static juce::String schedulingPriorityToString(TaskGraphPriority priority)
+{
+    switch (priority) {
+    case TaskGraphPriority::Critical:
+        return "critical";
+    case TaskGraphPriority::Background:
+        return "background";
+    case TaskGraphPriority::Normal:
+        break;
+    }
+    return "normal";
+}
+
+static TaskGraphPriority schedulingPriorityFromString(const juce::String& s)
+{
+    if (s == "critical")
+        return TaskGraphPriority::Critical;
+    if (s == "background")
+        return TaskGraphPriority::Background;
+    return TaskGraphPriority::Normal;
+}
 } // namespace atk
 
 atk::PluginHost2::PluginHost2()
@@ -300,6 +322,18 @@ void atk::PluginHost2::handleAsyncUpdate()
     if (filterGraph != nullptr)
         graphModel->restoreFromXml(*filterGraph);
 
+    // Older states have no SCHEDULING element and keep the defaults
+    auto& graph = graphModel->graph;
+    if (auto* scheduling = xml->getChildByName("SCHEDULING")) {
+        graph.setSchedulingPriority(
+            atk::schedulingPriorityFromString(scheduling->getStringAttribute("priority", "normal"))
+        );
+        graph.setMaxWorkers(scheduling->getIntAttribute("maxWorkers", 0));
+    } else {
+        graph.setSchedulingPriority(atk::TaskGraphPriority::Normal);
+        graph.setMaxWorkers(0);
+    }
+
     auto* audioServerElement = xml->getChildByName("AUDIOSERVER");
     if (audioServerElement) {
         auto* audioServer = atk::AudioServer::getInstance();
@@ -391,6 +425,14 @@ void atk::PluginHost2::getState(std::string& s)
     if (auto filterGraph = graphModel->createXml())
         xml.addChildElement(filterGraph.release());
 
+    auto* schedulingElement = new juce::XmlElement("SCHEDULING");
+    schedulingElement->setAttribute(
+        "priority",
+        atk::schedulingPriorityToString(graphModel->graph.getSchedulingPriority())
+    );
+    schedulingElement->setAttribute("maxWorkers", graphModel->graph.getMaxWorkers());
+    xml.addChildElement(schedulingElement);
+
     auto midiState = moduleDeviceManager->getMidiClient().getSubscriptions();
     auto* midiElement = new juce::XmlElement("MIDISTATE");
     midiElement->setAttribute("state", midiState.serialize());
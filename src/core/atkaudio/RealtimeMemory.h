@@ -0,0 +1,302 @@
+// Copyright (c) 2025 atkAudio
+// Memory locking / prefaulting for realtime buffers and audio thread page-fault accounting
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+namespace atk::rtmemory
+{
+
+// Optional mode (default off). Buffers allocated while enabled are prefaulted and locked into RAM.
+inline std::atomic<bool> lockingEnabled{false};
+
+// Set once mlock/VirtualLock has failed; later requests only prefault.
+inline std::atomic<bool> lockingUnavailable{false};
+
+inline std::atomic<int64_t> lockedBytes{0};
+
+// Accumulated page faults taken by audio threads since they called samplePageFaults() first.
+inline std::atomic<uint64_t> audioThreadMinorFaults{0};
+inline std::atomic<uint64_t> audioThreadMajorFaults{0};
+
+inline bool isLockingEnabled() noexcept
+{
+    return lockingEnabled.load(std::memory_order_relaxed);
+}
+
+inline void setLockingEnabled(bool enabled) noexcept
+{
+    lockingEnabled.store(enabled, std::memory_order_relaxed);
+    if (enabled)
+        lockingUnavailable.store(false, std::memory_order_relaxed);
+}
+
+inline bool isLockingAvailable() noexcept
+{
+    return !lockingUnavailable.load(std::memory_order_relaxed);
+}
+
+inline int64_t getLockedBytes() noexcept
+{
+    return lockedBytes.load(std::memory_order_relaxed);
+}
+
+inline size_t getPageSize() noexcept
+{
+    static const size_t pageSize = []
+    {
+#ifdef _WIN32
+        SYSTEM_INFO info{};
+        GetSystemInfo(&info);
+        return static_cast<size_t>(info.dwPageSize);
+#else
+        const long size = sysconf(_SC_PAGESIZE);
+        return size > 0 ? static_cast<size_t>(size) : static_cast<size_t>(4096);
+#endif
+    }();
+    return pageSize;
+}
+
+// Touches one byte per page so the kernel maps the whole range now instead of on the audio thread.
+// Contents are preserved.
+inline void prefault(void* data, size_t numBytes) noexcept
+{
+    if (data == nullptr || numBytes == 0)
+        return;
+
+    auto* bytes = static_cast<volatile unsigned char*>(data);
+    const size_t pageSize = getPageSize();
+    for (size_t i = 0; i < numBytes; i += pageSize)
+        bytes[i] = bytes[i];
+    bytes[numBytes - 1] = bytes[numBytes - 1];
+}
+
+//==============================================================================
+/**
+    A prefaulted and (when permitted) locked memory range.
+
+    Does not own the memory. Only whole pages inside the range are unlocked on release, so pages
+    shared with a neighbouring locked allocation stay resident. mlock does not nest on POSIX.
+*/
+class LockedRegion
+{
+public:
+    LockedRegion() = default;
+
+    ~LockedRegion()
+    {
+        release();
+    }
+
+    LockedRegion(LockedRegion&& other) noexcept
+        : data(other.data)
+        , numBytes(other.numBytes)
+        , locked(other.locked)
+    {
+        other.data = nullptr;
+        other.numBytes = 0;
+        other.locked = false;
+    }
+
+    LockedRegion& operator=(LockedRegion&& other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            data = other.data;
+            numBytes = other.numBytes;
+            locked = other.locked;
+            other.data = nullptr;
+            other.numBytes = 0;
+            other.locked = false;
+        }
+        return *this;
+    }
+
+    // Prefaults and locks the range if the mode is enabled. Returns true if the range is locked.
+    bool lock(void* newData, size_t newNumBytes) noexcept
+    {
+        release();
+
+        if (!isLockingEnabled() || newData == nullptr || newNumBytes == 0)
+            return false;
+
+        data = newData;
+        numBytes = newNumBytes;
+        prefault(data, numBytes);
+
+        if (lockingUnavailable.load(std::memory_order_relaxed))
+            return false;
+
+#ifdef _WIN32
+        locked = VirtualLock(data, numBytes) != 0;
+#else
+        locked = mlock(data, numBytes) == 0;
+#endif
+
+        if (locked)
+            lockedBytes.fetch_add(static_cast<int64_t>(numBytes), std::memory_order_relaxed);
+        else if (!lockingUnavailable.exchange(true, std::memory_order_relaxed))
+            reportLockFailure(numBytes);
+
+        return locked;
+    }
+
+    void release() noexcept
+    {
+        if (locked)
+        {
+            const size_t pageSize = getPageSize();
+            const auto begin = reinterpret_cast<uintptr_t>(data);
+            const auto firstPage = (begin + pageSize - 1) & ~(pageSize - 1);
+            const auto endPage = (begin + numBytes) & ~(pageSize - 1);
+
+            if (endPage > firstPage)
+            {
+#ifdef _WIN32
+                VirtualUnlock(reinterpret_cast<void*>(firstPage), endPage - firstPage);
+#else
+                munlock(reinterpret_cast<void*>(firstPage), endPage - firstPage);
+#endif
+            }
+
+            lockedBytes.fetch_sub(static_cast<int64_t>(numBytes), std::memory_order_relaxed);
+        }
+
+        data = nullptr;
+        numBytes = 0;
+        locked = false;
+    }
+
+    bool isLocked() const noexcept
+    {
+        return locked;
+    }
+
+private:
+    static void reportLockFailure(size_t requested) noexcept
+    {
+#ifdef _WIN32
+        std::cerr
+            << "[atk::rtmemory] VirtualLock failed for "
+            << requested
+            << " bytes (working set too small); falling back to prefault only"
+            << std::endl;
+#else
+        rlimit limit{};
+        getrlimit(RLIMIT_MEMLOCK, &limit);
+        std::cerr
+            << "[atk::rtmemory] mlock failed for "
+            << requested
+            << " bytes (RLIMIT_MEMLOCK "
+            << (limit.rlim_cur == RLIM_INFINITY ? -1 : static_cast<long long>(limit.rlim_cur))
+            << ", locked so far "
+            << getLockedBytes()
+            << "); falling back to prefault only"
+            << std::endl;
+#endif
+    }
+
+    void* data = nullptr;
+    size_t numBytes = 0;
+    bool locked = false;
+
+    LockedRegion(const LockedRegion&) = delete;
+    LockedRegion& operator=(const LockedRegion&) = delete;
+};
+
+//==============================================================================
+// Maps and locks the top of the calling thread's stack. Call at thread start.
+#if defined(_MSC_VER)
+__declspec(noinline)
+#else
+__attribute__((noinline))
+#endif
+inline void prefaultStack(LockedRegion& region) noexcept
+{
+    static constexpr size_t kStackPrefaultBytes = 128 * 1024;
+
+    if (!isLockingEnabled())
+        return;
+
+    volatile unsigned char stack[kStackPrefaultBytes];
+    for (size_t i = 0; i < kStackPrefaultBytes; i += getPageSize())
+        stack[i] = 0;
+
+    region.lock(const_cast<unsigned char*>(stack), kStackPrefaultBytes);
+}
+
+//==============================================================================
+struct PageFaultCounts
+{
+    uint64_t minor = 0;
+    uint64_t major = 0;
+};
+
+// Page faults taken by the calling thread so far. Returns false where per-thread counts are unavailable.
+inline bool getThreadPageFaults(PageFaultCounts& counts) noexcept
+{
+#if defined(__linux__) && defined(RUSAGE_THREAD)
+    rusage usage{};
+    if (getrusage(RUSAGE_THREAD, &usage) != 0)
+        return false;
+    counts.minor = static_cast<uint64_t>(usage.ru_minflt);
+    counts.major = static_cast<uint64_t>(usage.ru_majflt);
+    return true;
+#else
+    (void)counts;
+    return false;
+#endif
+}
+
+// Called from audio callbacks. Every kSampleInterval calls the thread's getrusage delta is added to
+// the audio thread totals; the first call only records a baseline.
+inline void samplePageFaults() noexcept
+{
+    static constexpr uint32_t kSampleInterval = 64;
+
+    thread_local uint32_t callCount = 0;
+    thread_local bool hasBaseline = false;
+    thread_local PageFaultCounts last;
+
+    if (hasBaseline && (++callCount % kSampleInterval) != 0)
+        return;
+
+    PageFaultCounts now;
+    if (!getThreadPageFaults(now))
+        return;
+
+    if (hasBaseline)
+    {
+        audioThreadMinorFaults.fetch_add(now.minor - last.minor, std::memory_order_relaxed);
+        audioThreadMajorFaults.fetch_add(now.major - last.major, std::memory_order_relaxed);
+    }
+
+    last = now;
+    hasBaseline = true;
+}
+
+inline PageFaultCounts getAudioThreadPageFaults() noexcept
+{
+    PageFaultCounts counts;
+    counts.minor = audioThreadMinorFaults.load(std::memory_order_relaxed);
+    counts.major = audioThreadMajorFaults.load(std::memory_order_relaxed);
+    return counts;
+}
+
+} // namespace atk::rtmemory
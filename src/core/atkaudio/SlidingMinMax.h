@@ -0,0 +1,161 @@
+// Copyright (c) 2025 atkAudio
+// Minimum and maximum of the last N values, O(1) amortized per push
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace atk
+{
+
+// Monotonic deques over a fixed-length sliding window. The min deque holds increasing values and
+// the max deque decreasing ones, each tagged with its push index; anything that can no longer be
+// the extreme of a window is dropped. Both deques are rings sized to the window, so push() never
+// allocates and is safe on the audio thread once setWindowSize() has been called.
+template <typename T>
+class SlidingMinMax
+{
+public:
+    explicit SlidingMinMax(int windowSize = 1)
+    {
+        setWindowSize(windowSize);
+    }
+
+    // Allocates; call off the audio thread. Clears the window.
+    void setWindowSize(int newWindowSize)
+    {
+        windowSize = std::max(1, newWindowSize);
+        minDeque.setCapacity(windowSize);
+        maxDeque.setCapacity(windowSize);
+        reset();
+    }
+
+    int getWindowSize() const noexcept
+    {
+        return windowSize;
+    }
+
+    void reset() noexcept
+    {
+        minDeque.clear();
+        maxDeque.clear();
+        numPushed = 0;
+    }
+
+    void push(T value) noexcept
+    {
+        const int64_t index = numPushed++;
+
+        // Expire first so neither ring ever holds more than windowSize entries
+        const int64_t oldest = index - windowSize + 1;
+        if (!minDeque.empty() && minDeque.front().index < oldest)
+            minDeque.popFront();
+        if (!maxDeque.empty() && maxDeque.front().index < oldest)
+            maxDeque.popFront();
+
+        while (!minDeque.empty() && !(minDeque.back().value < value))
+            minDeque.popBack();
+        minDeque.pushBack({index, value});
+
+        while (!maxDeque.empty() && !(value < maxDeque.back().value))
+            maxDeque.popBack();
+        maxDeque.pushBack({index, value});
+    }
+
+    // Number of values in the window, up to the window size
+    int getNumValues() const noexcept
+    {
+        return static_cast<int>(std::min<int64_t>(numPushed, windowSize));
+    }
+
+    bool isFull() const noexcept
+    {
+        return numPushed >= windowSize;
+    }
+
+    // Only meaningful once something has been pushed
+    T getMin() const noexcept
+    {
+        return minDeque.front().value;
+    }
+
+    T getMax() const noexcept
+    {
+        return maxDeque.front().value;
+    }
+
+private:
+    struct Entry
+    {
+        int64_t index;
+        T value;
+    };
+
+    class Ring
+    {
+    public:
+        void setCapacity(int capacity)
+        {
+            entries.assign(static_cast<size_t>(capacity), Entry{});
+            clear();
+        }
+
+        void clear() noexcept
+        {
+            head = 0;
+            size = 0;
+        }
+
+        bool empty() const noexcept
+        {
+            return size == 0;
+        }
+
+        const Entry& front() const noexcept
+        {
+            return entries[static_cast<size_t>(head)];
+        }
+
+        const Entry& back() const noexcept
+        {
+            return entries[static_cast<size_t>(wrap(head + size - 1))];
+        }
+
+        void pushBack(const Entry& entry) noexcept
+        {
+            entries[static_cast<size_t>(wrap(head + size))] = entry;
+            ++size;
+        }
+
+        void popBack() noexcept
+        {
+            --size;
+        }
+
+        void popFront() noexcept
+        {
+            head = wrap(head + 1);
+            --size;
+        }
+
+    private:
+        int wrap(int i) const noexcept
+        {
+            const int capacity = static_cast<int>(entries.size());
+            return i >= capacity ? i - capacity : i;
+        }
+
+        std::vector<Entry> entries;
+        int head{0};
+        int size{0};
+    };
+
+    int windowSize{1};
+    int64_t numPushed{0};
+    Ring minDeque;
+    Ring maxDeque;
+};
+
+} // namespace atk
@@ -0,0 +1,33 @@
+// Copyright (c) 2025 atkAudio
+// Snapshot of a SyncBuffer's health, for monitoring from non-audio threads
+
+#pragma once
+
+#include <cstdint>
+
+namespace atk
+{
+
+// Levels are in writer samples. Each field is read individually, so a snapshot taken while audio
+// runs may mix values from neighbouring callbacks.
+struct SyncBufferStats
+{
+    bool isPrepared = false;
+
+    int currentLevel = 0; // queued when the last read started
+    int minLevel = 0;     // over the level history window
+    int maxLevel = 0;
+    int targetLevel = 0; // what drift compensation steers minLevel towards; 0 until the window fills
+
+    double appliedRatio = 0.0; // writer samples consumed per reader sample by the last read
+    double driftPpm = 0.0;     // writer clock rate relative to the reader's, measured from callback timing
+
+    float writerJitterMs = 0.0f;
+    float readerJitterMs = 0.0f;
+
+    uint64_t underflows = 0; // reads that found fewer samples than they needed
+    uint64_t overflows = 0;  // writes that didn't fit and were truncated
+    uint64_t resets = 0;     // reset() and re-prepare, each of which drops queued audio
+};
+
+} // namespace atk
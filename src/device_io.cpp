@@ -1,3 +1,5 @@
+#include "core/atkaudio/Denormals.h"
+#include "core/atkaudio/RealtimeMemory.h"
 #include "core/atkaudio/DeviceIo/DeviceIo.h"
 #include <atomic>
 #include <obs-frontend-api.h>
@@ -201,6 +203,9 @@ static struct obs_audio_data* devio_filter(void* data, struct obs_audio_data* au
     auto frames = audio->frames;
     float** adata = (float**)audio->data;
 
+    atk::ScopedFlushDenormals noDenormals;
+    atk::rtmemory::samplePageFaults();
+
     auto outputGain = adio->outputGain.load(std::memory_order_acquire);
     for (int i = 0; i < channels; i++)
         for (size_t j = 0; j < frames; j++)
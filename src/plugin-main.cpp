@@ -20,6 +20,7 @@ with this program. If not, see <https://www.gnu.org/licenses/>
 #include "config.h"
 #include "core/atkaudio/GlobalSettings.h"
 #include "core/atkaudio/Logging.h"
+#include "core/atkaudio/RealtimeMemory.h"
 #include "core/atkaudio/atkaudio.h"
 
 #include <chrono>
@@ -34,8 +35,10 @@ with this program. If not, see <https://www.gnu.org/licenses/>
 
 #ifdef ENABLE_QT
 #include <QCheckBox>
+#include <QComboBox>
 #include <QDialog>
 #include <QDialogButtonBox>
+#include <QHBoxLayout>
 #include <QLabel>
 #include <QVBoxLayout>
 #include <QWidget>
@@ -79,6 +82,52 @@ void openGlobalSettingsDialog(void* private_data)
     enableLoggingCheckBox.setChecked(atk::settings::isLoggingEnabled());
     layout.addWidget(&enableLoggingCheckBox);
 
+    QCheckBox flushDenormalsCheckBox("Flush denormals to zero on audio threads");
+    flushDenormalsCheckBox.setToolTip(
+        "Prevents CPU spikes when plugin tails decay into denormal numbers. "
+        "Disable only for plugins that require IEEE denormal behaviour."
+    );
+    flushDenormalsCheckBox.setChecked(atk::settings::isFlushDenormalsEnabled());
+    layout.addWidget(&flushDenormalsCheckBox);
+
+    QCheckBox lockMemoryCheckBox("Lock realtime audio buffers in memory");
+    lockMemoryCheckBox.setToolTip(
+        "Prefaults and mlocks pooled audio buffers and worker stacks so they are never paged out. "
+        "Takes effect for buffers allocated after the change. Limited by RLIMIT_MEMLOCK on Linux."
+    );
+    lockMemoryCheckBox.setChecked(atk::settings::isLockRealtimeMemoryEnabled());
+    layout.addWidget(&lockMemoryCheckBox);
+
+    const auto pageFaults = atk::rtmemory::getAudioThreadPageFaults();
+    QLabel pageFaultLabel(QString("Audio thread page faults: %1 minor, %2 major (%3 KiB locked)%4")
+                              .arg(pageFaults.minor)
+                              .arg(pageFaults.major)
+                              .arg(atk::rtmemory::getLockedBytes() / 1024)
+                              .arg(atk::rtmemory::isLockingAvailable() ? "" : " - lock limit reached"));
+    layout.addWidget(&pageFaultLabel);
+
+    QHBoxLayout resamplerRow;
+    QLabel resamplerLabel("Device resampler quality:");
+    QComboBox resamplerComboBox;
+    resamplerComboBox.addItems({"Linear", "Lagrange", "Windowed sinc (16 taps)", "Windowed sinc (32 taps)"});
+    resamplerComboBox.setToolTip(
+        "Interpolation used when a hardware device runs at a different rate from OBS or drifts from it. "
+        "Sinc modes suppress aliasing and imaging at a higher CPU cost. Applies to devices opened afterwards."
+    );
+    resamplerComboBox.setCurrentIndex(atk::settings::getResamplerQuality());
+    resamplerRow.addWidget(&resamplerLabel);
+    resamplerRow.addWidget(&resamplerComboBox, 1);
+    layout.addLayout(&resamplerRow);
+
+    QCheckBox adaptiveLatencyCheckBox("Adapt device latency to measured jitter");
+    adaptiveLatencyCheckBox.setToolTip(
+        "Sizes each device's safety buffer from how steadily its callbacks arrive instead of a fixed 1.5 blocks. "
+        "Lowers latency on steady interfaces and adds headroom for Bluetooth or network devices. "
+        "Applies to devices opened afterwards."
+    );
+    adaptiveLatencyCheckBox.setChecked(atk::settings::isAdaptiveDeviceLatencyEnabled());
+    layout.addWidget(&adaptiveLatencyCheckBox);
+
     // QLabel note(
     //     "Enables scoped lifecycle/API constructor/destructor logs. "
     //     "Errors are also gated by this setting."
@@ -97,6 +146,25 @@ void openGlobalSettingsDialog(void* private_data)
         const bool loggingEnabled = enableLoggingCheckBox.isChecked();
         atk::settings::setLoggingEnabled(loggingEnabled);
         blog(LOG_INFO, "[atkAudio][SETTINGS] logging %s", loggingEnabled ? "enabled" : "disabled");
+
+        const bool flushDenormals = flushDenormalsCheckBox.isChecked();
+        atk::settings::setFlushDenormalsEnabled(flushDenormals);
+        blog(LOG_INFO, "[atkAudio][SETTINGS] denormal flushing %s", flushDenormals ? "enabled" : "disabled");
+
+        const bool lockMemory = lockMemoryCheckBox.isChecked();
+        atk::settings::setLockRealtimeMemoryEnabled(lockMemory);
+        blog(LOG_INFO, "[atkAudio][SETTINGS] realtime memory locking %s", lockMemory ? "enabled" : "disabled");
+
+        atk::settings::setResamplerQuality(resamplerComboBox.currentIndex());
+        blog(
+            LOG_INFO,
+            "[atkAudio][SETTINGS] device resampler quality: %s",
+            resamplerComboBox.currentText().toUtf8().constData()
+        );
+
+        const bool adaptiveLatency = adaptiveLatencyCheckBox.isChecked();
+        atk::settings::setAdaptiveDeviceLatencyEnabled(adaptiveLatency);
+        blog(LOG_INFO, "[atkAudio][SETTINGS] adaptive device latency %s", adaptiveLatency ? "enabled" : "disabled");
     }
 #else
     blog(LOG_WARNING, "[atkAudio][SETTINGS] Qt not available, settings dialog disabled");
@@ -1,4 +1,6 @@
 #include <algorithm>
+#include <atkaudio/Denormals.h>
+#include <atkaudio/RealtimeMemory.h>
 #include <atkaudio/FifoBuffer2.h>
 #include "core/atkaudio/Logging.h"
 #include "core/atkaudio/atkaudio.h"
@@ -355,6 +357,9 @@ static struct obs_audio_data* pluginhost_filter_audio(void* data, struct obs_aud
     if (num_samples == 0)
         return audio;
 
+    atk::ScopedFlushDenormals noDenormals;
+    atk::rtmemory::samplePageFaults();
+
     float** samples = (float**)audio->data;
 
     // num_channels should be the number of main bus channels
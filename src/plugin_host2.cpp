@@ -1,4 +1,6 @@
 #include <algorithm>
+#include "core/atkaudio/Denormals.h"
+#include "core/atkaudio/RealtimeMemory.h"
 #include "core/atkaudio/Logging.h"
 #include "core/atkaudio/atkaudio.h"
 #include "core/atkaudio/PluginHost2/PluginHost2.h"
@@ -137,6 +139,9 @@ static struct obs_audio_data* pluginhost2_filter_audio(void* data, struct obs_au
     if (num_samples == 0)
         return audio;
 
+    atk::ScopedFlushDenormals noDenormals;
+    atk::rtmemory::samplePageFaults();
+
     float** samples = (float**)audio->data;
 
     ph->pluginHost2->process(samples, (int)ph->num_channels, num_samples, (double)ph->sample_rate);